@@ -403,6 +403,13 @@ int main(int argc, char *argv[])
     std::string memory_space =
         database.get<std::string>("memory_space", "host");
 
+    // By default, MPI_InitFinalize splits the cores of the node between the
+    // MPI processes. The matrix-free loops on the host use these threads.
+    // PropertyTreeInput n_threads
+    unsigned int const n_threads = database.get("n_threads", 0);
+    if (n_threads > 0)
+      dealii::MultithreadInfo::set_thread_limit(n_threads);
+
 #ifdef ADAMANTINE_WITH_ADIAK
     if (memory_space == "device")
       adiak::value("MemorySpace", "Device");
@@ -410,7 +417,11 @@ int main(int argc, char *argv[])
       adiak::value("MemorySpace", "Host");
 #endif
 
-    std::tuple<int, int, int> template_parameters(dim, n_materials, p_order);
+    // The kernels are specialized when there is only one material. Otherwise,
+    // the number of materials is only known at run time.
+    int const n_materials_template = (n_materials == 1) ? 1 : -1;
+    std::tuple<int, int, int> template_parameters(dim, n_materials_template,
+                                                  p_order);
 
     if (ensemble_calc)
     {
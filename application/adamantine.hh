@@ -6,6 +6,7 @@
 #define ADAMANTINE_HH
 
 #include <Boundary.hh>
+#include <CellDataBuffer.hh>
 #include <DataAssimilator.hh>
 #include <ExperimentalData.hh>
 #include <Geometry.hh>
@@ -27,10 +28,14 @@
 #include <deal.II/arborx/bvh.h>
 #include <deal.II/base/index_set.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/symmetric_tensor.h>
 #include <deal.II/base/types.h>
 #include <deal.II/distributed/cell_data_transfer.templates.h>
+#include <deal.II/distributed/grid_refinement.h>
 #include <deal.II/distributed/solution_transfer.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/grid_refinement.h>
 #if DEAL_II_VERSION_GTE(9, 7, 0) && defined(DEAL_II_TRILINOS_WITH_TPETRA)
@@ -39,7 +44,6 @@
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #endif
 #include <deal.II/lac/vector_operation.h>
-#include <deal.II/numerics/error_estimator.h>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/archive/text_iarchive.hpp>
@@ -308,50 +312,40 @@ initialize_thermal_physics(
   }
 }
 
+/**
+ * Pack in @p data_to_transfer, for each active cell, the material state, the
+ * deposition direction, and the melting indicator. If @p solution is not null,
+ * the values of the solution on the cell are appended, followed by the values
+ * of @p enthalpy if it is not null. The data of the cells that are not locally
+ * owned and the values of the cells using FE_Nothing are set to infinity.
+ */
 template <int dim, int n_materials, int p_order, typename MaterialStates,
           typename MemorySpaceType>
-void refine_and_transfer(
+void pack_cell_data(
     std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
         &thermal_physics,
-    std::unique_ptr<adamantine::MechanicalPhysics<
-        dim, n_materials, p_order, MaterialStates, MemorySpaceType>>
-        &mechanical_physics,
     adamantine::MaterialProperty<dim, n_materials, p_order, MaterialStates,
                                  MemorySpaceType> &material_properties,
-    dealii::DoFHandler<dim> &dof_handler,
-    dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+    dealii::DoFHandler<dim> const &dof_handler,
+    adamantine::CellDataBuffer &data_to_transfer,
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+        *solution = nullptr,
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+        *enthalpy = nullptr)
 {
-#ifdef ADAMANTINE_WITH_CALIPER
-  CALI_CXX_MARK_FUNCTION;
-#endif
-
-  dealii::parallel::distributed::Triangulation<dim> &triangulation =
-      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
-          const_cast<dealii::Triangulation<dim> &>(
-              dof_handler.get_triangulation()));
-
-  // Update the material state from the ThermalOperator to MaterialProperty
-  // because, for now, we need to use state from MaterialProperty to perform the
-  // transfer to the refined mesh.
-  thermal_physics->set_state_to_material_properties();
-
-  // Transfer of the solution
-#if DEAL_II_VERSION_GTE(9, 7, 0)
-  dealii::SolutionTransfer<
-#else
-  dealii::parallel::distributed::SolutionTransfer<
-#endif
-      dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
-      solution_transfer(dof_handler);
-
-  // Transfer material state
   unsigned int const direction_data_size = 2;
   unsigned int const phase_history_data_size = 1;
   unsigned int constexpr n_material_states = MaterialStates::n_material_states;
-  std::vector<std::vector<double>> data_to_transfer;
-  std::vector<double> dummy_cell_data(n_material_states + direction_data_size +
-                                          phase_history_data_size,
-                                      std::numeric_limits<double>::infinity());
+  unsigned int const n_dofs_per_cell =
+      solution ? dof_handler.get_fe(0).n_dofs_per_cell() : 0;
+  unsigned int const n_vectors = solution ? (enthalpy ? 2 : 1) : 0;
+  unsigned int const dofs_offset =
+      n_material_states + direction_data_size + phase_history_data_size;
+  unsigned int const data_size = dofs_offset + n_vectors * n_dofs_per_cell;
+  data_to_transfer.reinit(
+      dof_handler.get_triangulation().n_active_cells(), data_size,
+      std::numeric_limits<double>::infinity());
+  dealii::Vector<double> cell_solution(n_dofs_per_cell);
   auto state_host = Kokkos::create_mirror_view_and_copy(
       Kokkos::HostSpace{}, material_properties.get_state());
   unsigned int cell_id = 0;
@@ -360,8 +354,7 @@ void refine_and_transfer(
   {
     if (cell->is_locally_owned())
     {
-      std::vector<double> cell_data(n_material_states + direction_data_size +
-                                    phase_history_data_size);
+      double *cell_data = data_to_transfer[cell->active_cell_index()];
       for (unsigned int i = 0; i < n_material_states; ++i)
         cell_data[i] = state_host(i, cell_id);
       if (cell->active_fe_index() == 0)
@@ -376,31 +369,166 @@ void refine_and_transfer(
         else
           cell_data[n_material_states + direction_data_size] = 0.0;
 
+        if (solution)
+        {
+          cell->get_dof_values(*solution, cell_solution);
+          std::copy(cell_solution.begin(), cell_solution.end(),
+                    cell_data + dofs_offset);
+        }
+        if (enthalpy)
+        {
+          cell->get_dof_values(*enthalpy, cell_solution);
+          std::copy(cell_solution.begin(), cell_solution.end(),
+                    cell_data + dofs_offset + n_dofs_per_cell);
+        }
+
         ++activated_cell_id;
       }
-      else
+      ++cell_id;
+    }
+  }
+}
+
+/**
+ * Copy the material state, the deposition direction, and the melting indicator
+ * packed by pack_cell_data back to MaterialProperty and to the thermal
+ * physics.
+ */
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void unpack_cell_data(
+    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+        &thermal_physics,
+    adamantine::MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                                 MemorySpaceType> &material_properties,
+    dealii::DoFHandler<dim> const &dof_handler,
+    adamantine::CellDataBuffer const &transferred_data)
+{
+  unsigned int const direction_data_size = 2;
+  unsigned int constexpr n_material_states = MaterialStates::n_material_states;
+  auto state = material_properties.get_state();
+  auto state_host = Kokkos::create_mirror_view(state);
+  unsigned int cell_id = 0;
+  std::vector<double> transferred_cos;
+  std::vector<double> transferred_sin;
+  std::vector<bool> has_melted;
+  for (auto const &cell : dof_handler.active_cell_iterators())
+  {
+    if (cell->is_locally_owned())
+    {
+      double const *cell_data = transferred_data[cell->active_cell_index()];
+      for (unsigned int i = 0; i < n_material_states; ++i)
       {
-        cell_data[n_material_states] = std::numeric_limits<double>::infinity();
-        cell_data[n_material_states + 1] =
-            std::numeric_limits<double>::infinity();
-        cell_data[n_material_states + direction_data_size] =
-            std::numeric_limits<double>::infinity();
+        state_host(i, cell_id) = cell_data[i];
+      }
+      if (cell->active_fe_index() == 0)
+      {
+        transferred_cos.push_back(cell_data[n_material_states]);
+        transferred_sin.push_back(cell_data[n_material_states + 1]);
+
+        // Convert from double back to bool
+        if (cell_data[n_material_states + direction_data_size] > 0.5)
+          has_melted.push_back(true);
+        else
+          has_melted.push_back(false);
       }
-      data_to_transfer.push_back(cell_data);
       ++cell_id;
     }
-    else
+  }
+
+  // Update the deposition cos and sin
+  thermal_physics->set_material_deposition_orientation(transferred_cos,
+                                                       transferred_sin);
+
+  // Update the melted indicator
+  thermal_physics->set_has_melted_vector(has_melted);
+
+  // Copy the data back to material_property
+  Kokkos::deep_copy(state, state_host);
+
+  // Update the material states in the ThermalOperator
+  thermal_physics->get_state_from_material_properties();
+
+#if ADAMANTINE_DEBUG
+  // Check that we are not losing material
+  cell_id = 0;
+  for (auto const &cell : dof_handler.active_cell_iterators())
+  {
+    if (cell->is_locally_owned())
     {
-      data_to_transfer.push_back(dummy_cell_data);
+      double material_ratio = 0.;
+      for (unsigned int i = 0; i < n_material_states; ++i)
+      {
+        material_ratio += state_host(i, cell_id);
+      }
+      ASSERT(std::abs(material_ratio - 1.) < 1e-14, "Material is lost.");
+      ++cell_id;
     }
   }
+#endif
+}
+
+/**
+ * Execute the refinement and the coarsening of the Triangulation, or only
+ * repartition it if @p repartition is true, and transfer the solution and the
+ * state of the physics onto the new mesh.
+ */
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void refine_and_transfer(
+    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+        &thermal_physics,
+    std::unique_ptr<adamantine::MechanicalPhysics<
+        dim, n_materials, p_order, MaterialStates, MemorySpaceType>>
+        &mechanical_physics,
+    adamantine::MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                                 MemorySpaceType> &material_properties,
+    dealii::DoFHandler<dim> &dof_handler,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+    bool const repartition = false)
+{
+#ifdef ADAMANTINE_WITH_CALIPER
+  CALI_CXX_MARK_FUNCTION;
+#endif
+
+  dealii::parallel::distributed::Triangulation<dim> &triangulation =
+      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
+          const_cast<dealii::Triangulation<dim> &>(
+              dof_handler.get_triangulation()));
+
+  // Update the material state from the ThermalOperator to MaterialProperty
+  // because, for now, we need to use state from MaterialProperty to perform the
+  // transfer to the refined mesh.
+  thermal_physics->set_state_to_material_properties();
+
+  // Transfer of the solution
+#if DEAL_II_VERSION_GTE(9, 7, 0)
+  dealii::SolutionTransfer<
+#else
+  dealii::parallel::distributed::SolutionTransfer<
+#endif
+      dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
+      solution_transfer(dof_handler);
+
+  // Transfer material state. The buffers are owned by the thermal physics so
+  // that their memory is reused by all the mesh updates.
+  adamantine::CellDataBuffer &data_to_transfer =
+      thermal_physics->get_data_to_transfer();
+  pack_cell_data(thermal_physics, material_properties, dof_handler,
+                 data_to_transfer);
 
   // Prepare the Triangulation and the diffent data transfer objects for
   // refinement
-  triangulation.prepare_coarsening_and_refinement();
-  // Prepare for refinement of the solution
+  if (!repartition)
+    triangulation.prepare_coarsening_and_refinement();
+  // Prepare for refinement of the solution. The enthalpy of the enthalpy
+  // formulation, which only runs on the host, is interpolated with the
+  // temperature instead of being recomputed from the interpolated temperature.
   dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
       solution_host;
+  dealii::LA::distributed::Vector<double, MemorySpaceType> &enthalpy =
+      thermal_physics->get_enthalpy();
+  bool const transfer_enthalpy = enthalpy.size() == solution.size();
   if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
   {
     // We need to apply the constraints before the mesh transfer
@@ -408,7 +536,17 @@ void refine_and_transfer(
     // We need to update the ghost values before we can do the interpolation on
     // the new mesh.
     solution.update_ghost_values();
-    solution_transfer.prepare_for_coarsening_and_refinement(solution);
+    std::vector<dealii::LA::distributed::Vector<
+        double, dealii::MemorySpace::Host> const *>
+        vectors_to_transfer = {&solution};
+    if (transfer_enthalpy)
+    {
+      thermal_physics->get_affine_constraints().distribute(enthalpy);
+      enthalpy.update_ghost_values();
+      vectors_to_transfer.push_back(&enthalpy);
+    }
+    solution_transfer.prepare_for_coarsening_and_refinement(
+        vectors_to_transfer);
   }
   else
   {
@@ -422,9 +560,7 @@ void refine_and_transfer(
     solution_transfer.prepare_for_coarsening_and_refinement(solution_host);
   }
 
-  dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>
-      cell_data_trans(triangulation);
+  adamantine::CellDataBufferTransfer<dim> cell_data_trans(triangulation);
   cell_data_trans.prepare_for_coarsening_and_refinement(data_to_transfer);
 
   if (mechanical_physics)
@@ -435,8 +571,12 @@ void refine_and_transfer(
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_MARK_BEGIN("refine triangulation");
 #endif
-  // Execute the refinement
-  triangulation.execute_coarsening_and_refinement();
+  // Execute the refinement or the repartitioning. Both use the cell weights
+  // of the thermal physics.
+  if (repartition)
+    triangulation.repartition();
+  else
+    triangulation.execute_coarsening_and_refinement();
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_MARK_END("refine triangulation");
 #endif
@@ -451,7 +591,15 @@ void refine_and_transfer(
   // Interpolate the solution
   if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
   {
-    solution_transfer.interpolate(solution);
+    std::vector<
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> *>
+        transferred_vectors = {&solution};
+    if (transfer_enthalpy)
+    {
+      thermal_physics->initialize_dof_vector(0., enthalpy);
+      transferred_vectors.push_back(&enthalpy);
+    }
+    solution_transfer.interpolate(transferred_vectors);
   }
   else
   {
@@ -461,80 +609,146 @@ void refine_and_transfer(
   }
 
   // Unpack the material state and repopulate the material state
-  std::vector<std::vector<double>> transferred_data(
-      triangulation.n_active_cells(),
-      std::vector<double>(n_material_states + direction_data_size +
-                          phase_history_data_size));
+  adamantine::CellDataBuffer &transferred_data =
+      thermal_physics->get_transferred_data();
   cell_data_trans.unpack(transferred_data);
-  auto state = material_properties.get_state();
-  state_host = Kokkos::create_mirror_view(state);
-  unsigned int total_cell_id = 0;
-  cell_id = 0;
-  std::vector<double> transferred_cos;
-  std::vector<double> transferred_sin;
-  std::vector<bool> has_melted;
-  for (auto const &cell : dof_handler.active_cell_iterators())
-  {
-    if (cell->is_locally_owned())
-    {
-      for (unsigned int i = 0; i < n_material_states; ++i)
-      {
-        state_host(i, cell_id) = transferred_data[total_cell_id][i];
-      }
-      if (cell->active_fe_index() == 0)
-      {
-        transferred_cos.push_back(
-            transferred_data[total_cell_id][n_material_states]);
-        transferred_sin.push_back(
-            transferred_data[total_cell_id][n_material_states + 1]);
+  unpack_cell_data(thermal_physics, material_properties, dof_handler,
+                   transferred_data);
 
-        // Convert from double back to bool
-        if (transferred_data[total_cell_id]
-                            [n_material_states + direction_data_size] > 0.5)
-          has_melted.push_back(true);
-        else
-          has_melted.push_back(false);
-      }
-      ++cell_id;
-    }
-    ++total_cell_id;
+  if (mechanical_physics)
+  {
+    mechanical_physics->complete_transfer_mpi();
   }
+}
 
-  // Update the deposition cos and sin
-  thermal_physics->set_material_deposition_orientation(transferred_cos,
-                                                       transferred_sin);
+/**
+ * Return the time in seconds measured by @p timer.
+ */
+inline double get_elapsed_seconds(adamantine::Timer &timer)
+{
+  return boost::chrono::duration<double>(timer.get_elapsed_time()).count();
+}
 
-  // Update the melted indicator
-  thermal_physics->set_has_melted_vector(has_melted);
+/**
+ * Return the ratio between the largest and the average of the times
+ * @p local_time spent by the processors.
+ */
+inline double compute_load_imbalance(MPI_Comm const &communicator,
+                                     double const local_time)
+{
+  dealii::Utilities::MPI::MinMaxAvg const time_stats =
+      dealii::Utilities::MPI::min_max_avg(local_time, communicator);
 
-  // Copy the data back to material_property
-  Kokkos::deep_copy(state, state_host);
+  return time_stats.avg > 0. ? time_stats.max / time_stats.avg : 1.;
+}
 
-  // Update the material states in the ThermalOperator
-  thermal_physics->get_state_from_material_properties();
+/**
+ * Return the ratio between the largest and the average time spent by the
+ * processors in the section measured by @p timer since @p reference_time.
+ */
+inline double compute_load_imbalance(MPI_Comm const &communicator,
+                                     adamantine::Timer &timer,
+                                     double const reference_time)
+{
+  return compute_load_imbalance(communicator,
+                                get_elapsed_seconds(timer) - reference_time);
+}
 
-#if ADAMANTINE_DEBUG
-  // Check that we are not losing material
-  cell_id = 0;
-  for (auto const &cell : dof_handler.active_cell_iterators())
+/**
+ * Return the time step to use with an adaptive time stepping scheme. The time
+ * step @p adaptive_time_step suggested by the scheme is shortened to land on
+ * the next end of a scan path segment or on the next deposition time.
+ */
+template <int dim>
+double clamp_time_step_to_next_event(
+    double const time, double const adaptive_time_step,
+    std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
+        &heat_sources,
+    std::vector<double> const &deposition_times)
+{
+  double const event_tol = adaptive_time_step * 1e-6;
+  double next_event_time = std::numeric_limits<double>::max();
+  for (auto &source : heat_sources)
   {
-    if (cell->is_locally_owned())
-    {
-      double material_ratio = 0.;
-      for (unsigned int i = 0; i < n_material_states; ++i)
-      {
-        material_ratio += state_host(i, cell_id);
-      }
-      ASSERT(std::abs(material_ratio - 1.) < 1e-14, "Material is lost.");
-      ++cell_id;
-    }
+    next_event_time =
+        std::min(next_event_time,
+                 source->get_scan_path().get_next_segment_end_time(time +
+                                                                   event_tol));
   }
+  auto next_deposition = std::upper_bound(
+      deposition_times.begin(), deposition_times.end(), time + event_tol);
+  if (next_deposition != deposition_times.end())
+    next_event_time = std::min(next_event_time, *next_deposition);
+
+  return std::min(adaptive_time_step, next_event_time - time);
+}
+
+/**
+ * Return the time step suggested for the next step of an adaptive time
+ * stepping scheme. @p time_step is the time step that was attempted and
+ * @p next_time_step is the time step suggested by the scheme after the step.
+ */
+inline double update_adaptive_time_step(double const adaptive_time_step,
+                                        double const time_step,
+                                        double const next_time_step)
+{
+  // If the time step was shortened to land on an event and it was accepted as
+  // is, we keep the larger suggested time step. Otherwise, we use the time
+  // step suggested by the time stepping scheme.
+  return next_time_step >= time_step
+             ? std::max(adaptive_time_step, next_time_step)
+             : next_time_step;
+}
+
+/**
+ * Repartition the mesh using the cell weights of the thermal physics and
+ * transfer the solution and the state of the physics onto the new partition.
+ */
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void repartition_mesh(
+    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+        &thermal_physics,
+    std::unique_ptr<adamantine::MechanicalPhysics<
+        dim, n_materials, p_order, MaterialStates, MemorySpaceType>>
+        &mechanical_physics,
+    adamantine::MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                                 MemorySpaceType> &material_properties,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+{
+#ifdef ADAMANTINE_WITH_CALIPER
+  CALI_CXX_MARK_FUNCTION;
 #endif
+  refine_and_transfer(thermal_physics, mechanical_physics, material_properties,
+                      thermal_physics->get_dof_handler(), solution,
+                      /* repartition */ true);
 
-  if (mechanical_physics)
+  // Recompute the inverse of the mass matrix
+  thermal_physics->compute_inverse_mass_matrix();
+}
+
+/**
+ * Return bounding boxes that cover the volume swept by the heat sources between
+ * @p time and @p next_refinement_time.
+ */
+template <int dim>
+std::vector<dealii::BoundingBox<dim>> compute_heat_source_bounding_boxes(
+    double const time, double const next_refinement_time,
+    std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
+        &heat_sources)
+{
+  double const bounding_box_scaling = 2.0;
+  std::vector<dealii::BoundingBox<dim>> heat_source_bounding_boxes;
+  for (auto &beam : heat_sources)
   {
-    mechanical_physics->complete_transfer_mpi();
+    std::vector<dealii::BoundingBox<dim>> const swept_boxes =
+        beam->get_swept_bounding_boxes(time, next_refinement_time,
+                                       bounding_box_scaling);
+    heat_source_bounding_boxes.insert(heat_source_bounding_boxes.end(),
+                                      swept_boxes.begin(), swept_boxes.end());
   }
+
+  return heat_source_bounding_boxes;
 }
 
 template <int dim>
@@ -543,12 +757,11 @@ std::vector<typename dealii::parallel::distributed::Triangulation<
 compute_cells_to_refine(
     dealii::parallel::distributed::Triangulation<dim> &triangulation,
     double const time, double const next_refinement_time,
-    unsigned int const n_time_steps,
     std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
         &heat_sources)
 {
-  // Compute the position of the beams between time and next_refinement_time and
-  // create a list of cells that will intersect the beam.
+  // Compute the volume swept by the beams between time and
+  // next_refinement_time and create a list of cells that will intersect it.
 
   // Build the bounding boxes associated with the locally owned cells
   std::vector<dealii::BoundingBox<dim>> cell_bounding_boxes;
@@ -560,22 +773,9 @@ compute_cells_to_refine(
   }
   dealii::ArborXWrappers::BVH bvh(cell_bounding_boxes);
 
-  double const bounding_box_scaling = 2.0;
-  std::vector<dealii::BoundingBox<dim>> heat_source_bounding_boxes;
-  heat_source_bounding_boxes.reserve(n_time_steps * heat_sources.size());
-  for (unsigned int i = 0; i < n_time_steps; ++i)
-  {
-    double const current_time = time + static_cast<double>(i) /
-                                           static_cast<double>(n_time_steps) *
-                                           (next_refinement_time - time);
-
-    // Build the bounding boxes associated with the heat sources
-    for (auto &beam : heat_sources)
-    {
-      heat_source_bounding_boxes.push_back(
-          beam->get_bounding_box(current_time, bounding_box_scaling));
-    }
-  }
+  std::vector<dealii::BoundingBox<dim>> heat_source_bounding_boxes =
+      compute_heat_source_bounding_boxes(time, next_refinement_time,
+                                         heat_sources);
 
   // Perform the search with ArborX. Since we are only interested in locally
   // owned cells, we use BVH.
@@ -583,10 +783,12 @@ compute_cells_to_refine(
       heat_source_bounding_boxes);
   auto [indices, offset] = bvh.query(bb_intersect);
 
-  // Put the indices into a set to get rid of the duplicates and to make it
-  // easier to check if the indices are found.
-  std::unordered_set<int> indices_to_refine;
-  indices_to_refine.insert(indices.begin(), indices.end());
+  // Flag the cells found by the search. A cell may be found several times.
+  std::vector<bool> on_beam_path(cell_bounding_boxes.size(), false);
+  for (auto const index : indices)
+  {
+    on_beam_path[index] = true;
+  }
 
   std::vector<typename dealii::parallel::distributed::Triangulation<
       dim>::active_cell_iterator>
@@ -595,7 +797,7 @@ compute_cells_to_refine(
   for (auto const &cell : triangulation.active_cell_iterators() |
                               dealii::IteratorFilters::LocallyOwnedCell())
   {
-    if (indices_to_refine.count(cell_index))
+    if (on_beam_path[cell_index])
     {
       cells_to_refine.push_back(cell);
     }
@@ -605,6 +807,522 @@ compute_cells_to_refine(
   return cells_to_refine;
 }
 
+/**
+ * Compute the Kelly error indicator of @p solution on the locally owned cells
+ * using FE_Q. Unlike dealii::KellyErrorEstimator, only the faces shared by two
+ * cells using FE_Q contribute to the indicator. The boundary of the domain and
+ * the interface with the cells without material are free surfaces: the jump of
+ * the gradient across the FE_Q/FE_Nothing interface is the full gradient of the
+ * temperature and it is not a discretization error.
+ */
+template <int dim, int fe_degree>
+dealii::Vector<float> compute_error_indicator(
+    dealii::DoFHandler<dim> const &dof_handler,
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+        &solution)
+{
+  dealii::FiniteElement<dim> const &fe = dof_handler.get_fe(0);
+  dealii::QGauss<dim - 1> const face_quadrature(fe_degree + 1);
+  dealii::UpdateFlags const update_flags = dealii::update_gradients |
+                                           dealii::update_normal_vectors |
+                                           dealii::update_JxW_values;
+  dealii::FEFaceValues<dim> fe_face_values(fe, face_quadrature, update_flags);
+  dealii::FESubfaceValues<dim> fe_subface_values(fe, face_quadrature,
+                                                 update_flags);
+  dealii::FEFaceValues<dim> neighbor_fe_face_values(fe, face_quadrature,
+                                                    dealii::update_gradients);
+  dealii::FESubfaceValues<dim> neighbor_fe_subface_values(
+      fe, face_quadrature, dealii::update_gradients);
+  unsigned int const n_q_points = face_quadrature.size();
+  std::vector<dealii::Tensor<1, dim>> gradients(n_q_points);
+  std::vector<dealii::Tensor<1, dim>> neighbor_gradients(n_q_points);
+
+  // Integrate the square of the jump of the normal derivative on a face. The
+  // quadrature points of the two sides of the face match.
+  auto const integrate_jump =
+      [&](dealii::FEValuesBase<dim> const &fe_values,
+          dealii::FEValuesBase<dim> const &neighbor_fe_values)
+  {
+    fe_values.get_function_gradients(solution, gradients);
+    neighbor_fe_values.get_function_gradients(solution, neighbor_gradients);
+    double jump_squared = 0.;
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      double const jump =
+          (gradients[q] - neighbor_gradients[q]) * fe_values.normal_vector(q);
+      jump_squared += jump * jump * fe_values.JxW(q);
+    }
+
+    return jump_squared;
+  };
+
+  dealii::Vector<float> error_indicator(
+      dof_handler.get_triangulation().n_active_cells());
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    double jump_squared = 0.;
+    for (auto const face : cell->face_indices())
+    {
+      if (cell->at_boundary(face))
+        continue;
+
+      auto const neighbor = cell->neighbor(face);
+      if (neighbor->has_children())
+      {
+        // The neighbor is finer: integrate on each subface
+        unsigned int const neighbor_face = cell->neighbor_of_neighbor(face);
+        for (unsigned int subface = 0;
+             subface < cell->face(face)->n_children(); ++subface)
+        {
+          auto const neighbor_child =
+              cell->neighbor_child_on_subface(face, subface);
+          if (neighbor_child->active_fe_index() != 0)
+            continue;
+          fe_subface_values.reinit(cell, face, subface);
+          neighbor_fe_face_values.reinit(neighbor_child, neighbor_face);
+          jump_squared +=
+              integrate_jump(fe_subface_values, neighbor_fe_face_values);
+        }
+      }
+      else if (neighbor->active_fe_index() == 0)
+      {
+        fe_face_values.reinit(cell, face);
+        if (cell->neighbor_is_coarser(face))
+        {
+          auto const [neighbor_face, neighbor_subface] =
+              cell->neighbor_of_coarser_neighbor(face);
+          neighbor_fe_subface_values.reinit(neighbor, neighbor_face,
+                                            neighbor_subface);
+          jump_squared +=
+              integrate_jump(fe_face_values, neighbor_fe_subface_values);
+        }
+        else
+        {
+          neighbor_fe_face_values.reinit(neighbor,
+                                         cell->neighbor_of_neighbor(face));
+          jump_squared +=
+              integrate_jump(fe_face_values, neighbor_fe_face_values);
+        }
+      }
+    }
+    // Same scaling as the default strategy of dealii::KellyErrorEstimator
+    error_indicator[cell->active_cell_index()] =
+        std::sqrt(cell->diameter() / 24. * jump_squared);
+  }
+
+  return error_indicator;
+}
+
+/**
+ * Flag cells for refinement and coarsening using the Kelly error indicator of
+ * the temperature. @p refine_fraction and @p coarsen_fraction are the fractions
+ * of the ranked cells with the largest and the smallest error indicators. The
+ * cells without material are never ranked. The cells in @p cells_to_refine
+ * are refined anyway, so they are not ranked either and the cells created by
+ * their refinement are taken out of the budget @p max_n_cells. The flags of
+ * the cells that are not ranked are left untouched. The cells are not refined
+ * beyond @p n_refinements.
+ */
+template <int dim, int fe_degree, typename MemorySpaceType>
+void flag_cells_from_error_estimator(
+    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+        &thermal_physics,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> const &solution,
+    std::vector<typename dealii::parallel::distributed::Triangulation<
+        dim>::active_cell_iterator> const &cells_to_refine,
+    unsigned int const n_refinements, double const refine_fraction,
+    double const coarsen_fraction,
+    dealii::types::global_cell_index const max_n_cells)
+{
+#ifdef ADAMANTINE_WITH_CALIPER
+  CALI_CXX_MARK_FUNCTION;
+#endif
+  dealii::DoFHandler<dim> &dof_handler = thermal_physics->get_dof_handler();
+  dealii::parallel::distributed::Triangulation<dim> &triangulation =
+      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
+          const_cast<dealii::Triangulation<dim> &>(
+              dof_handler.get_triangulation()));
+  MPI_Comm const communicator = triangulation.get_communicator();
+
+  // The indicator needs the values of the solution on the ghost cells. They
+  // are not all ghosted by the MatrixFree partitioner, so we copy the solution
+  // to a vector with the locally relevant DoFs.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      solution_host(solution.get_partitioner());
+  solution_host.import_elements(solution, dealii::VectorOperation::insert);
+  thermal_physics->get_affine_constraints().distribute(solution_host);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      relevant_solution(dof_handler.locally_owned_dofs(),
+                        dealii::DoFTools::extract_locally_relevant_dofs(
+                            dof_handler),
+                        communicator);
+  relevant_solution.copy_locally_owned_data_from(solution_host);
+  relevant_solution.update_ghost_values();
+
+  dealii::Vector<float> estimated_error =
+      compute_error_indicator<dim, fe_degree>(dof_handler, relevant_solution);
+
+  // The cells without material and the cells on the path of the heat sources
+  // are not ranked. Their indicator is set to zero, which puts them at the
+  // bottom of the ranking, and the fractions are rescaled so that the number
+  // of ranked cells flagged is the same as if they were absent. Their flags
+  // are restored after the ranking.
+  unsigned int const n_active_cells = triangulation.n_active_cells();
+  std::vector<bool> ranked(n_active_cells, false);
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    ranked[cell->active_cell_index()] = true;
+  }
+  unsigned int n_beam_cells = 0;
+  for (auto const &cell : cells_to_refine)
+  {
+    ranked[cell->active_cell_index()] = false;
+    if (cell->level() < static_cast<int>(n_refinements))
+      ++n_beam_cells;
+  }
+  std::vector<bool> refine_flags(n_active_cells, false);
+  std::vector<bool> coarsen_flags(n_active_cells, false);
+  dealii::types::global_cell_index n_ranked_cells = 0;
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    unsigned int const index = cell->active_cell_index();
+    if (ranked[index])
+    {
+      ++n_ranked_cells;
+    }
+    else
+    {
+      estimated_error[index] = 0.f;
+      refine_flags[index] = cell->refine_flag_set();
+      coarsen_flags[index] = cell->coarsen_flag_set();
+    }
+  }
+  n_ranked_cells = dealii::Utilities::MPI::sum(n_ranked_cells, communicator);
+  if (n_ranked_cells == 0)
+    return;
+  double const ranked_ratio = static_cast<double>(n_ranked_cells) /
+                              triangulation.n_global_active_cells();
+
+  dealii::types::global_cell_index const n_new_beam_cells =
+      (dealii::GeometryInfo<dim>::max_children_per_cell - 1) *
+      dealii::Utilities::MPI::sum(
+          static_cast<dealii::types::global_cell_index>(n_beam_cells),
+          communicator);
+  dealii::types::global_cell_index const budget =
+      max_n_cells > n_new_beam_cells ? max_n_cells - n_new_beam_cells : 0;
+
+  // The unranked cells fill the bottom of the ranking, so the coarsening
+  // fraction only reaches them when some ranked cells are coarsened.
+  double const global_refine_fraction = refine_fraction * ranked_ratio;
+  double const global_coarsen_fraction =
+      coarsen_fraction > 0.
+          ? std::min(1. - ranked_ratio + coarsen_fraction * ranked_ratio,
+                     1. - global_refine_fraction)
+          : 0.;
+  dealii::parallel::distributed::GridRefinement::
+      refine_and_coarsen_fixed_number(triangulation, estimated_error,
+                                      global_refine_fraction,
+                                      global_coarsen_fraction, budget);
+
+  for (auto cell : dealii::filter_iterators(
+           triangulation.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell()))
+  {
+    unsigned int const index = cell->active_cell_index();
+    if (!ranked[index])
+    {
+      cell->clear_refine_flag();
+      cell->clear_coarsen_flag();
+      if (refine_flags[index])
+        cell->set_refine_flag();
+      if (coarsen_flags[index])
+        cell->set_coarsen_flag();
+    }
+    else if (cell->refine_flag_set())
+    {
+      cell->clear_coarsen_flag();
+      if (cell->level() >= static_cast<int>(n_refinements))
+        cell->clear_refine_flag();
+    }
+  }
+}
+
+/**
+ * Refine the cells on the path of the heat sources up to @p n_refinements
+ * levels. The Triangulation is still updated once per level, since a cell can
+ * only be refined once per update, but the DoFs, the constraints, and the
+ * MatrixFree object are only built on the final mesh. On the intermediate
+ * meshes, the solution and the material state are carried cell by cell with
+ * the cell data using the prolongation and the restriction matrices of the
+ * finite element.
+ */
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void refine_and_transfer_deferred_dofs(
+    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+        &thermal_physics,
+    adamantine::MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                                 MemorySpaceType> &material_properties,
+    dealii::DoFHandler<dim> &dof_handler,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+    std::vector<dealii::BoundingBox<dim>> const &heat_source_bounding_boxes,
+    unsigned int const n_refinements, bool const coarsen_after_beam)
+{
+#ifdef ADAMANTINE_WITH_CALIPER
+  CALI_CXX_MARK_FUNCTION;
+#endif
+
+  dealii::parallel::distributed::Triangulation<dim> &triangulation =
+      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
+          const_cast<dealii::Triangulation<dim> &>(
+              dof_handler.get_triangulation()));
+
+  // Update the material state from the ThermalOperator to MaterialProperty
+  // because, for now, we need to use state from MaterialProperty to perform the
+  // transfer to the refined mesh.
+  thermal_physics->set_state_to_material_properties();
+
+  // We need to apply the constraints and to update the ghost values before we
+  // can read the values of the solution on the cells. The enthalpy of the
+  // enthalpy formulation is carried by the cells with the temperature.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      solution_host(solution.get_partitioner());
+  solution_host.import_elements(solution, dealii::VectorOperation::insert);
+  thermal_physics->get_affine_constraints().distribute(solution_host);
+  solution_host.update_ghost_values();
+  dealii::LA::distributed::Vector<double, MemorySpaceType> &enthalpy =
+      thermal_physics->get_enthalpy();
+  bool const transfer_enthalpy = enthalpy.size() == solution.size();
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      enthalpy_host;
+  if (transfer_enthalpy)
+  {
+    enthalpy_host.reinit(enthalpy.get_partitioner());
+    enthalpy_host.import_elements(enthalpy, dealii::VectorOperation::insert);
+    thermal_physics->get_affine_constraints().distribute(enthalpy_host);
+    enthalpy_host.update_ghost_values();
+  }
+
+  unsigned int constexpr n_material_states = MaterialStates::n_material_states;
+  unsigned int const melted_index = n_material_states + 2;
+  unsigned int const dofs_offset = n_material_states + 3;
+  dealii::FiniteElement<dim> const &fe = dof_handler.get_fe(0);
+  unsigned int const n_dofs_per_cell = fe.n_dofs_per_cell();
+  // The buffers are owned by the thermal physics so that their memory is
+  // reused by all the mesh updates.
+  adamantine::CellDataBuffer &cell_data =
+      thermal_physics->get_data_to_transfer();
+  adamantine::CellDataBuffer &transferred_data =
+      thermal_physics->get_transferred_data();
+  pack_cell_data(thermal_physics, material_properties, dof_handler, cell_data,
+                 &solution_host, transfer_enthalpy ? &enthalpy_host : nullptr);
+
+  // The children inherit the data of their parent and the values of each
+  // vector are interpolated on them. The values of the cells using FE_Nothing
+  // are infinite. The local vectors are shared by all the calls to the
+  // strategies.
+  unsigned int const stride = cell_data.stride();
+  dealii::Vector<double> parent_values(n_dofs_per_cell);
+  dealii::Vector<double> child_values(n_dofs_per_cell);
+  auto const refinement_strategy =
+      [&](typename dealii::Triangulation<dim>::cell_iterator const &parent,
+          dealii::ArrayView<double const> parent_data,
+          dealii::ArrayView<double> children_data)
+  {
+    adamantine::CellDataBufferTransfer<dim>::preserve(parent, parent_data,
+                                                      children_data);
+    if (std::isfinite(parent_data[dofs_offset]))
+    {
+      for (unsigned int offset = dofs_offset; offset < stride;
+           offset += n_dofs_per_cell)
+      {
+        std::copy(parent_data.begin() + offset,
+                  parent_data.begin() + offset + n_dofs_per_cell,
+                  parent_values.begin());
+        for (unsigned int c = 0; c < parent->n_children(); ++c)
+        {
+          fe.get_prolongation_matrix(c).vmult(child_values, parent_values);
+          std::copy(child_values.begin(), child_values.end(),
+                    children_data.begin() + c * stride + offset);
+        }
+      }
+    }
+  };
+
+  // The material state of the parent is the average of the state of its
+  // children and the parent has melted if one of its children has. The values
+  // of each vector are restricted the same way SolutionTransfer does it. Only
+  // the families whose children use the same finite element are coarsened.
+  dealii::Vector<double> restricted_values(n_dofs_per_cell);
+  auto const coarsening_strategy =
+      [&](typename dealii::Triangulation<dim>::cell_iterator const &parent,
+          dealii::ArrayView<double const> children_data,
+          dealii::ArrayView<double> parent_data)
+  {
+    std::copy(children_data.begin(), children_data.begin() + stride,
+              parent_data.begin());
+    unsigned int const n_children = parent->n_children();
+    for (unsigned int i = 0; i < n_material_states; ++i)
+    {
+      parent_data[i] = 0.;
+      for (unsigned int c = 0; c < n_children; ++c)
+        parent_data[i] += children_data[c * stride + i];
+      parent_data[i] /= n_children;
+    }
+
+    if (std::isfinite(parent_data[dofs_offset]))
+    {
+      for (unsigned int c = 0; c < n_children; ++c)
+        parent_data[melted_index] =
+            std::max(parent_data[melted_index],
+                     children_data[c * stride + melted_index]);
+
+      std::fill(parent_data.begin() + dofs_offset, parent_data.end(), 0.);
+      for (unsigned int offset = dofs_offset; offset < stride;
+           offset += n_dofs_per_cell)
+      {
+        for (unsigned int c = 0; c < n_children; ++c)
+        {
+          auto const child_begin = children_data.begin() + c * stride + offset;
+          std::copy(child_begin, child_begin + n_dofs_per_cell,
+                    child_values.begin());
+          fe.get_restriction_matrix(c).vmult(restricted_values, child_values);
+          for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
+          {
+            if (fe.restriction_is_additive(i))
+              parent_data[offset + i] += restricted_values[i];
+            else if (restricted_values[i] != 0.)
+              parent_data[offset + i] = restricted_values[i];
+          }
+        }
+      }
+    }
+  };
+
+  auto const family_can_be_coarsened = [](auto const &cell)
+  {
+    auto const parent = cell->parent();
+    for (unsigned int c = 0; c < parent->n_children(); ++c)
+    {
+      auto const child = parent->child(c);
+      if (!child->is_active() || !child->is_locally_owned() ||
+          (child->active_fe_index() != cell->active_fe_index()))
+        return false;
+    }
+    return true;
+  };
+
+  for (unsigned int i = 0; i < n_refinements; ++i)
+  {
+    // Flag the cells. Only the cells of the current mesh are tested against the
+    // bounding boxes of the heat sources which are computed once.
+    bool flagged_cells = false;
+    for (auto const &cell : dof_handler.active_cell_iterators() |
+                                dealii::IteratorFilters::LocallyOwnedCell())
+    {
+      dealii::BoundingBox<dim> const cell_bounding_box = cell->bounding_box();
+      bool const on_beam_path = std::any_of(
+          heat_source_bounding_boxes.begin(), heat_source_bounding_boxes.end(),
+          [&](dealii::BoundingBox<dim> const &box)
+          {
+            return cell_bounding_box.get_neighbor_type(box) !=
+                   dealii::NeighborType::not_neighbors;
+          });
+      if (on_beam_path)
+      {
+        if (cell->level() < static_cast<int>(n_refinements))
+        {
+          cell->set_refine_flag();
+          flagged_cells = true;
+        }
+      }
+      else if (coarsen_after_beam && (cell->level() > 0) &&
+               family_can_be_coarsened(cell))
+      {
+        cell->set_coarsen_flag();
+        flagged_cells = true;
+      }
+    }
+
+    // Stop as soon as the mesh has reached its final level on every processor.
+    if (!dealii::Utilities::MPI::logical_or(flagged_cells,
+                                            triangulation.get_communicator()))
+    {
+      break;
+    }
+
+    adamantine::CellDataBufferTransfer<dim> cell_data_trans(
+        triangulation, refinement_strategy, coarsening_strategy);
+    triangulation.prepare_coarsening_and_refinement();
+    cell_data_trans.prepare_for_coarsening_and_refinement(cell_data);
+#ifdef ADAMANTINE_WITH_CALIPER
+    CALI_MARK_BEGIN("refine triangulation");
+#endif
+    triangulation.execute_coarsening_and_refinement();
+#ifdef ADAMANTINE_WITH_CALIPER
+    CALI_MARK_END("refine triangulation");
+#endif
+    // The two buffers are swapped so that their memory is reused by the next
+    // pass.
+    cell_data_trans.unpack(transferred_data);
+    std::swap(cell_data, transferred_data);
+  }
+
+  // Update the AffineConstraints and resize the solution
+  thermal_physics->setup_dofs();
+  thermal_physics->initialize_dof_vector(0., solution);
+
+  // Update MaterialProperty DoFHandler and resize the state vectors
+  material_properties.reinit_dofs();
+
+  // Copy the values carried by the cells to the locally owned DoFs. The values
+  // of a DoF shared by several cells are the same since the solution is
+  // continuous. The constraints take care of the hanging nodes.
+  solution_host.reinit(solution.get_partitioner());
+  if (transfer_enthalpy)
+  {
+    thermal_physics->initialize_dof_vector(0., enthalpy);
+    enthalpy_host.reinit(enthalpy.get_partitioner());
+  }
+  std::vector<dealii::types::global_dof_index> dof_indices(n_dofs_per_cell);
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    double const *data = cell_data[cell->active_cell_index()];
+    cell->get_dof_indices(dof_indices);
+    for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
+    {
+      if (solution_host.in_local_range(dof_indices[i]))
+      {
+        solution_host[dof_indices[i]] = data[dofs_offset + i];
+        if (transfer_enthalpy)
+          enthalpy_host[dof_indices[i]] =
+              data[dofs_offset + n_dofs_per_cell + i];
+      }
+    }
+  }
+  thermal_physics->get_affine_constraints().distribute(solution_host);
+  solution.import_elements(solution_host, dealii::VectorOperation::insert);
+  if (transfer_enthalpy)
+  {
+    thermal_physics->get_affine_constraints().distribute(enthalpy_host);
+    enthalpy.import_elements(enthalpy_host, dealii::VectorOperation::insert);
+  }
+
+  // Repopulate the material state
+  unpack_cell_data(thermal_physics, material_properties, dof_handler,
+                   cell_data);
+}
+
 template <int dim, int n_materials, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType>
 void refine_mesh(
@@ -619,7 +1337,6 @@ void refine_mesh(
     std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
         &heat_sources,
     double const time, double const next_refinement_time,
-    unsigned int const time_steps_refinement,
     boost::property_tree::ptree const &refinement_database)
 {
 #ifdef ADAMANTINE_WITH_CALIPER
@@ -634,17 +1351,45 @@ void refine_mesh(
   // PropertyTreeInput refinement.n_refinements
   unsigned int const n_refinements =
       refinement_database.get("n_refinements", 2);
+  // PropertyTreeInput refinement.coarsen_after_beam
+  const bool coarsen_after_beam =
+      refinement_database.get<bool>("coarsen_after_beam", false);
+  // PropertyTreeInput refinement.deferred_dofs
+  bool const deferred_dofs = refinement_database.get("deferred_dofs", false);
+  // PropertyTreeInput refinement.error_estimator_refine_fraction
+  double const refine_fraction =
+      refinement_database.get("error_estimator_refine_fraction", 0.);
+  // PropertyTreeInput refinement.error_estimator_coarsen_fraction
+  double const coarsen_fraction =
+      refinement_database.get("error_estimator_coarsen_fraction", 0.);
+  // PropertyTreeInput refinement.max_n_cells
+  dealii::types::global_cell_index const max_n_cells =
+      refinement_database.get("max_n_cells",
+                              std::numeric_limits<
+                                  dealii::types::global_cell_index>::max());
+  bool const use_error_estimator =
+      (refine_fraction > 0.) || (coarsen_fraction > 0.);
+
+  // The mechanical physics is transferred by the Triangulation at each
+  // refinement and the error estimator needs the solution on each
+  // intermediate mesh, so they both set up the DoFs after each refinement.
+  if (deferred_dofs && !mechanical_physics && !use_error_estimator)
+  {
+    auto const heat_source_bounding_boxes = compute_heat_source_bounding_boxes(
+        time, next_refinement_time, heat_sources);
+    refine_and_transfer_deferred_dofs(thermal_physics, material_properties,
+                                      dof_handler, solution,
+                                      heat_source_bounding_boxes,
+                                      n_refinements, coarsen_after_beam);
+    thermal_physics->compute_inverse_mass_matrix();
+    return;
+  }
 
   for (unsigned int i = 0; i < n_refinements; ++i)
   {
     // Compute the cells to be refined.
-    auto cells_to_refine =
-        compute_cells_to_refine(triangulation, time, next_refinement_time,
-                                time_steps_refinement, heat_sources);
-
-    // PropertyTreeInput refinement.coarsen_after_beam
-    const bool coarsen_after_beam =
-        refinement_database.get<bool>("coarsen_after_beam", false);
+    auto cells_to_refine = compute_cells_to_refine(
+        triangulation, time, next_refinement_time, heat_sources);
 
     // If coarsening is allowed, set the coarsening flag everywhere
     if (coarsen_after_beam)
@@ -658,10 +1403,19 @@ void refine_mesh(
       }
     }
 
+    // Refine and coarsen the rest of the domain where the temperature needs
+    // it.
+    if (use_error_estimator)
+    {
+      flag_cells_from_error_estimator<dim, fe_degree>(
+          thermal_physics, solution, cells_to_refine, n_refinements,
+          refine_fraction, coarsen_fraction, max_n_cells);
+    }
+
     // Flag the cells for refinement.
     for (auto &cell : cells_to_refine)
     {
-      if (coarsen_after_beam)
+      if (coarsen_after_beam || use_error_estimator)
         cell->clear_coarsen_flag();
 
       if (cell->level() < static_cast<int>(n_refinements))
@@ -691,7 +1445,6 @@ void refine_mesh(
     std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
         &heat_sources,
     double const time, double const next_refinement_time,
-    unsigned int const time_steps_refinement,
     boost::property_tree::ptree const &refinement_database)
 {
   if (!thermal_physics)
@@ -703,40 +1456,35 @@ void refine_mesh(
   {
     refine_mesh<dim, n_materials, p_order, 1, MaterialStates>(
         thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
+        heat_sources, time, next_refinement_time, refinement_database);
     break;
   }
   case 2:
   {
     refine_mesh<dim, n_materials, p_order, 2, MaterialStates>(
         thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
+        heat_sources, time, next_refinement_time, refinement_database);
     break;
   }
   case 3:
   {
     refine_mesh<dim, n_materials, p_order, 3, MaterialStates>(
         thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
+        heat_sources, time, next_refinement_time, refinement_database);
     break;
   }
   case 4:
   {
     refine_mesh<dim, n_materials, p_order, 4, MaterialStates>(
         thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
+        heat_sources, time, next_refinement_time, refinement_database);
     break;
   }
   case 5:
   {
     refine_mesh<dim, n_materials, p_order, 5, MaterialStates>(
         thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
+        heat_sources, time, next_refinement_time, refinement_database);
     break;
   }
   default:
@@ -1008,6 +1756,15 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
   // PropertyTreeInput refinement.time_steps_between_refinement
   unsigned int const time_steps_refinement =
       refinement_database.get("time_steps_between_refinement", 10);
+  // PropertyTreeInput refinement.load_imbalance_threshold
+  double const load_imbalance_threshold =
+      refinement_database.get("load_imbalance_threshold", 0.);
+  // PropertyTreeInput refinement.time_steps_between_load_balancing
+  unsigned int const time_steps_load_balancing =
+      refinement_database.get("time_steps_between_load_balancing", 1);
+  bool const load_balancing = load_imbalance_threshold > 0.;
+  // Time spent evaluating the thermal physics when the mesh was last updated
+  double load_balancing_reference_time = 0.;
   // PropertyTreeInput post_processor.time_steps_between_output
   unsigned int const time_steps_output =
       post_processor_database.get("time_steps_between_output", 1);
@@ -1034,6 +1791,14 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
 
   bool rebuild_mechanical_matrix = true;
 
+  // When the time step is adaptive, adaptive_time_step is the time step
+  // suggested by the time stepping scheme while time_step is the time step
+  // actually used. The latter is shortened to land on the end of the scan path
+  // segments and on the deposition times.
+  bool const adaptive_time_stepping =
+      use_thermal_physics && thermal_physics->has_adaptive_time_stepping();
+  double adaptive_time_step = time_step;
+
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_CXX_MARK_LOOP_BEGIN(main_loop_id, "main_loop");
 #endif
@@ -1042,6 +1807,12 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
 #ifdef ADAMANTINE_WITH_CALIPER
     CALI_CXX_MARK_LOOP_ITERATION(main_loop_id, n_time_step - 1);
 #endif
+    if (adaptive_time_stepping)
+    {
+      time_step = clamp_time_step_to_next_event(
+          time, adaptive_time_step, heat_sources, deposition_times);
+    }
+
     if ((time + time_step) > duration)
       time_step = duration - time;
 
@@ -1054,9 +1825,11 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
       double next_refinement_time = time + time_steps_refinement * time_step;
       refine_mesh(thermal_physics, mechanical_physics, material_properties,
                   temperature, heat_sources, time, next_refinement_time,
-                  time_steps_refinement, refinement_database);
+                  refinement_database);
       timers[adamantine::refine].stop();
       rebuild_mechanical_matrix = true;
+      load_balancing_reference_time =
+          get_elapsed_seconds(timers[adamantine::evol_time_eval_th_ph]);
       if ((rank == 0) && (verbose_output == true))
       {
         std::cout << "n_time_step: " << n_time_step << " time: " << time
@@ -1064,6 +1837,32 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
                   << thermal_physics->get_dof_handler().n_dofs() << std::endl;
       }
     }
+    // Refining the mesh also repartitions it. In between, the mesh is
+    // repartitioned when the time spent evaluating the thermal physics since
+    // the last update of the mesh is too unbalanced between the processors.
+    else if (load_balancing && use_thermal_physics &&
+             ((n_time_step % time_steps_load_balancing) == 0))
+    {
+      double const load_imbalance = compute_load_imbalance(
+          communicator, timers[adamantine::evol_time_eval_th_ph],
+          load_balancing_reference_time);
+      if (load_imbalance > load_imbalance_threshold)
+      {
+        timers[adamantine::refine].start();
+        repartition_mesh(thermal_physics, mechanical_physics,
+                         material_properties, temperature);
+        timers[adamantine::refine].stop();
+        rebuild_mechanical_matrix = true;
+        load_balancing_reference_time =
+            get_elapsed_seconds(timers[adamantine::evol_time_eval_th_ph]);
+        if ((rank == 0) && (verbose_output == true))
+        {
+          std::cout << "n_time_step: " << n_time_step << " time: " << time
+                    << " load imbalance: " << load_imbalance
+                    << " the mesh has been repartitioned" << std::endl;
+        }
+      }
+    }
 
     // Add material if necessary.
     // We use an epsilon to get the "expected" behavior when the deposition
@@ -1238,8 +2037,17 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
 #endif
       }
 
+      double const old_time = time;
       time = thermal_physics->evolve_one_time_step(time, time_step, temperature,
                                                    timers);
+      if (adaptive_time_stepping)
+      {
+        adaptive_time_step = update_adaptive_time_step(
+            adaptive_time_step, time_step,
+            thermal_physics->get_next_time_step());
+        // The time step may have been decreased to satisfy the tolerance.
+        time_step = time - old_time;
+      }
 
       if (compute_microstructure)
       {
@@ -1944,7 +2752,7 @@ run_ensemble(MPI_Comm const &global_communicator,
                     *material_properties_ensemble[member],
                     solution_augmented_ensemble[member].block(base_state),
                     bounding_heat_sources, time, next_refinement_time,
-                    time_steps_refinement, refinement_database);
+                    refinement_database);
         solution_augmented_ensemble[member].collect_sizes();
       }
 
@@ -0,0 +1,395 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+// Benchmark of MaterialProperty::compute_material_property, i.e., the
+// evaluation of the state dependent properties done at every quadrature point
+// by ThermalOperator. The benchmark sweeps the format of the properties, the
+// order of the polynomials, the number of materials, and the material states.
+// The results are written in JSON.
+
+#include <MaterialProperty.hh>
+#include <MaterialStates.hh>
+#include <types.hh>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/**
+ * Result of the benchmark of one configuration.
+ */
+struct BenchmarkResult
+{
+  std::string material_states;
+  bool use_table;
+  int p_order;
+  int n_materials;
+  bool mixed_batches;
+  double ns_per_q_point;
+  double bandwidth;
+  double checksum;
+};
+
+/**
+ * Parameters shared by all the configurations.
+ */
+struct BenchmarkParameters
+{
+  unsigned int n_q_points;
+  unsigned int n_repetitions;
+};
+
+/**
+ * Maximum temperature of the benchmark.
+ */
+double constexpr temperature_max = 3000.;
+
+template <typename MaterialStates>
+std::string get_material_states_name()
+{
+  if constexpr (std::is_same_v<MaterialStates, adamantine::Solid>)
+    return "Solid";
+  else if constexpr (std::is_same_v<MaterialStates, adamantine::SolidLiquid>)
+    return "SolidLiquid";
+  else
+    return "SolidLiquidPowder";
+}
+
+/**
+ * Create the database of @p n_materials materials. The state dependent
+ * properties used by ThermalOperator are given for every state, either as
+ * tables using all the entries available or as polynomials of order
+ * @p p_order.
+ */
+template <typename MaterialStates>
+boost::property_tree::ptree create_database(bool use_table, int p_order,
+                                            unsigned int n_materials)
+{
+  std::array<std::string, 5> const properties = {
+      {"density", "specific_heat", "thermal_conductivity_x",
+       "thermal_conductivity_y", "thermal_conductivity_z"}};
+  unsigned int constexpr table_size =
+      adamantine::MaterialProperty<3, 1, 0, MaterialStates,
+                                   dealii::MemorySpace::Host>::table_size;
+
+  boost::property_tree::ptree database;
+  database.put("property_format", use_table ? "table" : "polynomial");
+  database.put("n_materials", n_materials);
+  for (unsigned int m = 0; m < n_materials; ++m)
+  {
+    std::string const material = "material_" + std::to_string(m);
+    database.put(material + ".solidus", 1500. + 10. * m);
+    database.put(material + ".liquidus", 1550. + 10. * m);
+    database.put(material + ".latent_heat", 2.7e5);
+    for (unsigned int state = 0; state < MaterialStates::n_material_states;
+         ++state)
+    {
+      for (unsigned int p = 0; p < properties.size(); ++p)
+      {
+        double const value = 1. + m + state + p;
+        std::string property;
+        if (use_table)
+        {
+          for (unsigned int i = 0; i < table_size; ++i)
+          {
+            double const temperature = temperature_max * i / (table_size - 1);
+            property += (i == 0 ? "" : "|") + std::to_string(temperature) +
+                        "," + std::to_string(value * (1. + 1e-3 * i));
+          }
+        }
+        else
+        {
+          // The coefficients are scaled so that every term has the same order
+          // of magnitude at the maximum temperature.
+          for (int i = 0; i <= p_order; ++i)
+            property += (i == 0 ? "" : ",") +
+                        std::to_string(value / std::pow(temperature_max, i));
+        }
+        database.put(material + "." +
+                         adamantine::material_state_names[state] + "." +
+                         properties[p],
+                     property);
+      }
+    }
+  }
+
+  return database;
+}
+
+/**
+ * Evaluate the properties needed by ThermalOperator at every quadrature point
+ * and return the time per quadrature point and the bandwidth achieved when
+ * streaming the data of the quadrature points.
+ */
+template <int n_materials, int p_order, typename MaterialStates,
+          bool use_table>
+BenchmarkResult
+run_benchmark(MPI_Comm const &communicator,
+              dealii::parallel::distributed::Triangulation<3> const &tria,
+              BenchmarkParameters const &parameters, bool mixed_batches)
+{
+  using VectorizedArrayType = dealii::VectorizedArray<double>;
+  unsigned int constexpr width = VectorizedArrayType::size();
+  unsigned int constexpr n_states = MaterialStates::n_material_states;
+  unsigned int constexpr n_properties = 5;
+  unsigned int const n_materials_runtime = n_materials == 1 ? 1 : 2;
+
+  adamantine::MaterialProperty<3, n_materials, p_order, MaterialStates,
+                               dealii::MemorySpace::Host>
+      material_properties(communicator, tria,
+                          create_database<MaterialStates>(
+                              use_table, p_order, n_materials_runtime));
+
+  // Fill the data of the quadrature points. When the batches are not mixed,
+  // all the lanes of a batch use the same material like in a part made of
+  // large regions of a single material.
+  unsigned int const n_batches = (parameters.n_q_points + width - 1) / width;
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> temperature_distribution(
+      0., temperature_max);
+  std::uniform_real_distribution<double> ratio_distribution(0., 1.);
+  std::vector<std::array<dealii::types::material_id, width>> material_ids(
+      n_batches);
+  dealii::AlignedVector<VectorizedArrayType> temperatures(n_batches);
+  dealii::AlignedVector<std::array<VectorizedArrayType, n_states>>
+      state_ratios(n_batches);
+  dealii::AlignedVector<VectorizedArrayType> values(n_properties * n_batches);
+  for (unsigned int b = 0; b < n_batches; ++b)
+  {
+    for (unsigned int n = 0; n < width; ++n)
+    {
+      material_ids[b][n] = (mixed_batches ? n : b / 64) % n_materials_runtime;
+      temperatures[b][n] = temperature_distribution(generator);
+      double sum = 0.;
+      for (unsigned int s = 0; s < n_states; ++s)
+      {
+        state_ratios[b][s][n] = ratio_distribution(generator);
+        sum += state_ratios[b][s][n];
+      }
+      for (unsigned int s = 0; s < n_states; ++s)
+        state_ratios[b][s][n] /= sum;
+    }
+  }
+
+  dealii::AlignedVector<VectorizedArrayType> temperature_powers(p_order + 1);
+  auto const evaluate_batch = [&](unsigned int const b)
+  {
+    temperature_powers[0] = 1.;
+    for (int i = 1; i <= p_order; ++i)
+      temperature_powers[i] = temperature_powers[i - 1] * temperatures[b];
+
+    auto *value = &values[n_properties * b];
+    value[0] = material_properties.template compute_material_property<
+        use_table, adamantine::StateProperty::density>(
+        material_ids[b], state_ratios[b], temperatures[b], temperature_powers);
+    value[1] = material_properties.template compute_material_property<
+        use_table, adamantine::StateProperty::specific_heat>(
+        material_ids[b], state_ratios[b], temperatures[b], temperature_powers);
+    value[2] = material_properties.template compute_material_property<
+        use_table, adamantine::StateProperty::thermal_conductivity_x>(
+        material_ids[b], state_ratios[b], temperatures[b], temperature_powers);
+    value[3] = material_properties.template compute_material_property<
+        use_table, adamantine::StateProperty::thermal_conductivity_y>(
+        material_ids[b], state_ratios[b], temperatures[b], temperature_powers);
+    value[4] = material_properties.template compute_material_property<
+        use_table, adamantine::StateProperty::thermal_conductivity_z>(
+        material_ids[b], state_ratios[b], temperatures[b], temperature_powers);
+  };
+
+  // The warmup pass is not timed. It brings the data of the quadrature points,
+  // the tables, and the coefficients in cache.
+  for (unsigned int b = 0; b < n_batches; ++b)
+    evaluate_batch(b);
+
+  // The values of every repetition are added to the checksum, which is written
+  // with the results, so that the evaluations cannot be optimized away.
+  VectorizedArrayType checksum = 0.;
+  auto const start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < parameters.n_repetitions; ++r)
+  {
+    for (unsigned int b = 0; b < n_batches; ++b)
+    {
+      evaluate_batch(b);
+      for (unsigned int p = 0; p < n_properties; ++p)
+        checksum += values[n_properties * b + p];
+    }
+  }
+  auto const end = std::chrono::steady_clock::now();
+
+  // The tables and the coefficients stay in cache, so only the data of the
+  // quadrature points is counted.
+  double const elapsed_ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  double const n_evaluations =
+      static_cast<double>(parameters.n_repetitions) * n_batches * width;
+  double constexpr bytes_per_q_point =
+      sizeof(dealii::types::material_id) +
+      sizeof(double) * (1 + n_states + n_properties);
+
+  BenchmarkResult result;
+  result.material_states = get_material_states_name<MaterialStates>();
+  result.use_table = use_table;
+  result.p_order = p_order;
+  result.n_materials = n_materials;
+  result.mixed_batches = mixed_batches;
+  result.ns_per_q_point = elapsed_ns / n_evaluations;
+  // Bytes per nanosecond are GB/s.
+  result.bandwidth = bytes_per_q_point * n_evaluations / elapsed_ns;
+  result.checksum = 0.;
+  for (unsigned int n = 0; n < width; ++n)
+    result.checksum += checksum[n];
+
+  return result;
+}
+
+template <int n_materials, typename MaterialStates, int... p_orders>
+void run_polynomial_benchmarks(
+    std::integer_sequence<int, p_orders...>, MPI_Comm const &communicator,
+    dealii::parallel::distributed::Triangulation<3> const &tria,
+    BenchmarkParameters const &parameters, bool mixed_batches,
+    std::vector<BenchmarkResult> &results)
+{
+  (results.push_back(
+       run_benchmark<n_materials, p_orders, MaterialStates, false>(
+           communicator, tria, parameters, mixed_batches)),
+   ...);
+}
+
+template <int n_materials, typename MaterialStates>
+void run_benchmarks(MPI_Comm const &communicator,
+                    dealii::parallel::distributed::Triangulation<3> const &tria,
+                    BenchmarkParameters const &parameters, bool mixed_batches,
+                    std::vector<BenchmarkResult> &results)
+{
+  // The order of the polynomials does not matter for the tables.
+  results.push_back(run_benchmark<n_materials, 0, MaterialStates, true>(
+      communicator, tria, parameters, mixed_batches));
+  run_polynomial_benchmarks<n_materials, MaterialStates>(
+      std::make_integer_sequence<int, 5>(), communicator, tria, parameters,
+      mixed_batches, results);
+}
+
+template <typename MaterialStates>
+void run_benchmarks(MPI_Comm const &communicator,
+                    dealii::parallel::distributed::Triangulation<3> const &tria,
+                    BenchmarkParameters const &parameters,
+                    std::vector<BenchmarkResult> &results)
+{
+  run_benchmarks<1, MaterialStates>(communicator, tria, parameters, false,
+                                    results);
+  run_benchmarks<-1, MaterialStates>(communicator, tria, parameters, false,
+                                     results);
+  run_benchmarks<-1, MaterialStates>(communicator, tria, parameters, true,
+                                     results);
+}
+
+void write_json(std::ostream &out, BenchmarkParameters const &parameters,
+                std::vector<BenchmarkResult> const &results)
+{
+  out << "{\n";
+  out << "  \"benchmark\": \"material_property\",\n";
+  out << "  \"vectorization_width\": "
+      << dealii::VectorizedArray<double>::size() << ",\n";
+  out << "  \"n_quadrature_points\": " << parameters.n_q_points << ",\n";
+  out << "  \"n_repetitions\": " << parameters.n_repetitions << ",\n";
+  out << "  \"results\": [\n";
+  for (unsigned int i = 0; i < results.size(); ++i)
+  {
+    auto const &result = results[i];
+    out << "    {\"material_states\": \"" << result.material_states << "\", ";
+    out << "\"property_format\": \""
+        << (result.use_table ? "table" : "polynomial") << "\", ";
+    out << "\"p_order\": " << result.p_order << ", ";
+    out << "\"n_materials\": " << result.n_materials << ", ";
+    out << "\"mixed_batches\": " << (result.mixed_batches ? "true" : "false")
+        << ", ";
+    out << "\"ns_per_quadrature_point\": " << result.ns_per_q_point << ", ";
+    out << "\"bandwidth_GB_per_s\": " << result.bandwidth << ", ";
+    out << "\"checksum\": " << result.checksum << "}";
+    out << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  out << "  ]\n";
+  out << "}\n";
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(
+      argc, argv, dealii::numbers::invalid_unsigned_int);
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  namespace boost_po = boost::program_options;
+
+  boost_po::options_description description("Options:");
+  description.add_options()("help,h", "Produce help message.")(
+      "n-quadrature-points,n",
+      boost_po::value<unsigned int>()->default_value(1 << 18),
+      "Number of quadrature points evaluated per repetition.")(
+      "n-repetitions,r", boost_po::value<unsigned int>()->default_value(20),
+      "Number of repetitions.")(
+      "output-file,o", boost_po::value<std::string>(),
+      "Name of the JSON output file; defaults to the standard output.");
+
+  boost_po::variables_map map;
+  auto parsed_line = boost_po::command_line_parser(argc, argv)
+                         .options(description)
+                         .allow_unregistered()
+                         .run();
+  boost_po::store(parsed_line, map);
+  boost_po::notify(map);
+  if (map.count("help") == 1)
+  {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  BenchmarkParameters parameters;
+  parameters.n_q_points = map["n-quadrature-points"].as<unsigned int>();
+  parameters.n_repetitions = map["n-repetitions"].as<unsigned int>();
+
+  // MaterialProperty needs a mesh but the benchmark does not use it.
+  dealii::parallel::distributed::Triangulation<3> tria(communicator);
+  dealii::GridGenerator::hyper_cube(tria);
+
+  std::vector<BenchmarkResult> results;
+  run_benchmarks<adamantine::Solid>(communicator, tria, parameters, results);
+  run_benchmarks<adamantine::SolidLiquid>(communicator, tria, parameters,
+                                          results);
+  run_benchmarks<adamantine::SolidLiquidPowder>(communicator, tria, parameters,
+                                                results);
+
+  if (dealii::Utilities::MPI::this_mpi_process(communicator) == 0)
+  {
+    if (map.count("output-file") == 1)
+    {
+      std::ofstream file(map["output-file"].as<std::string>());
+      write_json(file, parameters, results);
+    }
+    else
+    {
+      write_json(std::cout, parameters, results);
+    }
+  }
+
+  return 0;
+}
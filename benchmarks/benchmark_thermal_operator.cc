@@ -0,0 +1,244 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+// Strong scaling benchmark of ThermalOperator::vmult on the host. The size of
+// the mesh is fixed, so the pure MPI and the hybrid MPI and threads runs on a
+// node are compared by changing only the launch, e.g., on a 64 cores node:
+//   mpirun -np 64 benchmark_thermal_operator --n-threads 1
+//   mpirun -np 8 benchmark_thermal_operator --n-threads 8
+//   mpirun -np 1 benchmark_thermal_operator --n-threads 64
+// The results are written in JSON.
+
+#include <Boundary.hh>
+#include <Geometry.hh>
+#include <MaterialProperty.hh>
+#include <MaterialStates.hh>
+#include <ThermalOperator.hh>
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/hp/fe_collection.h>
+#include <deal.II/hp/q_collection.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <boost/optional.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+/**
+ * Result of the benchmark.
+ */
+struct BenchmarkResult
+{
+  unsigned int n_ranks;
+  unsigned int n_threads;
+  dealii::types::global_dof_index n_dofs;
+  unsigned int n_repetitions;
+  double seconds_per_vmult;
+  double checksum;
+};
+
+/**
+ * Time @p n_repetitions applications of the operator on a cube of
+ * @p n_divisions cells in each direction. The time of the slowest rank is
+ * returned.
+ */
+BenchmarkResult run_benchmark(MPI_Comm const &communicator,
+                              unsigned int const n_divisions,
+                              unsigned int const n_repetitions)
+{
+  int constexpr dim = 3;
+  int constexpr fe_degree = 2;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 1.);
+  geometry_database.put("length_divisions", n_divisions);
+  geometry_database.put("width", 1.);
+  geometry_database.put("width_divisions", n_divisions);
+  geometry_database.put("height", 1.);
+  geometry_database.put("height_divisions", n_divisions);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<dim> geometry(communicator, geometry_database,
+                                     units_optional_database);
+
+  // Create the Boundary
+  boost::property_tree::ptree boundary_database;
+  boundary_database.put("type", "adiabatic");
+  adamantine::Boundary boundary(
+      boundary_database, geometry.get_triangulation().get_boundary_ids());
+
+  // Create the DoFHandler
+  dealii::hp::FECollection<dim> fe_collection;
+  fe_collection.push_back(dealii::FE_Q<dim>(fe_degree));
+  fe_collection.push_back(dealii::FE_Nothing<dim>());
+  dealii::DoFHandler<dim> dof_handler(geometry.get_triangulation());
+  dof_handler.distribute_dofs(fe_collection);
+  dealii::AffineConstraints<double> affine_constraints;
+  affine_constraints.close();
+  dealii::hp::QCollection<1> q_collection;
+  q_collection.push_back(dealii::QGauss<1>(fe_degree + 1));
+  q_collection.push_back(dealii::QGauss<1>(1));
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree mat_prop_database;
+  mat_prop_database.put("property_format", "polynomial");
+  mat_prop_database.put("n_materials", 1);
+  mat_prop_database.put("material_0.solidus", 1500.);
+  mat_prop_database.put("material_0.liquidus", 1550.);
+  mat_prop_database.put("material_0.latent_heat", 2.7e5);
+  for (std::string const state : {"solid", "liquid", "powder"})
+  {
+    std::string const prefix = "material_0." + state + ".";
+    mat_prop_database.put(prefix + "density", 7.9e3);
+    mat_prop_database.put(prefix + "specific_heat", 500.);
+    mat_prop_database.put(prefix + "thermal_conductivity_x", 20.);
+    mat_prop_database.put(prefix + "thermal_conductivity_y", 20.);
+    mat_prop_database.put(prefix + "thermal_conductivity_z", 20.);
+  }
+  adamantine::MaterialProperty<dim, 1, 0, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      material_properties(communicator, geometry.get_triangulation(),
+                          mat_prop_database);
+
+  // Initialize the ThermalOperator. The heat sources do not change the cost of
+  // the operator evaluation, so there is none.
+  std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> heat_sources;
+  adamantine::ThermalOperator<dim, 1, false, 0, fe_degree,
+                              adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      thermal_operator(communicator, boundary, material_properties,
+                       heat_sources);
+  unsigned int const n_local_cells =
+      geometry.get_triangulation().n_locally_owned_active_cells();
+  std::vector<double> deposition_cos(n_local_cells, 1.);
+  std::vector<double> deposition_sin(n_local_cells, 0.);
+  thermal_operator.reinit(dof_handler, affine_constraints, q_collection);
+  thermal_operator.set_material_deposition_orientation(deposition_cos,
+                                                       deposition_sin);
+  thermal_operator.compute_inverse_mass_matrix(dof_handler, affine_constraints);
+  thermal_operator.get_state_from_material_properties();
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst;
+  thermal_operator.get_matrix_free().initialize_dof_vector(src);
+  thermal_operator.get_matrix_free().initialize_dof_vector(dst);
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = 300. + 1e-3 * i;
+
+  // The first application is not timed because it fills the caches and
+  // spawns the threads.
+  thermal_operator.vmult(dst, src);
+
+  MPI_Barrier(communicator);
+  auto const start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < n_repetitions; ++r)
+    thermal_operator.vmult(dst, src);
+  auto const end = std::chrono::steady_clock::now();
+
+  BenchmarkResult result;
+  result.n_ranks = dealii::Utilities::MPI::n_mpi_processes(communicator);
+  result.n_threads = dealii::MultithreadInfo::n_threads();
+  result.n_dofs = dof_handler.n_dofs();
+  result.n_repetitions = n_repetitions;
+  result.seconds_per_vmult =
+      dealii::Utilities::MPI::max(
+          std::chrono::duration<double>(end - start).count(), communicator) /
+      n_repetitions;
+  // The norm of the result is written so that the operator evaluation cannot
+  // be optimized away and so that the runs can be compared.
+  result.checksum = dst.l2_norm();
+
+  return result;
+}
+
+void write_json(std::ostream &out, BenchmarkResult const &result)
+{
+  out << "{\n";
+  out << "  \"benchmark\": \"thermal_operator\",\n";
+  out << "  \"n_mpi_processes\": " << result.n_ranks << ",\n";
+  out << "  \"n_threads\": " << result.n_threads << ",\n";
+  out << "  \"n_dofs\": " << result.n_dofs << ",\n";
+  out << "  \"n_repetitions\": " << result.n_repetitions << ",\n";
+  out << "  \"seconds_per_vmult\": " << result.seconds_per_vmult << ",\n";
+  out << "  \"dofs_per_second\": "
+      << result.n_dofs / result.seconds_per_vmult << ",\n";
+  out << "  \"checksum\": " << result.checksum << "\n";
+  out << "}\n";
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(
+      argc, argv, dealii::numbers::invalid_unsigned_int);
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  namespace boost_po = boost::program_options;
+
+  boost_po::options_description description("Options:");
+  description.add_options()("help,h", "Produce help message.")(
+      "n-divisions,n", boost_po::value<unsigned int>()->default_value(64),
+      "Number of cells in each direction.")(
+      "n-repetitions,r", boost_po::value<unsigned int>()->default_value(50),
+      "Number of timed applications of the operator.")(
+      "n-threads,t", boost_po::value<unsigned int>()->default_value(0),
+      "Number of threads per MPI process; 0 splits the cores of the node "
+      "between the MPI processes.")(
+      "output-file,o", boost_po::value<std::string>(),
+      "Name of the JSON output file; defaults to the standard output.");
+
+  boost_po::variables_map map;
+  auto parsed_line = boost_po::command_line_parser(argc, argv)
+                         .options(description)
+                         .allow_unregistered()
+                         .run();
+  boost_po::store(parsed_line, map);
+  boost_po::notify(map);
+  if (map.count("help") == 1)
+  {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  // The thread limit must be set before the ThermalOperator is created since
+  // it selects the task scheme of the MatrixFree object.
+  unsigned int const n_threads = map["n-threads"].as<unsigned int>();
+  if (n_threads > 0)
+    dealii::MultithreadInfo::set_thread_limit(n_threads);
+
+  BenchmarkResult const result =
+      run_benchmark(communicator, map["n-divisions"].as<unsigned int>(),
+                    map["n-repetitions"].as<unsigned int>());
+
+  if (dealii::Utilities::MPI::this_mpi_process(communicator) == 0)
+  {
+    if (map.count("output-file") == 1)
+    {
+      std::ofstream file(map["output-file"].as<std::string>());
+      write_json(file, result);
+    }
+    else
+    {
+      write_json(std::cout, result);
+    }
+  }
+
+  return 0;
+}
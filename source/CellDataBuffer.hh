@@ -0,0 +1,300 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef CELL_DATA_BUFFER_HH
+#define CELL_DATA_BUFFER_HH
+
+#include <utils.hh>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/cell_status.h>
+
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace adamantine
+{
+/**
+ * Contiguous storage of a fixed number of doubles per active cell. The data of
+ * a cell is accessed using the active cell index. The memory is kept when the
+ * buffer is reinitialized so that a buffer can be reused by successive mesh
+ * updates without allocating.
+ */
+class CellDataBuffer
+{
+public:
+  /**
+   * Resize the buffer to @p n_cells cells of @p stride doubles and set all the
+   * values to @p value.
+   */
+  void reinit(unsigned int const n_cells, unsigned int const stride,
+              double const value = 0.)
+  {
+    _n_cells = n_cells;
+    _stride = stride;
+    _data.assign(static_cast<std::size_t>(n_cells) * stride, value);
+  }
+
+  /**
+   * Return the number of cells.
+   */
+  unsigned int n_cells() const { return _n_cells; }
+
+  /**
+   * Return the number of doubles stored per cell.
+   */
+  unsigned int stride() const { return _stride; }
+
+  /**
+   * Return a pointer to the data of the cell @p cell.
+   */
+  double *operator[](unsigned int const cell)
+  {
+    return _data.data() + static_cast<std::size_t>(cell) * _stride;
+  }
+
+  /**
+   * Return a pointer to the data of the cell @p cell.
+   */
+  double const *operator[](unsigned int const cell) const
+  {
+    return _data.data() + static_cast<std::size_t>(cell) * _stride;
+  }
+
+private:
+  unsigned int _n_cells = 0;
+  unsigned int _stride = 0;
+  std::vector<double> _data;
+};
+
+/**
+ * This class transfers a CellDataBuffer to the new mesh when a
+ * dealii::parallel::distributed::Triangulation is refined, coarsened, or
+ * repartitioned. It replaces dealii::parallel::distributed::CellDataTransfer
+ * for flat buffers: the data of the cells that persist is copied directly
+ * between the buffers and the Triangulation. The refinement and the coarsening
+ * strategies are only called for the cells that are refined or coarsened. They
+ * work on scratch buffers owned by this class: the data of the children is
+ * stored contiguously, the data of the child @p c starting at the offset
+ * c*stride.
+ */
+template <int dim>
+class CellDataBufferTransfer
+{
+public:
+  using cell_iterator = typename dealii::Triangulation<dim>::cell_iterator;
+  using RefinementStrategy = std::function<void(
+      cell_iterator const &parent, dealii::ArrayView<double const> parent_data,
+      dealii::ArrayView<double> children_data)>;
+  using CoarseningStrategy = std::function<void(
+      cell_iterator const &parent,
+      dealii::ArrayView<double const> children_data,
+      dealii::ArrayView<double> parent_data)>;
+
+  /**
+   * Refinement strategy where the children inherit the data of their parent.
+   */
+  static void preserve(cell_iterator const &parent,
+                       dealii::ArrayView<double const> parent_data,
+                       dealii::ArrayView<double> children_data);
+
+  /**
+   * Coarsening strategy where the parent takes the data of its children, which
+   * must be the same.
+   */
+  static void check_equality(cell_iterator const &parent,
+                             dealii::ArrayView<double const> children_data,
+                             dealii::ArrayView<double> parent_data);
+
+  /**
+   * Constructor. @p triangulation must be a
+   * dealii::parallel::distributed::Triangulation. Like
+   * dealii::parallel::distributed::CellDataTransfer, the Triangulation is only
+   * modified to attach and to retrieve the data.
+   */
+  CellDataBufferTransfer(
+      dealii::Triangulation<dim> const &triangulation,
+      RefinementStrategy refinement_strategy = &preserve,
+      CoarseningStrategy coarsening_strategy = &check_equality);
+
+  /**
+   * Attach the data of the locally owned cells in @p data_to_transfer to the
+   * Triangulation. The buffer must stay alive until the Triangulation is
+   * updated.
+   */
+  void prepare_for_coarsening_and_refinement(
+      CellDataBuffer const &data_to_transfer);
+
+  /**
+   * Copy the data attached to the Triangulation to @p transferred_data. The
+   * data of the cells that are not locally owned is set to infinity.
+   */
+  void unpack(CellDataBuffer &transferred_data);
+
+private:
+  dealii::parallel::distributed::Triangulation<dim> &_triangulation;
+  RefinementStrategy _refinement_strategy;
+  CoarseningStrategy _coarsening_strategy;
+  CellDataBuffer const *_data_to_transfer = nullptr;
+  unsigned int _stride = 0;
+  unsigned int _handle = std::numeric_limits<unsigned int>::max();
+  /**
+   * Scratch buffers passed to the strategies. They are sized once per transfer
+   * and reused for every refined or coarsened cell.
+   */
+  std::vector<double> _parent_data;
+  std::vector<double> _children_data;
+};
+
+template <int dim>
+CellDataBufferTransfer<dim>::CellDataBufferTransfer(
+    dealii::Triangulation<dim> const &triangulation,
+    RefinementStrategy refinement_strategy,
+    CoarseningStrategy coarsening_strategy)
+    : _triangulation(
+          dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
+              const_cast<dealii::Triangulation<dim> &>(triangulation))),
+      _refinement_strategy(std::move(refinement_strategy)),
+      _coarsening_strategy(std::move(coarsening_strategy))
+{
+}
+
+template <int dim>
+void CellDataBufferTransfer<dim>::preserve(
+    cell_iterator const &parent, dealii::ArrayView<double const> parent_data,
+    dealii::ArrayView<double> children_data)
+{
+  for (unsigned int c = 0; c < parent->n_children(); ++c)
+    std::copy(parent_data.begin(), parent_data.end(),
+              children_data.begin() + c * parent_data.size());
+}
+
+template <int dim>
+void CellDataBufferTransfer<dim>::check_equality(
+    cell_iterator const &parent, dealii::ArrayView<double const> children_data,
+    dealii::ArrayView<double> parent_data)
+{
+  std::size_t const stride = parent_data.size();
+  for (unsigned int c = 1; c < parent->n_children(); ++c)
+    ASSERT(std::equal(children_data.begin(), children_data.begin() + stride,
+                      children_data.begin() + c * stride),
+           "The data of the children of a coarsened cell differ.");
+
+  std::copy(children_data.begin(), children_data.begin() + stride,
+            parent_data.begin());
+}
+
+template <int dim>
+void CellDataBufferTransfer<dim>::prepare_for_coarsening_and_refinement(
+    CellDataBuffer const &data_to_transfer)
+{
+  ASSERT(data_to_transfer.n_cells() == _triangulation.n_active_cells(),
+         "The size of the buffer does not match the number of active cells.");
+
+  _data_to_transfer = &data_to_transfer;
+  _stride = data_to_transfer.stride();
+  _parent_data.resize(_stride);
+  _children_data.resize(dealii::GeometryInfo<dim>::max_children_per_cell *
+                        _stride);
+  std::size_t const n_bytes = _stride * sizeof(double);
+
+  // The returned std::vector<char> is imposed by
+  // Triangulation::register_data_attach.
+  _handle = _triangulation.register_data_attach(
+      [this, n_bytes](cell_iterator const &cell,
+                      dealii::CellStatus const status)
+      {
+        std::vector<char> buffer(n_bytes);
+        switch (status)
+        {
+        case dealii::CellStatus::cell_will_persist:
+        case dealii::CellStatus::cell_will_be_refined:
+        {
+          std::memcpy(buffer.data(),
+                      (*_data_to_transfer)[cell->active_cell_index()],
+                      n_bytes);
+          break;
+        }
+        case dealii::CellStatus::children_will_be_coarsened:
+        {
+          unsigned int const n_children = cell->n_children();
+          for (unsigned int c = 0; c < n_children; ++c)
+            std::memcpy(
+                _children_data.data() + c * _stride,
+                (*_data_to_transfer)[cell->child(c)->active_cell_index()],
+                n_bytes);
+          _coarsening_strategy(
+              cell,
+              dealii::ArrayView<double const>(_children_data.data(),
+                                              n_children * _stride),
+              dealii::make_array_view(_parent_data));
+          std::memcpy(buffer.data(), _parent_data.data(), n_bytes);
+          break;
+        }
+        default:
+        {
+          ASSERT(false, "Unexpected cell status.");
+        }
+        }
+
+        return buffer;
+      },
+      /* returns_variable_size_data */ false);
+}
+
+template <int dim>
+void CellDataBufferTransfer<dim>::unpack(CellDataBuffer &transferred_data)
+{
+  transferred_data.reinit(_triangulation.n_active_cells(), _stride,
+                          std::numeric_limits<double>::infinity());
+  std::size_t const n_bytes = _stride * sizeof(double);
+
+  _triangulation.notify_ready_to_unpack(
+      _handle,
+      [&](cell_iterator const &cell, dealii::CellStatus const status,
+          boost::iterator_range<std::vector<char>::const_iterator> const
+              &data_range)
+      {
+        switch (status)
+        {
+        case dealii::CellStatus::cell_will_persist:
+        case dealii::CellStatus::children_will_be_coarsened:
+        {
+          std::memcpy(transferred_data[cell->active_cell_index()],
+                      &*data_range.begin(), n_bytes);
+          break;
+        }
+        case dealii::CellStatus::cell_will_be_refined:
+        {
+          unsigned int const n_children = cell->n_children();
+          std::memcpy(_parent_data.data(), &*data_range.begin(), n_bytes);
+          _refinement_strategy(
+              cell,
+              dealii::ArrayView<double const>(_parent_data.data(), _stride),
+              dealii::ArrayView<double>(_children_data.data(),
+                                        n_children * _stride));
+          for (unsigned int c = 0; c < n_children; ++c)
+            std::memcpy(transferred_data[cell->child(c)->active_cell_index()],
+                        _children_data.data() + c * _stride, n_bytes);
+          break;
+        }
+        default:
+        {
+          ASSERT(false, "Unexpected cell status.");
+        }
+        }
+      });
+
+  _data_to_transfer = nullptr;
+}
+} // namespace adamantine
+
+#endif
@@ -74,36 +74,43 @@ template <int dim>
 dealii::VectorizedArray<double> CubeHeatSource<dim>::value(
     dealii::Point<dim, dealii::VectorizedArray<double>> const &points) const
 {
-  dealii::VectorizedArray<double> mask = 0.;
+  if (!this->_source_on)
+  {
+    return 0.;
+  }
 
-  if (this->_source_on)
+  // Mask the lanes outside of the cube without branching
+  dealii::VectorizedArray<double> const zero = 0.;
+  dealii::VectorizedArray<double> source = _value;
+  for (int d = 0; d < dim; ++d)
   {
-    for (unsigned int j = 0; j < points[0].size(); ++j)
-    {
-      if constexpr (dim == 2)
-      {
-        if ((points[0][j] >= _min_point[0]) &&
-            (points[0][j] <= _max_point[0]) &&
-            (points[1][j] >= _min_point[1]) && (points[1][j] <= _max_point[1]))
-        {
-          mask[j] = 1.;
-        }
-      }
-      if constexpr (dim == 3)
-      {
-        if ((points[0][j] >= _min_point[0]) &&
-            (points[0][j] <= _max_point[0]) &&
-            (points[1][j] >= _min_point[1]) &&
-            (points[1][j] <= _max_point[1]) &&
-            (points[2][j] >= _min_point[2]) && (points[2][j] <= _max_point[2]))
-        {
-          mask[j] = 1.;
-        }
-      }
-    }
+    source = dealii::compare_and_apply_mask<dealii::SIMDComparison::less_than>(
+        points[d], dealii::VectorizedArray<double>(_min_point[d]), zero,
+        source);
+    source =
+        dealii::compare_and_apply_mask<dealii::SIMDComparison::greater_than>(
+            points[d], dealii::VectorizedArray<double>(_max_point[d]), zero,
+            source);
+  }
+
+  return source;
+}
+
+template <int dim>
+void CubeHeatSource<dim>::add_values(
+    dealii::ArrayView<
+        dealii::Point<dim, dealii::VectorizedArray<double>> const> points,
+    dealii::ArrayView<dealii::VectorizedArray<double>> values) const
+{
+  ASSERT(points.size() == values.size(),
+         "The number of points and values are different");
+  if (!this->_source_on)
+  {
+    return;
   }
 
-  return mask * _value;
+  for (unsigned int q = 0; q < points.size(); ++q)
+    values[q] += CubeHeatSource<dim>::value(points[q]);
 }
 
 template <int dim>
@@ -122,6 +129,12 @@ CubeHeatSource<dim>::get_bounding_box(double const /*time*/,
   }
 }
 
+template <int dim>
+dealii::BoundingBox<dim> CubeHeatSource<dim>::get_support_bounding_box() const
+{
+  return {{_min_point, _max_point}};
+}
+
 } // namespace adamantine
 
 INSTANTIATE_DIM(CubeHeatSource)
@@ -54,9 +54,20 @@ public:
   value(dealii::Point<dim, dealii::VectorizedArray<double>> const &points)
       const final;
 
+  /**
+   * Add the value of the heat source at each of the @p points to @p values
+   * without any virtual call per point.
+   */
+  void add_values(
+      dealii::ArrayView<
+          dealii::Point<dim, dealii::VectorizedArray<double>> const> points,
+      dealii::ArrayView<dealii::VectorizedArray<double>> values) const final;
+
   dealii::BoundingBox<dim>
   get_bounding_box(double const time, double const scaling_factor) const final;
 
+  dealii::BoundingBox<dim> get_support_bounding_box() const final;
+
 private:
   double _start_time;
   double _end_time;
@@ -56,10 +56,32 @@ public:
   value(dealii::Point<dim, dealii::VectorizedArray<double>> const &points)
       const final;
 
+  /**
+   * Add the value of the heat source at each of the @p points to @p values.
+   * The parameters of the beam are loaded once and each batch of points is
+   * evaluated by the masked SIMD kernel, without any call per point. Nothing
+   * is added if the source is off.
+   */
+  void add_values(
+      dealii::ArrayView<
+          dealii::Point<dim, dealii::VectorizedArray<double>> const> points,
+      dealii::ArrayView<dealii::VectorizedArray<double>> values) const final;
+
   dealii::BoundingBox<dim>
   get_bounding_box(double const time, double const scaling_factor) const final;
 
+  dealii::BoundingBox<dim> get_support_bounding_box() const final;
+
 private:
+  /**
+   * Masked SIMD kernel that evaluates the heat source at @p rotated_points,
+   * i.e., at points already expressed in the frame of the beam. The lanes
+   * outside of the support are set to zero without branching.
+   */
+  dealii::VectorizedArray<double> compute_value(
+      dealii::Point<dim, dealii::VectorizedArray<double>> const &rotated_points)
+      const;
+
   bool const _five_axis;
   Quaternion _quaternion;
   dealii::Point<3, dealii::VectorizedArray<double>> _beam_center;
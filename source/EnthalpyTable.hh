@@ -0,0 +1,219 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef ENTHALPY_TABLE_HH
+#define ENTHALPY_TABLE_HH
+
+#include <MaterialProperty.hh>
+#include <MaterialStates.hh>
+#include <types.hh>
+#include <utils.hh>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace adamantine
+{
+/**
+ * This class tabulates the volumetric enthalpy of every material as a function
+ * of the temperature. The enthalpy is the integral of \f$ \rho C_p \f$ to which
+ * is added the latent heat. Like in the temperature formulation, the latent
+ * heat is released linearly between the solidus and the liquidus and it is
+ * ignored if the liquidus is not larger than the solidus. The solidus and the
+ * liquidus are nodes of the table, so the freezing range is represented
+ * exactly however narrow it is. The same table is used to recover the
+ * temperature from the enthalpy. Outside of the table, the enthalpy is
+ * extrapolated linearly.
+ */
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+class EnthalpyTable
+{
+public:
+  /**
+   * Constructor. The enthalpy of the @p n_material_ids materials is tabulated
+   * between zero and @p temperature_max using @p n_intervals uniform intervals
+   * to which are added the solidus and the liquidus.
+   */
+  EnthalpyTable(MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                                 MemorySpaceType> const &material_properties,
+                unsigned int n_material_ids, double temperature_max,
+                unsigned int n_intervals = 1000);
+
+  /**
+   * Return the volumetric enthalpy of the material @p material_id at the
+   * temperature @p temperature.
+   */
+  double get_enthalpy(dealii::types::material_id material_id,
+                      double temperature) const;
+
+  /**
+   * Return the temperature of the material @p material_id given its volumetric
+   * enthalpy @p enthalpy.
+   */
+  double get_temperature(dealii::types::material_id material_id,
+                         double enthalpy) const;
+
+private:
+  /**
+   * Interpolate linearly @p y at @p value given the increasing nodes @p x.
+   */
+  static double interpolate(std::vector<double> const &x,
+                            std::vector<double> const &y, double value);
+
+  /**
+   * Temperatures of the nodes of the table of each material.
+   */
+  std::vector<std::vector<double>> _temperatures;
+  /**
+   * Volumetric enthalpies of the nodes of the table of each material.
+   */
+  std::vector<std::vector<double>> _enthalpies;
+};
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+EnthalpyTable<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    EnthalpyTable(
+        MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                         MemorySpaceType> const &material_properties,
+        unsigned int n_material_ids, double temperature_max,
+        unsigned int n_intervals)
+    : _temperatures(n_material_ids), _enthalpies(n_material_ids)
+{
+  ASSERT_THROW(temperature_max > 0.,
+               "The maximum temperature of the enthalpy table must be "
+               "positive.");
+  ASSERT_THROW(n_intervals > 0,
+               "The enthalpy table needs at least one interval.");
+
+  unsigned int constexpr solid =
+      static_cast<unsigned int>(MaterialStates::State::solid);
+  bool const use_table = material_properties.properties_use_table();
+  for (unsigned int m = 0; m < n_material_ids; ++m)
+  {
+    std::vector<double> &temperatures = _temperatures[m];
+    for (unsigned int i = 0; i <= n_intervals; ++i)
+      temperatures.push_back(temperature_max * i / n_intervals);
+
+    double solidus = 0.;
+    double liquidus = 0.;
+    double latent_heat = 0.;
+    bool phase_change = false;
+    if constexpr (!std::is_same_v<MaterialStates, Solid>)
+    {
+      solidus = material_properties.get(m, Property::solidus);
+      liquidus = material_properties.get(m, Property::liquidus);
+      latent_heat = material_properties.get(m, Property::latent_heat);
+      phase_change = (liquidus > solidus) && (solidus < temperature_max);
+      if (phase_change)
+      {
+        temperatures.push_back(solidus);
+        if (liquidus < temperature_max)
+          temperatures.push_back(liquidus);
+        std::sort(temperatures.begin(), temperatures.end());
+        temperatures.erase(
+            std::unique(temperatures.begin(), temperatures.end()),
+            temperatures.end());
+      }
+    }
+
+    // Since the solidus and the liquidus are nodes of the table, the
+    // material is either solid, mushy, or liquid in the whole interval. We
+    // evaluate the properties at the middle of each interval.
+    std::vector<double> &enthalpies = _enthalpies[m];
+    enthalpies.assign(temperatures.size(), 0.);
+    std::array<double, MaterialStates::n_material_states> state_ratios = {};
+    for (unsigned int i = 1; i < temperatures.size(); ++i)
+    {
+      double const temperature = 0.5 * (temperatures[i - 1] + temperatures[i]);
+      double liquid_ratio = 0.;
+      if (phase_change)
+        liquid_ratio = std::clamp(
+            (temperature - solidus) / (liquidus - solidus), 0., 1.);
+      state_ratios[solid] = 1. - liquid_ratio;
+      if constexpr (!std::is_same_v<MaterialStates, Solid>)
+      {
+        unsigned int constexpr liquid =
+            static_cast<unsigned int>(MaterialStates::State::liquid);
+        state_ratios[liquid] = liquid_ratio;
+      }
+
+      double density = 0.;
+      double specific_heat = 0.;
+      if (use_table)
+      {
+        density = material_properties.template compute_material_property<true>(
+            StateProperty::density, m, state_ratios.data(), temperature);
+        specific_heat =
+            material_properties.template compute_material_property<true>(
+                StateProperty::specific_heat, m, state_ratios.data(),
+                temperature);
+      }
+      else
+      {
+        density =
+            material_properties.template compute_material_property<false>(
+                StateProperty::density, m, state_ratios.data(), temperature);
+        specific_heat =
+            material_properties.template compute_material_property<false>(
+                StateProperty::specific_heat, m, state_ratios.data(),
+                temperature);
+      }
+      if ((liquid_ratio > 0.) && (liquid_ratio < 1.))
+        specific_heat += latent_heat / (liquidus - solidus);
+
+      enthalpies[i] = enthalpies[i - 1] + density * specific_heat *
+                                              (temperatures[i] -
+                                               temperatures[i - 1]);
+      ASSERT_THROW(enthalpies[i] > enthalpies[i - 1],
+                   "The enthalpy formulation requires a positive product of "
+                   "the density and the specific heat.");
+    }
+  }
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline double
+EnthalpyTable<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    get_enthalpy(dealii::types::material_id material_id,
+                 double temperature) const
+{
+  return interpolate(_temperatures[material_id], _enthalpies[material_id],
+                     temperature);
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline double
+EnthalpyTable<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    get_temperature(dealii::types::material_id material_id,
+                    double enthalpy) const
+{
+  return interpolate(_enthalpies[material_id], _temperatures[material_id],
+                     enthalpy);
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline double
+EnthalpyTable<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    interpolate(std::vector<double> const &x, std::vector<double> const &y,
+                double value)
+{
+  // The first and the last intervals are also used to extrapolate outside of
+  // the table.
+  auto const upper = std::upper_bound(x.begin() + 1, x.end() - 1, value);
+  auto const i = std::distance(x.begin(), upper);
+
+  return y[i - 1] +
+         (y[i] - y[i - 1]) * (value - x[i - 1]) / (x[i] - x[i - 1]);
+}
+} // namespace adamantine
+
+#endif
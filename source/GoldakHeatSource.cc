@@ -46,6 +46,11 @@ void GoldakHeatSource<dim>::update_time(double time)
 template <int dim>
 double GoldakHeatSource<dim>::value(dealii::Point<dim> const &point) const
 {
+  if (!this->_source_on)
+  {
+    return 0.;
+  }
+
   dealii::Point<dim> rotated_point;
   if constexpr (dim == 2)
   {
@@ -89,32 +94,11 @@ double GoldakHeatSource<dim>::value(dealii::Point<dim> const &point) const
 }
 
 template <int dim>
-dealii::VectorizedArray<double> GoldakHeatSource<dim>::value(
-    dealii::Point<dim, dealii::VectorizedArray<double>> const &points) const
+inline dealii::VectorizedArray<double> GoldakHeatSource<dim>::compute_value(
+    dealii::Point<dim, dealii::VectorizedArray<double>> const &rotated_points)
+    const
 {
-  dealii::Point<dim, dealii::VectorizedArray<double>> rotated_points;
-  if constexpr (dim == 2)
-  {
-    rotated_points = points;
-  }
-  else
-  {
-    rotated_points = _five_axis ? _quaternion.rotate(points) : points;
-  }
-
   auto const z = rotated_points[axis<dim>::z] - _beam_center[axis<dim>::z];
-  auto const z_depth = z + _depth;
-  dealii::VectorizedArray<double> depth_mask;
-  for (unsigned int i = 0; i < depth_mask.size(); ++i)
-  {
-    depth_mask[i] = z_depth[i] < 0. ? 0. : 1.;
-  }
-  // If all the lanes of depth_mask are zero, we can return early
-  if (depth_mask.sum() == 0)
-  {
-    return depth_mask;
-  }
-
   auto xpy_squared = dealii::Utilities::fixed_power<2>(
       rotated_points[axis<dim>::x] - _beam_center[axis<dim>::x]);
   if constexpr (dim == 3)
@@ -124,27 +108,70 @@ dealii::VectorizedArray<double> GoldakHeatSource<dim>::value(
     xpy_squared += y_squared;
   }
 
-  // Evaluating the exponential is very expensive. Return early if we know
-  // that the heat source will be small.
-  auto const xpy_area = 5. * _radius_squared - xpy_squared;
-  dealii::VectorizedArray<double> xpy_mask;
-  for (unsigned int i = 0; i < xpy_mask.size(); ++i)
-  {
-    xpy_mask[i] = xpy_area[i] < 0. ? 0. : 1.;
-  }
-  // If all the lanes of xpy_mask are zero, we can return early
-  if (xpy_mask.sum() == 0)
-  {
-    return xpy_mask;
-  }
-
   // Goldak heat source equation:
   // alpha * exp(-3*(xpy_squared/radius_squared + (z/depth)^2))
   dealii::VectorizedArray<double> minus_three = -3.;
   auto exponent = dealii::Utilities::fixed_power<2>(z) * _inv_depth_squared;
   exponent += xpy_squared * _inv_radius_squared;
   exponent *= minus_three;
-  return depth_mask * _alpha * std::exp(exponent);
+  auto const heat_source = _alpha * std::exp(exponent);
+
+  // Like in the scalar version, the heat source is zero deeper than depth and
+  // further than sqrt(5) * radius from the center of the beam. The lanes are
+  // masked without branching so that the exponential stays vectorized.
+  dealii::VectorizedArray<double> const zero = 0.;
+  auto const xpy_masked_source =
+      dealii::compare_and_apply_mask<dealii::SIMDComparison::greater_than>(
+          xpy_squared, 5. * _radius_squared, zero, heat_source);
+  return dealii::compare_and_apply_mask<dealii::SIMDComparison::less_than>(
+      z + _depth, zero, zero, xpy_masked_source);
+}
+
+template <int dim>
+dealii::VectorizedArray<double> GoldakHeatSource<dim>::value(
+    dealii::Point<dim, dealii::VectorizedArray<double>> const &points) const
+{
+  if (!this->_source_on)
+  {
+    return 0.;
+  }
+
+  if constexpr (dim == 3)
+  {
+    if (_five_axis)
+      return compute_value(_quaternion.rotate(points));
+  }
+
+  return compute_value(points);
+}
+
+template <int dim>
+void GoldakHeatSource<dim>::add_values(
+    dealii::ArrayView<
+        dealii::Point<dim, dealii::VectorizedArray<double>> const> points,
+    dealii::ArrayView<dealii::VectorizedArray<double>> values) const
+{
+  ASSERT(points.size() == values.size(),
+         "The number of points and values are different");
+  if (!this->_source_on)
+  {
+    return;
+  }
+
+  // The rotation is decided once for all the points.
+  unsigned int const n_points = points.size();
+  if constexpr (dim == 3)
+  {
+    if (_five_axis)
+    {
+      for (unsigned int q = 0; q < n_points; ++q)
+        values[q] += compute_value(_quaternion.rotate(points[q]));
+      return;
+    }
+  }
+
+  for (unsigned int q = 0; q < n_points; ++q)
+    values[q] += compute_value(points[q]);
 }
 
 template <int dim>
@@ -198,6 +225,40 @@ GoldakHeatSource<dim>::get_bounding_box(double const time,
   }
 }
 
+template <int dim>
+dealii::BoundingBox<dim> GoldakHeatSource<dim>::get_support_bounding_box() const
+{
+  dealii::Point<dim> min_corner;
+  dealii::Point<dim> max_corner;
+  // With a five-axis scan path, the points are rotated before evaluating the
+  // heat source. The support is not bounded in the mesh coordinates.
+  if ((dim == 3) && _five_axis)
+  {
+    for (int d = 0; d < dim; ++d)
+    {
+      min_corner[d] = std::numeric_limits<double>::lowest();
+      max_corner[d] = std::numeric_limits<double>::max();
+    }
+    return {{min_corner, max_corner}};
+  }
+
+  // The heat source is zero further than sqrt(5) * radius from the center of
+  // the beam and deeper than depth. It is not bounded above the center of the
+  // beam.
+  double const xpy_radius = std::sqrt(5. * _radius_squared[0]);
+  min_corner[axis<dim>::x] = _beam_center[axis<dim>::x][0] - xpy_radius;
+  max_corner[axis<dim>::x] = _beam_center[axis<dim>::x][0] + xpy_radius;
+  if constexpr (dim == 3)
+  {
+    min_corner[axis<dim>::y] = _beam_center[axis<dim>::y][0] - xpy_radius;
+    max_corner[axis<dim>::y] = _beam_center[axis<dim>::y][0] + xpy_radius;
+  }
+  min_corner[axis<dim>::z] = _beam_center[axis<dim>::z][0] - _depth[0];
+  max_corner[axis<dim>::z] = std::numeric_limits<double>::max();
+
+  return {{min_corner, max_corner}};
+}
+
 } // namespace adamantine
 
 INSTANTIATE_DIM(GoldakHeatSource)
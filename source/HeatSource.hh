@@ -8,11 +8,19 @@
 #include <BeamHeatSourceProperties.hh>
 #include <ScanPath.hh>
 #include <types.hh>
+#include <utils.hh>
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/bounding_box.h>
 #include <deal.II/base/point.h>
 #include <deal.II/base/vectorization.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <vector>
+
 namespace adamantine
 {
 /**
@@ -89,6 +97,19 @@ public:
   virtual dealii::VectorizedArray<double>
   value(dealii::Point<dim, dealii::VectorizedArray<double>> const &points)
       const = 0;
+
+  /**
+   * Add the value of the heat source at each of the @p points to the
+   * corresponding entry of @p values. This evaluates all the quadrature points
+   * of a cell batch with a single virtual call. The derived classes override
+   * this function to evaluate the heat source without any virtual call per
+   * point.
+   */
+  virtual void add_values(
+      dealii::ArrayView<
+          dealii::Point<dim, dealii::VectorizedArray<double>> const> points,
+      dealii::ArrayView<dealii::VectorizedArray<double>> values) const;
+
   /**
    * Return the scan path for the heat source.
    */
@@ -106,6 +127,28 @@ public:
   virtual dealii::BoundingBox<dim>
   get_bounding_box(double const time, double const scaling_factor) const = 0;
 
+  /**
+   * Return bounding boxes that cover the scaled bounding box of the heat source
+   * over the time interval [@p start_time, @p end_time]. The heat source moves
+   * along a straight line on each segment of the scan path, so the interval is
+   * split at the end of the segments and the motion on each part is covered by
+   * the box enclosing the start and the end positions. A diagonal motion is
+   * split further so that the boxes stay close to the swept volume. The part
+   * of the interval after the end of the scan path is ignored since the heat
+   * source is off.
+   */
+  std::vector<dealii::BoundingBox<dim>>
+  get_swept_bounding_boxes(double const start_time, double const end_time,
+                           double const scaling_factor) const;
+
+  /**
+   * Return a bounding box outside of which the heat source is zero at the time
+   * set by the last call to update_time(). Unlike get_bounding_box(), the box
+   * is conservative and it can be used to skip the evaluation of the heat
+   * source.
+   */
+  virtual dealii::BoundingBox<dim> get_support_bounding_box() const = 0;
+
 protected:
   /**
    * Flag is true if the power is on. It is false otherwise.
@@ -127,6 +170,85 @@ inline bool HeatSource<dim>::is_source_on() const
   return _source_on;
 }
 
+template <int dim>
+inline void HeatSource<dim>::add_values(
+    dealii::ArrayView<
+        dealii::Point<dim, dealii::VectorizedArray<double>> const> points,
+    dealii::ArrayView<dealii::VectorizedArray<double>> values) const
+{
+  ASSERT(points.size() == values.size(),
+         "The number of points and values are different");
+  for (unsigned int q = 0; q < points.size(); ++q)
+    values[q] += value(points[q]);
+}
+
+template <int dim>
+inline std::vector<dealii::BoundingBox<dim>>
+HeatSource<dim>::get_swept_bounding_boxes(double const start_time,
+                                          double const end_time,
+                                          double const scaling_factor) const
+{
+  std::vector<dealii::BoundingBox<dim>> swept_boxes;
+  // After the end of the scan path, the heat source is off and its position is
+  // out of the domain, so the interval is clamped to the end of the path.
+  double const swept_end_time = std::min(end_time, _scan_path.get_end_time());
+  if (start_time > swept_end_time)
+    return swept_boxes;
+
+  double segment_start_time = start_time;
+  while (true)
+  {
+    double const segment_end_time =
+        std::min(_scan_path.get_next_segment_end_time(segment_start_time),
+                 swept_end_time);
+    dealii::BoundingBox<dim> const start_box =
+        get_bounding_box(segment_start_time, scaling_factor);
+    dealii::BoundingBox<dim> const end_box =
+        get_bounding_box(segment_end_time, scaling_factor);
+
+    // The box enclosing a motion along one axis is exact. Otherwise, the
+    // motion is split in pieces such that the box moves by at most its size
+    // along the other axes on each piece.
+    std::array<double, dim> relative_motion;
+    for (unsigned int d = 0; d < dim; ++d)
+    {
+      double const side_length = start_box.side_length(d);
+      double const motion =
+          std::abs(end_box.center()[d] - start_box.center()[d]);
+      relative_motion[d] = side_length > 0. ? motion / side_length : 0.;
+    }
+    std::sort(relative_motion.begin(), relative_motion.end(),
+              std::greater<double>());
+    unsigned int const n_pieces =
+        dim > 1 ? std::max(1u, static_cast<unsigned int>(
+                                   std::ceil(relative_motion[1])))
+                : 1u;
+
+    dealii::BoundingBox<dim> piece_start_box = start_box;
+    for (unsigned int i = 1; i <= n_pieces; ++i)
+    {
+      dealii::BoundingBox<dim> const piece_end_box =
+          i == n_pieces
+              ? end_box
+              : get_bounding_box(segment_start_time +
+                                     static_cast<double>(i) / n_pieces *
+                                         (segment_end_time -
+                                          segment_start_time),
+                                 scaling_factor);
+      dealii::BoundingBox<dim> swept_box = piece_start_box;
+      swept_box.merge_with(piece_end_box);
+      swept_boxes.push_back(swept_box);
+      piece_start_box = piece_end_box;
+    }
+
+    if (segment_end_time >= swept_end_time)
+      break;
+    segment_start_time = segment_end_time;
+  }
+
+  return swept_boxes;
+}
+
 template <int dim>
 inline ScanPath &HeatSource<dim>::get_scan_path()
 {
@@ -0,0 +1,195 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef IMPLICIT_OPERATOR_HH
+#define IMPLICIT_OPERATOR_HH
+
+#include <ThermalOperatorBase.hh>
+
+#include <deal.II/base/config.h>
+#if DEAL_II_VERSION_GTE(9, 7, 0)
+#include <deal.II/base/enable_observer_pointer.h>
+#else
+#include <deal.II/base/subscriptor.h>
+#endif
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace adamantine
+{
+/**
+ * This class uses a ThermalOperator to build the operator \f$ I - \tau J \f$
+ * used by the implicit time stepping schemes. \f$ J \f$ is the Jacobian of
+ * \f$ M^{-1} F(y) \f$, where \f$ F \f$ is the (nonlinear) ThermalOperator and
+ * \f$ M \f$ the mass matrix. Since the material properties depend on the
+ * temperature, the Jacobian is never assembled. Instead, its action is
+ * approximated by a finite difference of the ThermalOperator around a
+ * linearization point (Jacobian-free Newton-Krylov).
+ */
+template <int dim, typename MemorySpaceType>
+class ImplicitOperator
+#if DEAL_II_VERSION_GTE(9, 7, 0)
+    : public dealii::EnableObserverPointer
+#else
+    : public dealii::Subscriptor
+#endif
+{
+public:
+  using LA_Vector = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+
+  ImplicitOperator(
+      std::shared_ptr<ThermalOperatorBase<dim, MemorySpaceType>>
+          thermal_operator);
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  dealii::types::global_dof_index m() const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  dealii::types::global_dof_index n() const;
+
+  /**
+   * Matrix-vector multiplication: \f$ dst = (I - \tau J) src \f$.
+   */
+  void vmult(LA_Vector &dst, LA_Vector const &src) const;
+
+  /**
+   * Set the coefficient \f$ \tau \f$ in front of the Jacobian.
+   */
+  void set_tau(double tau);
+
+  /**
+   * Return the coefficient \f$ \tau \f$ in front of the Jacobian.
+   */
+  double get_tau() const;
+
+  /**
+   * Set the vector around which the ThermalOperator is linearized. The
+   * ThermalOperator is applied once to @p y and the result is cached. The
+   * ThermalOperator is always applied without updating the material state,
+   * which is only committed once the time step is accepted.
+   */
+  void set_linearization_point(LA_Vector const &y);
+
+  /**
+   * Return the vector around which the ThermalOperator is linearized.
+   */
+  LA_Vector const &get_linearization_point() const;
+
+private:
+  /**
+   * Coefficient in front of the Jacobian.
+   */
+  double _tau = 0.;
+  /**
+   * l2 norm of the linearization point.
+   */
+  double _linearization_point_norm = 0.;
+  /**
+   * Underlying ThermalOperator.
+   */
+  std::shared_ptr<ThermalOperatorBase<dim, MemorySpaceType>> _thermal_operator;
+  /**
+   * Vector around which the ThermalOperator is linearized.
+   */
+  LA_Vector _linearization_point;
+  /**
+   * ThermalOperator applied to _linearization_point.
+   */
+  LA_Vector _operator_at_linearization_point;
+  /**
+   * Temporary vector used to store the perturbed linearization point.
+   */
+  mutable LA_Vector _perturbed_point;
+};
+
+template <int dim, typename MemorySpaceType>
+ImplicitOperator<dim, MemorySpaceType>::ImplicitOperator(
+    std::shared_ptr<ThermalOperatorBase<dim, MemorySpaceType>>
+        thermal_operator)
+    : _thermal_operator(thermal_operator)
+{
+}
+
+template <int dim, typename MemorySpaceType>
+inline dealii::types::global_dof_index
+ImplicitOperator<dim, MemorySpaceType>::m() const
+{
+  return _thermal_operator->m();
+}
+
+template <int dim, typename MemorySpaceType>
+inline dealii::types::global_dof_index
+ImplicitOperator<dim, MemorySpaceType>::n() const
+{
+  return _thermal_operator->n();
+}
+
+template <int dim, typename MemorySpaceType>
+inline void ImplicitOperator<dim, MemorySpaceType>::set_tau(double tau)
+{
+  _tau = tau;
+}
+
+template <int dim, typename MemorySpaceType>
+inline double ImplicitOperator<dim, MemorySpaceType>::get_tau() const
+{
+  return _tau;
+}
+
+template <int dim, typename MemorySpaceType>
+inline typename ImplicitOperator<dim, MemorySpaceType>::LA_Vector const &
+ImplicitOperator<dim, MemorySpaceType>::get_linearization_point() const
+{
+  return _linearization_point;
+}
+
+template <int dim, typename MemorySpaceType>
+void ImplicitOperator<dim, MemorySpaceType>::set_linearization_point(
+    LA_Vector const &y)
+{
+  _linearization_point = y;
+  _linearization_point_norm = y.l2_norm();
+  _operator_at_linearization_point.reinit(y, true);
+  _thermal_operator->vmult_frozen_state(_operator_at_linearization_point, y);
+  _perturbed_point.reinit(y, true);
+}
+
+template <int dim, typename MemorySpaceType>
+void ImplicitOperator<dim, MemorySpaceType>::vmult(LA_Vector &dst,
+                                                   LA_Vector const &src) const
+{
+  double const src_norm = src.l2_norm();
+  if (src_norm == 0.)
+  {
+    dst = 0.;
+    return;
+  }
+
+  // The size of the perturbation is chosen to balance the truncation error of
+  // the finite difference and the round-off error.
+  double const epsilon =
+      std::sqrt(std::numeric_limits<double>::epsilon()) *
+      (1. + _linearization_point_norm) / src_norm;
+
+  // J src = M^{-1} (F(y + epsilon src) - F(y)) / epsilon. The source term does
+  // not depend on the temperature, so it cancels out in the difference.
+  _perturbed_point = _linearization_point;
+  _perturbed_point.add(epsilon, src);
+  _thermal_operator->vmult_frozen_state(dst, _perturbed_point);
+  dst -= _operator_at_linearization_point;
+  dst.scale(*_thermal_operator->get_inverse_mass_matrix());
+
+  // dst = src - tau J src
+  dst.sadd(-_tau / epsilon, 1., src);
+}
+} // namespace adamantine
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/memory_space.h>
+#include <deal.II/base/partitioner.h>
 #include <deal.II/base/types.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/distributed/tria.h>
@@ -24,9 +25,12 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <algorithm>
 #include <array>
 #include <limits>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace adamantine
 {
@@ -96,6 +100,26 @@ struct Data4D<-1, extent_1, extent_2, extent_3>
   using type = double *[extent_1][extent_2][extent_3];
 };
 
+/**
+ * Four dimensional datatype of indices for Kokkos::View:
+ * unsigned int[extent_0][extent_1][extent_2][extent_3]
+ */
+template <int extent_0, int extent_1, int extent_2, int extent_3>
+struct Index4D
+{
+  using type = unsigned int[extent_0][extent_1][extent_2][extent_3];
+};
+
+/**
+ * When extent_0 is -1, the extent is define at runtime. The other extents are
+ * defined at compile time.
+ */
+template <int extent_1, int extent_2, int extent_3>
+struct Index4D<-1, extent_1, extent_2, extent_3>
+{
+  using type = unsigned int *[extent_1][extent_2][extent_3];
+};
+
 /**
  * Five dimensional datatype for Kokkos::View:
  * double[extent_0][extent_1][extent_2][extent_3][extent_4]
@@ -132,6 +156,12 @@ public:
    */
   static unsigned int constexpr table_size = 12;
 
+  /**
+   * Number of temperatures of the uniform grids used to locate a temperature
+   * in the tables.
+   */
+  static unsigned int constexpr n_table_samples = 256;
+
   /**
    * Constructor.
    */
@@ -200,6 +230,27 @@ public:
                typename MemorySpaceType::kokkos_space>
   get_state_property_polynomials();
 
+  /**
+   * Return, for each table of the state properties, the number of nodes of the
+   * table whose temperature is lower or equal to each temperature of a uniform
+   * grid of n_table_samples temperatures.
+   */
+  Kokkos::View<typename internal::Index4D<
+                   n_materials, g_n_thermal_state_properties,
+                   MaterialStates::n_material_states, n_table_samples>::type,
+               typename MemorySpaceType::kokkos_space>
+  get_state_property_sample_intervals();
+
+  /**
+   * Return the first temperature and the inverse of the spacing of the
+   * uniform grids used by get_state_property_sample_intervals().
+   */
+  Kokkos::View<typename internal::Data4D<
+                   n_materials, g_n_thermal_state_properties,
+                   MaterialStates::n_material_states, 2>::type,
+               typename MemorySpaceType::kokkos_space>
+  get_state_property_sample_grids();
+
   /**
    * Reinitialize the DoFHandler associated with MaterialProperty and resize the
    * state vectors.
@@ -225,15 +276,17 @@ public:
 
   /**
    * Compute a material property at a quadrature point for a mix of states.
+   * The properties are stored in double precision and they are rounded to
+   * @p Number when the operator is evaluated in single precision.
    */
-  template <bool use_table, StateProperty state_property>
-  dealii::VectorizedArray<double> compute_material_property(
+  template <bool use_table, StateProperty state_property, typename Number>
+  dealii::VectorizedArray<Number> compute_material_property(
       std::array<dealii::types::material_id,
-                 dealii::VectorizedArray<double>::size()> const &material_id,
-      std::array<dealii::VectorizedArray<double>,
+                 dealii::VectorizedArray<Number>::size()> const &material_id,
+      std::array<dealii::VectorizedArray<Number>,
                  MaterialStates::n_material_states> const &state_ratios,
-      dealii::VectorizedArray<double> const &temperature,
-      dealii::AlignedVector<dealii::VectorizedArray<double>> const
+      dealii::VectorizedArray<Number> const &temperature,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> const
           &temperature_powers) const;
 
   /**
@@ -270,14 +323,22 @@ public:
   // This cannot be private due to limitation of lambda function with CUDA
   void set_initial_state();
 
+  /**
+   * Locate the temperatures of uniform grids in the tables of the state
+   * properties.
+   */
+  // This cannot be private due to limitation of lambda function with CUDA
+  void sample_state_property_tables();
+
   /**
    * Set the ratio of the material states from ThermalOperator.
    */
+  template <typename Number>
   void set_state(
-      dealii::Table<2, dealii::VectorizedArray<double>> const &liquid_ratio,
-      dealii::Table<2, dealii::VectorizedArray<double>> const &powder_ratio,
-      std::map<typename dealii::DoFHandler<dim>::cell_iterator,
-               std::pair<unsigned int, unsigned int>> &cell_it_to_mf_cell_map,
+      dealii::Table<2, dealii::VectorizedArray<Number>> const &liquid_ratio,
+      dealii::Table<2, dealii::VectorizedArray<Number>> const &powder_ratio,
+      std::vector<std::pair<unsigned int, unsigned int>> const
+          &cell_index_to_mf_cell_map,
       dealii::DoFHandler<dim> const &dof_handler);
 
   /**
@@ -326,14 +387,54 @@ public:
       unsigned int const material_id, unsigned int const material_state,
       unsigned int const property, double const temperature);
 
+  /**
+   * Compute a property given the temperature using a table. The position of
+   * the temperature in the uniform grid is computed instead of searched for and
+   * the grid gives the interval of the table. Only the nodes of the table that
+   * are in the same sampling interval as the temperature are tested. The
+   * interpolation uses the nodes of the table, so the result is the same as
+   * compute_property_from_table().
+   */
+  template <typename TablesViewType, typename IntervalsViewType,
+            typename GridsViewType>
+  static KOKKOS_FUNCTION double compute_property_from_samples(
+      TablesViewType const &state_property_tables,
+      IntervalsViewType const &state_property_sample_intervals,
+      GridsViewType const &state_property_sample_grids,
+      unsigned int const material_id, unsigned int const property,
+      unsigned int const material_state, double const temperature);
+
+  /**
+   * Compute a property from a table given the temperature at every lane of a
+   * VectorizedArray. The result is the same as the scalar version but the
+   * interval containing the temperature is found without branching, by
+   * counting the entries of the table below the temperature, and the bounds
+   * of the intervals are gathered lane by lane.
+   */
+  template <typename Number>
+  dealii::VectorizedArray<Number> compute_property_from_table(
+      std::array<dealii::types::material_id,
+                 dealii::VectorizedArray<Number>::size()> const &material_id,
+      unsigned int const property, unsigned int const material_state,
+      dealii::VectorizedArray<Number> const &temperature) const;
+
 private:
+  /**
+   * Return true if all the lanes use the same material. This is always the
+   * case when there is only one material.
+   */
+  template <std::size_t width>
+  static bool is_single_material(
+      std::array<dealii::types::material_id, width> const &material_id);
+
   /**
    * Fill the _properties map.
    */
   void fill_properties(boost::property_tree::ptree const &database);
 
   /**
-   * Return the index of the dof associated to the cell.
+   * Return the local index of the cell in _state. The cell must be locally
+   * owned.
    */
   dealii::types::global_dof_index get_dof_index(
       typename dealii::Triangulation<dim>::active_cell_iterator const &cell)
@@ -346,7 +447,17 @@ private:
   compute_average_temperature(
       dealii::DoFHandler<dim> const &temperature_dof_handler,
       dealii::LA::distributed::Vector<double, MemorySpaceType> const
-          &temperature) const;
+          &temperature);
+
+  /**
+   * Compute the weights and the local indices of the temperature DoFs used by
+   * compute_average_temperature(). This only needs to be done when the mesh
+   * or the DoFHandler of the temperature change.
+   */
+  void reinit_average_weights(
+      dealii::DoFHandler<dim> const &temperature_dof_handler,
+      std::shared_ptr<dealii::Utilities::MPI::Partitioner const> const
+          &partitioner);
 
   /**
    * MPI communicator.
@@ -365,6 +476,24 @@ private:
                    MaterialStates::n_material_states, table_size, 2>::type,
                typename MemorySpaceType::kokkos_space>
       _state_property_tables;
+  /**
+   * Number of nodes of the tables of _state_property_tables whose temperature
+   * is lower or equal to the temperatures of uniform grids.
+   */
+  Kokkos::View<typename internal::Index4D<
+                   n_materials, g_n_thermal_state_properties,
+                   MaterialStates::n_material_states, n_table_samples>::type,
+               typename MemorySpaceType::kokkos_space>
+      _state_property_sample_intervals;
+  /**
+   * First temperature and inverse of the spacing of the uniform grids of
+   * _state_property_sample_intervals.
+   */
+  Kokkos::View<typename internal::Data4D<
+                   n_materials, g_n_thermal_state_properties,
+                   MaterialStates::n_material_states, 2>::type,
+               typename MemorySpaceType::kokkos_space>
+      _state_property_sample_grids;
   /**
    * Thermal material properties which have been set
    * using polynomials.
@@ -431,6 +560,32 @@ private:
    * Mapping between the degrees of freedom and the local index of the cells.
    */
   std::unordered_map<dealii::types::global_dof_index, unsigned int> _dofs_map;
+  /**
+   * Local index of the cells in _state indexed by the active cell index. The
+   * index is invalid for the cells that are not locally owned.
+   */
+  std::vector<unsigned int> _cell_state_index;
+  /**
+   * Local indices of the temperature DoFs of each cell. The cells are ordered
+   * like in _state.
+   */
+  Kokkos::View<unsigned int **, typename MemorySpaceType::kokkos_space>
+      _average_dof_indices;
+  /**
+   * Integral of the shape functions of each cell divided by the volume of the
+   * cell. The weights of the cells that have no temperature DoF are zero.
+   */
+  Kokkos::View<double **, typename MemorySpaceType::kokkos_space>
+      _average_weights;
+  /**
+   * DoFHandler of the temperature used to compute _average_weights.
+   */
+  dealii::DoFHandler<dim> const *_average_dof_handler = nullptr;
+  /**
+   * Partitioner of the temperature used to compute _average_dof_indices.
+   */
+  std::shared_ptr<dealii::Utilities::MPI::Partitioner const>
+      _average_partitioner;
 };
 
 template <int dim, int n_materials, int p_order, typename MaterialStates,
@@ -490,6 +645,95 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates,
   return _state_property_polynomials;
 }
 
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline Kokkos::View<
+    typename internal::Index4D<
+        n_materials, g_n_thermal_state_properties,
+        MaterialStates::n_material_states,
+        MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                         MemorySpaceType>::n_table_samples>::type,
+    typename MemorySpaceType::kokkos_space>
+MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                 MemorySpaceType>::get_state_property_sample_intervals()
+{
+  return _state_property_sample_intervals;
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline Kokkos::View<typename internal::Data4D<
+                        n_materials, g_n_thermal_state_properties,
+                        MaterialStates::n_material_states, 2>::type,
+                    typename MemorySpaceType::kokkos_space>
+MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                 MemorySpaceType>::get_state_property_sample_grids()
+{
+  return _state_property_sample_grids;
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+template <typename TablesViewType, typename IntervalsViewType,
+          typename GridsViewType>
+KOKKOS_FUNCTION double
+MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    compute_property_from_samples(
+        TablesViewType const &state_property_tables,
+        IntervalsViewType const &state_property_sample_intervals,
+        GridsViewType const &state_property_sample_grids,
+        unsigned int const material_id, unsigned int const property,
+        unsigned int const material_state, double const temperature)
+{
+  // Below the table, the property is constant like in
+  // compute_property_from_table(). Otherwise, the first temperature of the grid
+  // is below the temperature.
+  if (temperature <=
+      state_property_tables(material_id, property, material_state, 0, 0))
+    return state_property_tables(material_id, property, material_state, 0, 1);
+
+  double const position =
+      (temperature -
+       state_property_sample_grids(material_id, property, material_state, 0)) *
+      state_property_sample_grids(material_id, property, material_state, 1);
+  double constexpr last_position = n_table_samples - 1;
+  unsigned int const j = position < last_position
+                             ? static_cast<unsigned int>(position)
+                             : n_table_samples - 1;
+
+  // Count the nodes of the table whose temperature is lower or equal to the
+  // temperature, starting from the count of the grid temperature. The count
+  // is corrected for the nodes between the grid temperature and the
+  // temperature, and for the round-off in the position.
+  unsigned int i =
+      state_property_sample_intervals(material_id, property, material_state, j);
+  while ((i < table_size) &&
+         (state_property_tables(material_id, property, material_state, i, 0) <=
+          temperature))
+    ++i;
+  while ((i > 1) && (state_property_tables(material_id, property,
+                                           material_state, i - 1, 0) >
+                     temperature))
+    --i;
+
+  // Same interpolation as compute_property_from_table().
+  if (i >= table_size - 1)
+    return state_property_tables(material_id, property, material_state,
+                                 table_size - 1, 1);
+
+  double const temperature_i =
+      state_property_tables(material_id, property, material_state, i, 0);
+  double const temperature_im1 =
+      state_property_tables(material_id, property, material_state, i - 1, 0);
+  double const property_i =
+      state_property_tables(material_id, property, material_state, i, 1);
+  double const property_im1 =
+      state_property_tables(material_id, property, material_state, i - 1, 1);
+  return property_im1 + (temperature - temperature_im1) *
+                            (property_i - property_im1) /
+                            (temperature_i - temperature_im1);
+}
+
 template <int dim, int n_materials, int p_order, typename MaterialStates,
           typename MemorySpaceType>
 inline Kokkos::View<double **, typename MemorySpaceType::kokkos_space>
@@ -507,14 +751,11 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
         typename dealii::Triangulation<dim>::active_cell_iterator const &cell)
         const
 {
-  // Get a DoFCellAccessor from a Triangulation::active_cell_iterator.
-  dealii::DoFAccessor<dim, dim, dim, false> dof_accessor(
-      &_mp_dof_handler.get_triangulation(), cell->level(), cell->index(),
-      &_mp_dof_handler);
-  std::vector<dealii::types::global_dof_index> mp_dof(1.);
-  dof_accessor.get_dof_indices(mp_dof);
-
-  return _dofs_map.at(mp_dof[0]);
+  ASSERT(_cell_state_index[cell->active_cell_index()] !=
+             dealii::numbers::invalid_unsigned_int,
+         "The cell is not locally owned.");
+
+  return _cell_state_index[cell->active_cell_index()];
 }
 
 template <int dim, int n_materials, int p_order, typename MaterialStates,
@@ -528,16 +769,36 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates,
 
 template <int dim, int n_materials, int p_order, typename MaterialStates,
           typename MemorySpaceType>
-template <bool use_table, StateProperty state_property>
-dealii::VectorizedArray<double>
+template <std::size_t width>
+inline bool
+MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    is_single_material(
+        std::array<dealii::types::material_id, width> const &material_id)
+{
+  if constexpr (n_materials == 1)
+  {
+    return true;
+  }
+  else
+  {
+    return std::all_of(material_id.begin() + 1, material_id.end(),
+                       [&](dealii::types::material_id const id)
+                       { return id == material_id[0]; });
+  }
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+template <bool use_table, StateProperty state_property, typename Number>
+dealii::VectorizedArray<Number>
 MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
     compute_material_property(
         std::array<dealii::types::material_id,
-                   dealii::VectorizedArray<double>::size()> const &material_id,
-        std::array<dealii::VectorizedArray<double>,
+                   dealii::VectorizedArray<Number>::size()> const &material_id,
+        std::array<dealii::VectorizedArray<Number>,
                    MaterialStates::n_material_states> const &state_ratios,
-        dealii::VectorizedArray<double> const &temperature,
-        dealii::AlignedVector<dealii::VectorizedArray<double>> const
+        dealii::VectorizedArray<Number> const &temperature,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>> const
             &temperature_powers) const
 {
   static_assert(p_order <= 4);
@@ -547,8 +808,8 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
   // To get the indices evaluated at compile time, we need to unroll the loops
   // by hand. This gives a substantial speed up for cases with few dofs.
 
-  dealii::VectorizedArray<double> value = 0.0;
-  dealii::VectorizedArray<double> property;
+  dealii::VectorizedArray<Number> value = 0.0;
+  dealii::VectorizedArray<Number> property;
   unsigned int constexpr property_index =
       static_cast<unsigned int>(state_property);
 
@@ -557,13 +818,8 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
     for (unsigned int material_state = 0;
          material_state < MaterialStates::n_material_states; ++material_state)
     {
-      for (unsigned int n = 0; n < dealii::VectorizedArray<double>::size(); ++n)
-      {
-        property[n] = compute_property_from_table(
-            _state_property_tables, material_id[n], property_index,
-            material_state, temperature[n]);
-      }
-
+      property = compute_property_from_table(material_id, property_index,
+                                             material_state, temperature);
       value += state_ratios[material_state] * property;
     }
   }
@@ -775,6 +1031,24 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
         }
       }
     }
+    else if (is_single_material(material_id))
+    {
+      // Most of the cell batches of a multi-material part only contain one
+      // material. The loops have compile-time bounds and the coefficients are
+      // broadcast to all the lanes like when there is only one material.
+      dealii::types::material_id const material = material_id[0];
+      for (unsigned int material_state = 0;
+           material_state < MaterialStates::n_material_states; ++material_state)
+      {
+        for (unsigned int i = 0; i <= p_order; ++i)
+        {
+          property = _state_property_polynomials(material, property_index,
+                                                 material_state, i);
+          value +=
+              state_ratios[material_state] * property * temperature_powers[i];
+        }
+      }
+    }
     else
     {
       for (unsigned int material_state = 0;
@@ -782,7 +1056,7 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
       {
         for (unsigned int i = 0; i <= p_order; ++i)
         {
-          for (unsigned int n = 0; n < dealii::VectorizedArray<double>::size();
+          for (unsigned int n = 0; n < dealii::VectorizedArray<Number>::size();
                ++n)
           {
             property[n] = _state_property_polynomials(
@@ -799,6 +1073,166 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
   return value;
 }
 
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+template <typename Number>
+dealii::VectorizedArray<Number>
+MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
+    compute_property_from_table(
+        std::array<dealii::types::material_id,
+                   dealii::VectorizedArray<Number>::size()> const &material_id,
+        unsigned int const property, unsigned int const material_state,
+        dealii::VectorizedArray<Number> const &temperature) const
+{
+  // The temperatures of the table are sorted in increasing order (this is
+  // checked when the tables are read). Thus, the number of entries whose
+  // temperature is lower or equal to the temperature gives the interval
+  // containing the temperature. When all the lanes use the same material, the
+  // temperatures of the table are the same for all the lanes.
+  dealii::VectorizedArray<Number> const one(1.);
+  dealii::VectorizedArray<Number> const zero(0.);
+  dealii::VectorizedArray<Number> n_below = 0.;
+  dealii::VectorizedArray<Number> table_temperature;
+  bool const single_material = is_single_material(material_id);
+  unsigned int const first_material = (n_materials == 1) ? 0 : material_id[0];
+  for (unsigned int i = 0; i < table_size; ++i)
+  {
+    if (single_material)
+    {
+      table_temperature = _state_property_tables(first_material, property,
+                                                 material_state, i, 0);
+    }
+    else
+    {
+      for (unsigned int n = 0; n < table_temperature.size(); ++n)
+        table_temperature[n] = _state_property_tables(
+            material_id[n], property, material_state, i, 0);
+    }
+    n_below += dealii::compare_and_apply_mask<
+        dealii::SIMDComparison::less_than_or_equal>(
+        table_temperature, temperature, one, zero);
+  }
+
+  // Gather the bounds of the interval of each lane. Like in the scalar version,
+  // the first value is used below the table and the last value is used in the
+  // last interval and above the table. In these cases, both bounds are the same
+  // entry and the slope is zero.
+  dealii::VectorizedArray<Number> temperature_low, temperature_high;
+  dealii::VectorizedArray<Number> property_low, property_high;
+  for (unsigned int n = 0; n < temperature.size(); ++n)
+  {
+    unsigned int const n_entries_below = static_cast<unsigned int>(n_below[n]);
+    unsigned int const material = (n_materials == 1) ? 0 : material_id[n];
+    unsigned int high = std::min(n_entries_below, table_size - 1);
+    unsigned int low = (n_entries_below == 0) ? 0 : high - 1;
+    if (n_entries_below >= table_size - 1)
+      low = high;
+    temperature_low[n] =
+        _state_property_tables(material, property, material_state, low, 0);
+    property_low[n] =
+        _state_property_tables(material, property, material_state, low, 1);
+    property_high[n] =
+        _state_property_tables(material, property, material_state, high, 1);
+    temperature_high[n] =
+        (low == high)
+            ? temperature_low[n] + 1.
+            : _state_property_tables(material, property, material_state, high,
+                                     0);
+  }
+
+  return property_low + (temperature - temperature_low) *
+                            (property_high - property_low) /
+                            (temperature_high - temperature_low);
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+template <typename Number>
+void MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                      MemorySpaceType>::
+    set_state(
+        [[maybe_unused]] dealii::Table<2, dealii::VectorizedArray<Number>> const
+            &liquid_ratio,
+        [[maybe_unused]] dealii::Table<2, dealii::VectorizedArray<Number>> const
+            &powder_ratio,
+        [[maybe_unused]] std::vector<
+            std::pair<unsigned int, unsigned int>> const
+            &cell_index_to_mf_cell_map,
+        [[maybe_unused]] dealii::DoFHandler<dim> const &dof_handler)
+{
+
+  if constexpr (std::is_same_v<MaterialStates, Solid>)
+  {
+    // When there is only Solid, we know we can set all of _state to one.
+    Kokkos::deep_copy(_state, 1.);
+  }
+  else
+  {
+    auto constexpr solid_state =
+        static_cast<unsigned int>(MaterialStates::State::solid);
+    auto constexpr liquid_state =
+        static_cast<unsigned int>(MaterialStates::State::liquid);
+
+    if constexpr (std::is_same_v<MaterialStates, SolidLiquid>)
+    {
+      unsigned int const n_q_points = liquid_ratio.size(1);
+      for (auto const &cell : dealii::filter_iterators(
+               dof_handler.active_cell_iterators(),
+               dealii::IteratorFilters::LocallyOwnedCell()))
+      {
+        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
+            cell);
+        auto mp_dof_index = get_dof_index(cell_tria);
+        auto const &mf_cell_vector =
+            cell_index_to_mf_cell_map[cell->active_cell_index()];
+        double liquid_ratio_sum = 0.;
+        // We should really use shape functions to compute the average. This is
+        // an approximation for FE degree greater than one.
+        for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          liquid_ratio_sum +=
+              liquid_ratio(mf_cell_vector.first, q)[mf_cell_vector.second];
+        }
+        _state(liquid_state, mp_dof_index) = liquid_ratio_sum / n_q_points;
+        _state(solid_state, mp_dof_index) =
+            1. - _state(liquid_state, mp_dof_index);
+      }
+    }
+    else if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
+    {
+      unsigned int const n_q_points = liquid_ratio.size(1);
+      auto constexpr powder_state =
+          static_cast<unsigned int>(MaterialStates::State::powder);
+      for (auto const &cell : dealii::filter_iterators(
+               dof_handler.active_cell_iterators(),
+               dealii::IteratorFilters::LocallyOwnedCell()))
+      {
+        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
+            cell);
+        auto mp_dof_index = get_dof_index(cell_tria);
+        auto const &mf_cell_vector =
+            cell_index_to_mf_cell_map[cell->active_cell_index()];
+        double liquid_ratio_sum = 0.;
+        double powder_ratio_sum = 0.;
+        // We should really use shape functions to compute the average. This is
+        // an approximation for FE degree greater than one.
+        for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          liquid_ratio_sum +=
+              liquid_ratio(mf_cell_vector.first, q)[mf_cell_vector.second];
+          powder_ratio_sum +=
+              powder_ratio(mf_cell_vector.first, q)[mf_cell_vector.second];
+        }
+        _state(liquid_state, mp_dof_index) = liquid_ratio_sum / n_q_points;
+        _state(powder_state, mp_dof_index) = powder_ratio_sum / n_q_points;
+        _state(solid_state, mp_dof_index) = 1. -
+                                            _state(liquid_state, mp_dof_index) -
+                                            _state(powder_state, mp_dof_index);
+      }
+    }
+  }
+}
+
 template <int dim, int n_materials, int p_order, typename MaterialStates,
           typename MemorySpaceType>
 template <bool use_table>
@@ -30,46 +30,34 @@ namespace adamantine
 {
 namespace internal
 {
-template <int dim>
+template <typename MemorySpaceType>
 void compute_average(
-    unsigned int const n_q_points, unsigned int const dofs_per_cell,
-    dealii::DoFHandler<dim> const &mp_dof_handler,
-    dealii::DoFHandler<dim> const &temperature_dof_handler,
-    dealii::hp::FEValues<dim> &hp_fe_values,
-    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+    Kokkos::View<unsigned int **, typename MemorySpaceType::kokkos_space>
+        average_dof_indices,
+    Kokkos::View<double **, typename MemorySpaceType::kokkos_space>
+        average_weights,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> const
         &temperature,
-    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+    dealii::LA::distributed::Vector<double, MemorySpaceType>
         &temperature_average)
 {
-  std::vector<dealii::types::global_dof_index> mp_dof_indices(1);
-  std::vector<dealii::types::global_dof_index> enth_dof_indices(dofs_per_cell);
-  auto mp_cell = mp_dof_handler.begin_active();
-  auto mp_end_cell = mp_dof_handler.end();
-  auto enth_cell = temperature_dof_handler.begin_active();
-  for (; mp_cell != mp_end_cell; ++enth_cell, ++mp_cell)
-  {
-    ASSERT(mp_cell->is_locally_owned() == enth_cell->is_locally_owned(),
-           "Internal Error");
-    if ((mp_cell->is_locally_owned()) && (enth_cell->active_fe_index() == 0))
-    {
-      hp_fe_values.reinit(enth_cell);
-      dealii::FEValues<dim> const &fe_values =
-          hp_fe_values.get_present_fe_values();
-      mp_cell->get_dof_indices(mp_dof_indices);
-      dealii::types::global_dof_index const mp_dof_index = mp_dof_indices[0];
-      enth_cell->get_dof_indices(enth_dof_indices);
-      double volume = 0.;
-      for (unsigned int q = 0; q < n_q_points; ++q)
-        for (unsigned int i = 0; i < dofs_per_cell; ++i)
-        {
-          volume += fe_values.shape_value(i, q) * fe_values.JxW(q);
-          temperature_average[mp_dof_index] +=
-              fe_values.shape_value(i, q) * temperature[enth_dof_indices[i]] *
-              fe_values.JxW(q);
-        }
-      temperature_average[mp_dof_index] /= volume;
-    }
-  }
+  using ExecutionSpace = std::conditional_t<
+      std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>,
+      Kokkos::DefaultHostExecutionSpace, Kokkos::DefaultExecutionSpace>;
+  // The ghost values are stored after the locally owned values.
+  double const *temperature_local = temperature.get_values();
+  double *temperature_average_local = temperature_average.get_values();
+  unsigned int const dofs_per_cell = average_weights.extent(1);
+  Kokkos::parallel_for(
+      "adamantine::compute_average",
+      Kokkos::RangePolicy<ExecutionSpace>(0, average_weights.extent(0)),
+      KOKKOS_LAMBDA(int i) {
+        double average = 0.;
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          average += average_weights(i, j) *
+                     temperature_local[average_dof_indices(i, j)];
+        temperature_average_local[i] = average;
+      });
 }
 
 template <typename ViewType,
@@ -82,32 +70,6 @@ double get_value(ViewType &view, unsigned int i, unsigned int j)
   return view(i, j);
 }
 
-template <int dim>
-void compute_average(
-    unsigned int const n_q_points, unsigned int const dofs_per_cell,
-    dealii::DoFHandler<dim> const &mp_dof_handler,
-    dealii::DoFHandler<dim> const &temperature_dof_handler,
-    dealii::hp::FEValues<dim> &hp_fe_values,
-    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Default> const
-        &temperature,
-    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Default>
-        &temperature_average)
-{
-  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-      temperature_host(temperature.get_partitioner());
-  temperature_host.import_elements(temperature,
-                                   dealii::VectorOperation::insert);
-  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-      temperature_average_host(temperature_average.get_partitioner());
-  temperature_average_host = 0.;
-  compute_average(n_q_points, dofs_per_cell, mp_dof_handler,
-                  temperature_dof_handler, hp_fe_values, temperature_host,
-                  temperature_average_host);
-
-  temperature_average.import_elements(temperature_average_host,
-                                      dealii::VectorOperation::insert);
-}
-
 template <typename ViewType,
           std::enable_if_t<
               !std::is_same_v<typename ViewType::memory_space,
@@ -142,6 +104,9 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
 
   // Fill the _properties map
   fill_properties(database);
+
+  if (_use_table)
+    sample_state_property_tables();
 }
 
 template <int dim, int n_materials, int p_order, typename MaterialStates,
@@ -214,8 +179,17 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
 {
   _mp_dof_handler.distribute_dofs(_fe);
 
-  // Initialize _dofs_map
+  // The weights used to compute the average temperature need to be recomputed
+  // on the new mesh.
+  _average_dof_handler = nullptr;
+  _average_partitioner.reset();
+
+  // Initialize _dofs_map and _cell_state_index. The latter is used to access
+  // the state of a cell without looking up its DoF.
   _dofs_map.clear();
+  _cell_state_index.assign(
+      _mp_dof_handler.get_triangulation().n_active_cells(),
+      dealii::numbers::invalid_unsigned_int);
   unsigned int i = 0;
   std::vector<dealii::types::global_dof_index> mp_dof(1);
   for (auto cell :
@@ -224,6 +198,7 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
   {
     cell->get_dof_indices(mp_dof);
     _dofs_map[mp_dof[0]] = i;
+    _cell_state_index[cell->active_cell_index()] = i;
     ++i;
   }
 
@@ -262,9 +237,7 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
        dealii::filter_iterators(_mp_dof_handler.active_cell_iterators(),
                                 dealii::IteratorFilters::LocallyOwnedCell()))
   {
-    std::vector<dealii::types::global_dof_index> mp_dof(1);
-    cell->get_dof_indices(mp_dof);
-    mp_dofs_vec.push_back(_dofs_map.at(mp_dof[0]));
+    mp_dofs_vec.push_back(_cell_state_index[cell->active_cell_index()]);
     material_ids_vec.push_back(cell->material_id());
   }
 
@@ -454,7 +427,6 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
       Kokkos::View<double **, typename MemorySpaceType::kokkos_space>(
           "property_values", g_n_thermal_state_properties, _dofs_map.size());
 
-  std::vector<dealii::types::global_dof_index> mp_dof(1);
   // We don't need to loop over all the active cells. We only need to loop over
   // the cells at the boundary and at the interface with FE_Nothing. However, to
   // do this we need to use the temperature_dof_handler instead of the
@@ -465,8 +437,7 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
   {
     dealii::types::material_id material_id = cell->material_id();
 
-    cell->get_dof_indices(mp_dof);
-    unsigned int const dof = _dofs_map.at(mp_dof[0]);
+    unsigned int const dof = _cell_state_index[cell->active_cell_index()];
     if (_use_table)
     {
       // We only care about properties that are used to compute the boundary
@@ -534,92 +505,6 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
   }
 }
 
-template <int dim, int n_materials, int p_order, typename MaterialStates,
-          typename MemorySpaceType>
-void MaterialProperty<dim, n_materials, p_order, MaterialStates,
-                      MemorySpaceType>::
-    set_state(
-        [[maybe_unused]] dealii::Table<2, dealii::VectorizedArray<double>> const
-            &liquid_ratio,
-        [[maybe_unused]] dealii::Table<2, dealii::VectorizedArray<double>> const
-            &powder_ratio,
-        [[maybe_unused]] std::map<
-            typename dealii::DoFHandler<dim>::cell_iterator,
-            std::pair<unsigned int, unsigned int>> &cell_it_to_mf_cell_map,
-        [[maybe_unused]] dealii::DoFHandler<dim> const &dof_handler)
-{
-
-  if constexpr (std::is_same_v<MaterialStates, Solid>)
-  {
-    // When there is only Solid, we know we can set all of _state to one.
-    Kokkos::deep_copy(_state, 1.);
-  }
-  else
-  {
-    auto constexpr solid_state =
-        static_cast<unsigned int>(MaterialStates::State::solid);
-    auto constexpr liquid_state =
-        static_cast<unsigned int>(MaterialStates::State::liquid);
-    std::vector<dealii::types::global_dof_index> mp_dof(1.);
-
-    if constexpr (std::is_same_v<MaterialStates, SolidLiquid>)
-    {
-      unsigned int const n_q_points = liquid_ratio.size(1);
-      for (auto const &cell : dealii::filter_iterators(
-               dof_handler.active_cell_iterators(),
-               dealii::IteratorFilters::LocallyOwnedCell()))
-      {
-        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
-            cell);
-        auto mp_dof_index = get_dof_index(cell_tria);
-        auto const &mf_cell_vector = cell_it_to_mf_cell_map[cell];
-        double liquid_ratio_sum = 0.;
-        // We should really use shape functions to compute the average. This is
-        // an approximation for FE degree greater than one.
-        for (unsigned int q = 0; q < n_q_points; ++q)
-        {
-          liquid_ratio_sum +=
-              liquid_ratio(mf_cell_vector.first, q)[mf_cell_vector.second];
-        }
-        _state(liquid_state, mp_dof_index) = liquid_ratio_sum / n_q_points;
-        _state(solid_state, mp_dof_index) =
-            1. - _state(liquid_state, mp_dof_index);
-      }
-    }
-    else if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
-    {
-      unsigned int const n_q_points = liquid_ratio.size(1);
-      auto constexpr powder_state =
-          static_cast<unsigned int>(MaterialStates::State::powder);
-      for (auto const &cell : dealii::filter_iterators(
-               dof_handler.active_cell_iterators(),
-               dealii::IteratorFilters::LocallyOwnedCell()))
-      {
-        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
-            cell);
-        auto mp_dof_index = get_dof_index(cell_tria);
-        auto const &mf_cell_vector = cell_it_to_mf_cell_map[cell];
-        double liquid_ratio_sum = 0.;
-        double powder_ratio_sum = 0.;
-        // We should really use shape functions to compute the average. This is
-        // an approximation for FE degree greater than one.
-        for (unsigned int q = 0; q < n_q_points; ++q)
-        {
-          liquid_ratio_sum +=
-              liquid_ratio(mf_cell_vector.first, q)[mf_cell_vector.second];
-          powder_ratio_sum +=
-              powder_ratio(mf_cell_vector.first, q)[mf_cell_vector.second];
-        }
-        _state(liquid_state, mp_dof_index) = liquid_ratio_sum / n_q_points;
-        _state(powder_state, mp_dof_index) = powder_ratio_sum / n_q_points;
-        _state(solid_state, mp_dof_index) = 1. -
-                                            _state(liquid_state, mp_dof_index) -
-                                            _state(powder_state, mp_dof_index);
-      }
-    }
-  }
-}
-
 template <int dim, int n_materials, int p_order, typename MaterialStates,
           typename MemorySpaceType>
 void MaterialProperty<dim, n_materials, p_order, MaterialStates,
@@ -764,9 +649,7 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
        dealii::filter_iterators(_mp_dof_handler.active_cell_iterators(),
                                 dealii::IteratorFilters::LocallyOwnedCell()))
   {
-    std::vector<dealii::types::global_dof_index> mp_dof(1);
-    cell->get_dof_indices(mp_dof);
-    mp_dofs_vec.push_back(_dofs_map.at(mp_dof[0]));
+    mp_dofs_vec.push_back(_cell_state_index[cell->active_cell_index()]);
     user_indices_vec.push_back(cell->user_index());
   }
 
@@ -793,6 +676,58 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
       KOKKOS_LAMBDA(int i) { state(user_indices(i), mp_dofs(i)) = 1.; });
 }
 
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                      MemorySpaceType>::sample_state_property_tables()
+{
+  using ExecutionSpace = std::conditional_t<
+      std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>,
+      Kokkos::DefaultHostExecutionSpace, Kokkos::DefaultExecutionSpace>;
+  auto state_property_tables = _state_property_tables;
+  auto state_property_sample_intervals = _state_property_sample_intervals;
+  auto state_property_sample_grids = _state_property_sample_grids;
+  unsigned int constexpr n_tables_per_material =
+      g_n_thermal_state_properties * MaterialStates::n_material_states;
+  unsigned int const n_tables =
+      state_property_tables.extent(0) * n_tables_per_material;
+  Kokkos::parallel_for(
+      "adamantine::sample_state_property_tables",
+      Kokkos::RangePolicy<ExecutionSpace>(0, n_tables),
+      KOKKOS_LAMBDA(int i) {
+        unsigned int const material_id = i / n_tables_per_material;
+        unsigned int const property =
+            (i % n_tables_per_material) / MaterialStates::n_material_states;
+        unsigned int const material_state =
+            i % MaterialStates::n_material_states;
+        // The unused entries of the tables repeat the last node, so the grid
+        // covers the table from its first to its last node.
+        double const temperature_min = state_property_tables(
+            material_id, property, material_state, 0, 0);
+        double const temperature_max = state_property_tables(
+            material_id, property, material_state, table_size - 1, 0);
+        double const spacing =
+            (temperature_max - temperature_min) / (n_table_samples - 1);
+        auto grid = Kokkos::subview(state_property_sample_grids, material_id,
+                                    property, material_state, Kokkos::ALL);
+        grid(0) = temperature_min;
+        grid(1) = spacing > 0. ? 1. / spacing : 0.;
+        // The temperatures of the grid are increasing, so the count of the
+        // nodes below them only increases.
+        unsigned int n_nodes = 0;
+        for (unsigned int j = 0; j < n_table_samples; ++j)
+        {
+          double const temperature = temperature_min + j * spacing;
+          while ((n_nodes < table_size) &&
+                 (state_property_tables(material_id, property, material_state,
+                                        n_nodes, 0) <= temperature))
+            ++n_nodes;
+          state_property_sample_intervals(material_id, property,
+                                          material_state, j) = n_nodes;
+        }
+      });
+}
+
 template <int dim, int n_materials, int p_order, typename MaterialStates,
           typename MemorySpaceType>
 void MaterialProperty<dim, n_materials, p_order, MaterialStates,
@@ -835,6 +770,22 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
                                     table_size, 2>::type,
           typename MemorySpaceType::kokkos_space>("state_property_tables",
                                                   n_materials_runtime);
+      _state_property_sample_intervals = Kokkos::View<
+          typename internal::Index4D<-1, g_n_thermal_state_properties,
+                                     MaterialStates::n_material_states,
+                                     n_table_samples>::type,
+          typename MemorySpaceType::kokkos_space>(
+          Kokkos::view_alloc("state_property_sample_intervals",
+                             Kokkos::WithoutInitializing),
+          n_materials_runtime);
+      _state_property_sample_grids = Kokkos::View<
+          typename internal::Data4D<-1, g_n_thermal_state_properties,
+                                    MaterialStates::n_material_states,
+                                    2>::type,
+          typename MemorySpaceType::kokkos_space>(
+          Kokkos::view_alloc("state_property_sample_grids",
+                             Kokkos::WithoutInitializing),
+          n_materials_runtime);
       // Mechanical properties only exist for the solid state. View is
       // initialized to zero in purpose.
       _mechanical_properties_tables_host = Kokkos::View<
@@ -851,6 +802,18 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
                                     MaterialStates::n_material_states,
                                     table_size, 2>::type,
           typename MemorySpaceType::kokkos_space>("state_property_tables");
+      _state_property_sample_intervals = Kokkos::View<
+          typename internal::Index4D<1, g_n_thermal_state_properties,
+                                     MaterialStates::n_material_states,
+                                     n_table_samples>::type,
+          typename MemorySpaceType::kokkos_space>(Kokkos::view_alloc(
+          "state_property_sample_intervals", Kokkos::WithoutInitializing));
+      _state_property_sample_grids = Kokkos::View<
+          typename internal::Data4D<1, g_n_thermal_state_properties,
+                                    MaterialStates::n_material_states,
+                                    2>::type,
+          typename MemorySpaceType::kokkos_space>(Kokkos::view_alloc(
+          "state_property_sample_grids", Kokkos::WithoutInitializing));
       // Mechanical properties only exist for the solid state. View is
       // initialized to zero in purpose.
       _mechanical_properties_tables_host = Kokkos::View<
@@ -945,12 +908,22 @@ void MaterialProperty<dim, n_materials, p_order, MaterialStates,
               unsigned int const parsed_property_size = parsed_property.size();
               ASSERT_THROW(parsed_property_size <= table_size,
                            "Too many coefficients, increase the table size");
+              double previous_temperature =
+                  std::numeric_limits<double>::lowest();
               for (unsigned int i = 0; i < parsed_property_size; ++i)
               {
                 std::vector<std::string> t_v;
                 boost::split(t_v, parsed_property[i],
                              [](char c) { return c == ','; });
                 ASSERT(t_v.size() == 2, "Error reading material property.");
+                // The lookup in the tables requires the temperatures to be
+                // sorted.
+                double const temperature = std::stod(t_v[0]);
+                ASSERT_THROW(temperature >= previous_temperature,
+                             "The temperatures of the table of " +
+                                 state_property_names[p] +
+                                 " are not in increasing order.");
+                previous_temperature = temperature;
                 if (p < g_n_thermal_state_properties)
                 {
                   state_property_tables_host(material_id, p, state, i, 0) =
@@ -1128,14 +1101,34 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
     compute_average_temperature(
         dealii::DoFHandler<dim> const &temperature_dof_handler,
         dealii::LA::distributed::Vector<double, MemorySpaceType> const
-            &temperature) const
+            &temperature)
 {
-  // TODO: this should probably done in a matrix-free fashion.
+  auto const &partitioner = temperature.get_partitioner();
+  if ((_average_dof_handler != &temperature_dof_handler) ||
+      !_average_partitioner ||
+      ((_average_partitioner != partitioner) &&
+       !_average_partitioner->is_compatible(*partitioner)))
+    reinit_average_weights(temperature_dof_handler, partitioner);
+
   // The triangulation is the same for both DoFHandler
   dealii::LA::distributed::Vector<double, MemorySpaceType> temperature_average(
       _mp_dof_handler.locally_owned_dofs(), temperature.get_mpi_communicator());
   temperature.update_ghost_values();
-  temperature_average = 0.;
+  internal::compute_average(_average_dof_indices, _average_weights,
+                            temperature, temperature_average);
+
+  return temperature_average;
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                      MemorySpaceType>::
+    reinit_average_weights(
+        dealii::DoFHandler<dim> const &temperature_dof_handler,
+        std::shared_ptr<dealii::Utilities::MPI::Partitioner const> const
+            &partitioner)
+{
   dealii::hp::FECollection<dim> const &fe_collection =
       temperature_dof_handler.get_fe_collection();
   dealii::hp::QCollection<dim> q_collection;
@@ -1144,15 +1137,50 @@ MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
   dealii::hp::FEValues<dim> hp_fe_values(
       fe_collection, q_collection,
       dealii::UpdateFlags::update_values |
-          dealii::UpdateFlags::update_quadrature_points |
           dealii::UpdateFlags::update_JxW_values);
-  unsigned int const n_q_points = q_collection.max_n_quadrature_points();
   unsigned int const dofs_per_cell = fe_collection.max_dofs_per_cell();
-  internal::compute_average(n_q_points, dofs_per_cell, _mp_dof_handler,
-                            temperature_dof_handler, hp_fe_values, temperature,
-                            temperature_average);
 
-  return temperature_average;
+  // The Views are initialized to zero in purpose. The cells without
+  // temperature DoFs have an average temperature of zero.
+  _average_dof_indices =
+      Kokkos::View<unsigned int **, typename MemorySpaceType::kokkos_space>(
+          "average_dof_indices", _dofs_map.size(), dofs_per_cell);
+  _average_weights =
+      Kokkos::View<double **, typename MemorySpaceType::kokkos_space>(
+          "average_weights", _dofs_map.size(), dofs_per_cell);
+  auto average_dof_indices_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::DefaultHostExecutionSpace{}, _average_dof_indices);
+  auto average_weights_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::DefaultHostExecutionSpace{}, _average_weights);
+
+  std::vector<dealii::types::global_dof_index> dof_indices(dofs_per_cell);
+  for (auto const &cell : dealii::filter_iterators(
+           temperature_dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0, true)))
+  {
+    hp_fe_values.reinit(cell);
+    dealii::FEValues<dim> const &fe_values =
+        hp_fe_values.get_present_fe_values();
+    cell->get_dof_indices(dof_indices);
+    unsigned int const i = _cell_state_index[cell->active_cell_index()];
+    double volume = 0.;
+    for (unsigned int q = 0; q < fe_values.n_quadrature_points; ++q)
+      volume += fe_values.JxW(q);
+    for (unsigned int j = 0; j < dofs_per_cell; ++j)
+    {
+      double weight = 0.;
+      for (unsigned int q = 0; q < fe_values.n_quadrature_points; ++q)
+        weight += fe_values.shape_value(j, q) * fe_values.JxW(q);
+      average_weights_host(i, j) = weight / volume;
+      average_dof_indices_host(i, j) =
+          partitioner->global_to_local(dof_indices[j]);
+    }
+  }
+
+  Kokkos::deep_copy(_average_dof_indices, average_dof_indices_host);
+  Kokkos::deep_copy(_average_weights, average_weights_host);
+  _average_dof_handler = &temperature_dof_handler;
+  _average_partitioner = partitioner;
 }
 
 // FIXME move this to the header file, so that property can be known at compile
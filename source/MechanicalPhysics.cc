@@ -34,9 +34,7 @@ MechanicalPhysics<dim, n_materials, p_order, MaterialStates, MemorySpaceType>::
       _material_properties(material_properties),
       _dof_handler(_geometry.get_triangulation()),
       _solution_transfer(_dof_handler),
-      _cell_data_transfer(
-          dynamic_cast<const dealii::parallel::distributed::Triangulation<dim>
-                           &>(_dof_handler.get_triangulation()))
+      _cell_data_transfer(_dof_handler.get_triangulation())
 {
   // Create the FECollection
   _fe_collection.push_back(
@@ -161,7 +159,6 @@ void MechanicalPhysics<dim, n_materials, p_order, MaterialStates,
   _old_displacement.update_ghost_values();
   _solution_transfer.prepare_for_coarsening_and_refinement(_old_displacement);
 
-  _data_to_transfer.clear();
   unsigned int const n_quad_pts = _q_collection.max_n_quadrature_points();
   unsigned int const n_doubles_per_quad_plastic = 1;
   unsigned int const n_doubles_per_quad_stress =
@@ -169,22 +166,23 @@ void MechanicalPhysics<dim, n_materials, p_order, MaterialStates,
 
   unsigned int const n_doubles_per_quad =
       n_doubles_per_quad_plastic + n_doubles_per_quad_stress * 2;
-  std::vector<double> dummy_cell_data(n_quad_pts * n_doubles_per_quad,
-                                      std::numeric_limits<double>::infinity());
+  _data_to_transfer.reinit(_dof_handler.get_triangulation().n_active_cells(),
+                           n_quad_pts * n_doubles_per_quad,
+                           std::numeric_limits<double>::infinity());
 
   unsigned int cell_id = 0;
   for (auto const &cell : _dof_handler.active_cell_iterators())
   {
     if (cell->is_locally_owned())
     {
-      std::vector<double> cell_data(n_quad_pts * n_doubles_per_quad);
+      double *cell_data = _data_to_transfer[cell_id];
       unsigned int const stress_offset =
           n_quad_pts * n_doubles_per_quad_plastic;
       unsigned int const back_stress_offset =
           n_quad_pts * (n_doubles_per_quad_plastic + n_doubles_per_quad_stress);
 
       std::copy(_plastic_internal_variable[cell_id].begin(),
-                _plastic_internal_variable[cell_id].end(), cell_data.begin());
+                _plastic_internal_variable[cell_id].end(), cell_data);
 
       for (unsigned int quad = 0; quad < n_quad_pts; ++quad)
       {
@@ -196,11 +194,6 @@ void MechanicalPhysics<dim, n_materials, p_order, MaterialStates,
               _back_stress[cell_id][quad].access_raw_entry(i);
         }
       }
-      _data_to_transfer.push_back(std::move(cell_data));
-    }
-    else
-    {
-      _data_to_transfer.push_back(dummy_cell_data);
     }
     ++cell_id;
   }
@@ -240,24 +233,20 @@ void MechanicalPhysics<dim, n_materials, p_order, MaterialStates,
   unsigned int const n_doubles_per_quad_stress =
       dealii::SymmetricTensor<2, dim>::n_independent_components;
 
-  unsigned int const n_doubles_per_quad =
-      n_doubles_per_quad_plastic + n_doubles_per_quad_stress * 2;
-  std::vector<std::vector<double>> data_to_unpack(
-      n_active_cells, std::vector<double>(n_doubles_per_quad * n_quad_pts));
-  _cell_data_transfer.unpack(data_to_unpack);
+  _cell_data_transfer.unpack(_transferred_data);
 
   unsigned int cell_id = 0;
   for (auto const &cell : _dof_handler.active_cell_iterators())
   {
     if (cell->is_locally_owned())
     {
+      double const *cell_data = _transferred_data[cell_id];
       unsigned int const stress_offset =
           n_quad_pts * n_doubles_per_quad_plastic;
       unsigned int const back_stress_offset =
           n_quad_pts * (n_doubles_per_quad_plastic + n_doubles_per_quad_stress);
 
-      std::copy(data_to_unpack[cell_id].begin(),
-                data_to_unpack[cell_id].begin() + stress_offset,
+      std::copy(cell_data, cell_data + stress_offset,
                 _plastic_internal_variable[cell_id].begin());
 
       for (unsigned int quad = 0; quad < n_quad_pts; ++quad)
@@ -265,11 +254,10 @@ void MechanicalPhysics<dim, n_materials, p_order, MaterialStates,
         for (unsigned int i = 0; i < n_doubles_per_quad_stress; ++i)
         {
           _stress[cell_id][quad].access_raw_entry(i) =
-              data_to_unpack[cell_id][stress_offset +
-                                      quad * n_doubles_per_quad_stress + i];
+              cell_data[stress_offset + quad * n_doubles_per_quad_stress + i];
           _back_stress[cell_id][quad].access_raw_entry(i) =
-              data_to_unpack[cell_id][back_stress_offset +
-                                      quad * n_doubles_per_quad_stress + i];
+              cell_data[back_stress_offset + quad * n_doubles_per_quad_stress +
+                        i];
         }
       }
     }
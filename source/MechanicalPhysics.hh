@@ -6,6 +6,7 @@
 #define MECHANICAL_PHYSICS_HH
 
 #include <Boundary.hh>
+#include <CellDataBuffer.hh>
 #include <Geometry.hh>
 #include <MechanicalOperator.hh>
 
@@ -188,14 +189,14 @@ private:
    * _stress, and _back_stress when the triangulation is updated when adding
    * material
    */
-  dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>
-      _cell_data_transfer;
+  CellDataBufferTransfer<dim> _cell_data_transfer;
 
   /**
-   * Temporary storaged used by _cell_data_transfer
+   * Temporary storaged used by _cell_data_transfer. The buffers are reused by
+   * all the mesh updates.
    */
-  std::vector<std::vector<double>> _data_to_transfer;
+  CellDataBuffer _data_to_transfer;
+  CellDataBuffer _transferred_data;
 };
 
 template <int dim, int n_materials, int p_order, typename MaterialStates,
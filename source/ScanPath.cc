@@ -8,6 +8,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 namespace adamantine
@@ -298,6 +299,22 @@ std::vector<ScanPathSegment> ScanPath::get_segment_list() const
   return _segment_list;
 }
 
+double ScanPath::get_next_segment_end_time(double const time) const
+{
+  auto segment = std::upper_bound(
+      _segment_list.begin(), _segment_list.end(), time,
+      [](double const t, ScanPathSegment const &s) { return t < s.end_time; });
+
+  return segment == _segment_list.end() ? std::numeric_limits<double>::max()
+                                        : segment->end_time;
+}
+
+double ScanPath::get_end_time() const
+{
+  return _segment_list.empty() ? std::numeric_limits<double>::max()
+                               : _segment_list.back().end_time;
+}
+
 bool ScanPath::is_finished() const { return _scan_path_end; }
 
 bool ScanPath::is_five_axis() const { return _five_axis; }
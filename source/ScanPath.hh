@@ -106,6 +106,18 @@ public:
    */
   std::vector<ScanPathSegment> get_segment_list() const;
 
+  /**
+   * Return the end time of the first segment ending strictly after @p time. If
+   * there is no such segment, return the largest double.
+   */
+  double get_next_segment_end_time(double const time) const;
+
+  /**
+   * Return the end time of the last segment. If there is no segment, return
+   * the largest double.
+   */
+  double get_end_time() const;
+
   /**
    * Read the scan path file and update the list of segments.
    */
@@ -0,0 +1,401 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef THERMAL_MULTIGRID_PRECONDITIONER_HH
+#define THERMAL_MULTIGRID_PRECONDITIONER_HH
+
+#include <Boundary.hh>
+#include <ImplicitOperator.hh>
+#include <MaterialProperty.hh>
+#include <ThermalOperator.hh>
+#include <utils.hh>
+
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/hp/fe_collection.h>
+#include <deal.II/hp/q_collection.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <memory>
+
+namespace adamantine
+{
+/**
+ * Two-level polynomial multigrid preconditioner for the ImplicitOperator. The
+ * fine level uses the FE_Q of the simulation while the coarse level uses FE_Q
+ * of degree one on the same hp-mesh, i.e., the active/inactive (FE_Nothing)
+ * partition of the cells is identical on both levels. Both levels are smoothed
+ * using Chebyshev iterations. The ImplicitOperator is already scaled by the
+ * inverse of the (diagonal) mass matrix, so the Chebyshev iterations are
+ * driven by a unit diagonal and the mass matrices are used to move the
+ * residual between the levels.
+ * @note The preconditioner only works on the host.
+ */
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename QuadratureType>
+class ThermalMultigridPreconditioner
+{
+public:
+  using LA_Vector =
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>;
+
+  /**
+   * Constructor. @p smoother_degree is the degree of the Chebyshev polynomial
+   * used to smooth the fine level.
+   */
+  ThermalMultigridPreconditioner(
+      MPI_Comm const &communicator, Boundary const &boundary,
+      MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                       dealii::MemorySpace::Host> &material_properties,
+      unsigned int const smoother_degree);
+
+  /**
+   * Build the coarse level and the transfer operator. This function needs to
+   * be called every time the fine DoFHandler changes.
+   */
+  void
+  reinit(dealii::DoFHandler<dim> const &fine_dof_handler,
+         dealii::AffineConstraints<double> const &fine_affine_constraints,
+         std::shared_ptr<ThermalOperatorBase<dim, dealii::MemorySpace::Host>>
+             fine_thermal_operator,
+         std::vector<double> const &deposition_cos,
+         std::vector<double> const &deposition_sin);
+
+  /**
+   * Update the coarse level for the current linearization point and
+   * coefficient \f$ \tau \f$ of @p fine_operator. The smoothers, and thus the
+   * estimates of their largest eigenvalue, are only rebuilt after reinit() or
+   * when \f$ \tau \f$ changes.
+   */
+  void
+  update(ImplicitOperator<dim, dealii::MemorySpace::Host> const &fine_operator);
+
+  /**
+   * Apply one V-cycle.
+   */
+  void vmult(LA_Vector &dst, LA_Vector const &src) const;
+
+private:
+  using Smoother =
+      dealii::PreconditionChebyshev<ImplicitOperator<dim,
+                                                     dealii::MemorySpace::Host>,
+                                    LA_Vector>;
+
+  /**
+   * Return the additional data used to initialize a Chebyshev smoother.
+   */
+  typename Smoother::AdditionalData chebyshev_data(
+      unsigned int const degree, double const smoothing_range,
+      std::shared_ptr<dealii::DiagonalMatrix<LA_Vector>> const &unit_diagonal)
+      const;
+
+  /**
+   * MPI communicator.
+   */
+  MPI_Comm const &_communicator;
+  /**
+   * Associated boundary.
+   */
+  Boundary _boundary;
+  /**
+   * Associated material properties.
+   */
+  MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                   dealii::MemorySpace::Host> &_material_properties;
+  /**
+   * Degree of the Chebyshev polynomial on the fine level.
+   */
+  unsigned int _smoother_degree;
+  /**
+   * FECollection of the coarse level: FE_Q of degree one and FE_Nothing.
+   */
+  dealii::hp::FECollection<dim> _coarse_fe_collection;
+  /**
+   * QCollection of the coarse level.
+   */
+  dealii::hp::QCollection<1> _coarse_q_collection;
+  /**
+   * DoFHandler of the coarse level.
+   */
+  dealii::DoFHandler<dim> _coarse_dof_handler;
+  /**
+   * AffineConstraints of the coarse level.
+   */
+  dealii::AffineConstraints<double> _coarse_affine_constraints;
+  /**
+   * ThermalOperator of the fine level.
+   */
+  std::shared_ptr<ThermalOperatorBase<dim, dealii::MemorySpace::Host>>
+      _fine_thermal_operator;
+  /**
+   * ThermalOperator of the coarse level.
+   */
+  std::shared_ptr<ThermalOperatorBase<dim, dealii::MemorySpace::Host>>
+      _coarse_thermal_operator;
+  /**
+   * ImplicitOperator of the fine level. Non-owning pointer set by update().
+   */
+  ImplicitOperator<dim, dealii::MemorySpace::Host> const *_fine_operator =
+      nullptr;
+  /**
+   * ImplicitOperator of the coarse level.
+   */
+  std::unique_ptr<ImplicitOperator<dim, dealii::MemorySpace::Host>>
+      _coarse_operator;
+  /**
+   * Transfer operator between the coarse and the fine levels.
+   */
+  dealii::MGTwoLevelTransfer<dim, LA_Vector> _transfer;
+  /**
+   * Chebyshev smoother of the fine level.
+   */
+  Smoother _fine_smoother;
+  /**
+   * Chebyshev iterations used as coarse solver.
+   */
+  Smoother _coarse_solver;
+  /**
+   * Unit diagonals driving the Chebyshev iterations. They are resized by
+   * reinit() and shared by the successive initializations of the smoothers.
+   */
+  std::shared_ptr<dealii::DiagonalMatrix<LA_Vector>> _fine_unit_diagonal;
+  std::shared_ptr<dealii::DiagonalMatrix<LA_Vector>> _coarse_unit_diagonal;
+  /**
+   * Flag set to false when the smoothers need to be rebuilt.
+   */
+  bool _smoothers_up_to_date = false;
+  /**
+   * Coefficient \f$ \tau \f$ of the operators used to build the smoothers.
+   */
+  double _smoothers_tau = 0.;
+  /**
+   * Linearization point of the coarse level.
+   */
+  LA_Vector _coarse_linearization_point;
+  /**
+   * Diagonal of the mass matrix of the fine level.
+   */
+  LA_Vector _fine_mass_matrix;
+  /**
+   * Temporary vectors.
+   */
+  mutable LA_Vector _fine_residual;
+  mutable LA_Vector _coarse_residual;
+  mutable LA_Vector _coarse_correction;
+};
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename QuadratureType>
+ThermalMultigridPreconditioner<dim, n_materials, p_order, MaterialStates,
+                               QuadratureType>::
+    ThermalMultigridPreconditioner(
+        MPI_Comm const &communicator, Boundary const &boundary,
+        MaterialProperty<dim, n_materials, p_order, MaterialStates,
+                         dealii::MemorySpace::Host> &material_properties,
+        unsigned int const smoother_degree)
+    : _communicator(communicator), _boundary(boundary),
+      _material_properties(material_properties),
+      _smoother_degree(smoother_degree),
+      _fine_unit_diagonal(
+          std::make_shared<dealii::DiagonalMatrix<LA_Vector>>()),
+      _coarse_unit_diagonal(
+          std::make_shared<dealii::DiagonalMatrix<LA_Vector>>())
+{
+  _coarse_fe_collection.push_back(dealii::FE_Q<dim>(1));
+  _coarse_fe_collection.push_back(dealii::FE_Nothing<dim>());
+
+  _coarse_q_collection.push_back(QuadratureType(2));
+  _coarse_q_collection.push_back(QuadratureType(2));
+
+  // The heat sources do not depend on the temperature and thus, they do not
+  // contribute to the Jacobian. The coarse operator does not need them.
+  std::vector<std::shared_ptr<HeatSource<dim>>> no_heat_sources;
+  if (_material_properties.properties_use_table())
+  {
+    _coarse_thermal_operator = std::make_shared<
+        ThermalOperator<dim, n_materials, true, p_order, 1, MaterialStates,
+                        dealii::MemorySpace::Host>>(
+        _communicator, _boundary, _material_properties, no_heat_sources);
+  }
+  else
+  {
+    _coarse_thermal_operator = std::make_shared<
+        ThermalOperator<dim, n_materials, false, p_order, 1, MaterialStates,
+                        dealii::MemorySpace::Host>>(
+        _communicator, _boundary, _material_properties, no_heat_sources);
+  }
+  _coarse_operator =
+      std::make_unique<ImplicitOperator<dim, dealii::MemorySpace::Host>>(
+          _coarse_thermal_operator);
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename QuadratureType>
+void ThermalMultigridPreconditioner<dim, n_materials, p_order, MaterialStates,
+                                    QuadratureType>::
+    reinit(dealii::DoFHandler<dim> const &fine_dof_handler,
+           dealii::AffineConstraints<double> const &fine_affine_constraints,
+           std::shared_ptr<ThermalOperatorBase<dim, dealii::MemorySpace::Host>>
+               fine_thermal_operator,
+           std::vector<double> const &deposition_cos,
+           std::vector<double> const &deposition_sin)
+{
+  _fine_thermal_operator = fine_thermal_operator;
+
+  // The coarse level uses the same mesh and the same activated cells as the
+  // fine level.
+  _coarse_thermal_operator->clear();
+  _coarse_dof_handler.reinit(fine_dof_handler.get_triangulation());
+  auto coarse_cell = _coarse_dof_handler.begin_active();
+  for (auto const &fine_cell : fine_dof_handler.active_cell_iterators())
+  {
+    if (fine_cell->is_locally_owned())
+      coarse_cell->set_active_fe_index(fine_cell->active_fe_index());
+    ++coarse_cell;
+  }
+  _coarse_dof_handler.distribute_dofs(_coarse_fe_collection);
+
+  dealii::IndexSet locally_relevant_dofs =
+      dealii::DoFTools::extract_locally_relevant_dofs(_coarse_dof_handler);
+  _coarse_affine_constraints.reinit(_coarse_dof_handler.locally_owned_dofs(),
+                                    locally_relevant_dofs);
+  dealii::DoFTools::make_hanging_node_constraints(_coarse_dof_handler,
+                                                  _coarse_affine_constraints);
+  _coarse_affine_constraints.close();
+
+  _coarse_thermal_operator->reinit(_coarse_dof_handler,
+                                   _coarse_affine_constraints,
+                                   _coarse_q_collection);
+  _coarse_thermal_operator->set_material_deposition_orientation(deposition_cos,
+                                                                deposition_sin);
+  _coarse_thermal_operator->compute_inverse_mass_matrix(
+      _coarse_dof_handler, _coarse_affine_constraints);
+  _coarse_thermal_operator->get_state_from_material_properties();
+
+  _transfer.reinit(fine_dof_handler, _coarse_dof_handler,
+                   fine_affine_constraints, _coarse_affine_constraints);
+
+  // Store the mass matrix of the fine level
+  _fine_mass_matrix = *_fine_thermal_operator->get_inverse_mass_matrix();
+  unsigned int const local_size = _fine_mass_matrix.locally_owned_size();
+  for (unsigned int i = 0; i < local_size; ++i)
+    _fine_mass_matrix.local_element(i) =
+        1. / _fine_mass_matrix.local_element(i);
+
+  _fine_thermal_operator->initialize_dof_vector(_fine_residual);
+  _coarse_thermal_operator->initialize_dof_vector(_coarse_residual);
+  _coarse_thermal_operator->initialize_dof_vector(_coarse_correction);
+  _coarse_thermal_operator->initialize_dof_vector(_coarse_linearization_point);
+  _fine_thermal_operator->initialize_dof_vector(
+      _fine_unit_diagonal->get_vector());
+  _fine_unit_diagonal->get_vector() = 1.;
+  _coarse_thermal_operator->initialize_dof_vector(
+      _coarse_unit_diagonal->get_vector());
+  _coarse_unit_diagonal->get_vector() = 1.;
+
+  // The operators have changed, the smoothers need to be rebuilt.
+  _smoothers_up_to_date = false;
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename QuadratureType>
+typename ThermalMultigridPreconditioner<
+    dim, n_materials, p_order, MaterialStates,
+    QuadratureType>::Smoother::AdditionalData
+ThermalMultigridPreconditioner<dim, n_materials, p_order, MaterialStates,
+                               QuadratureType>::
+    chebyshev_data(
+        unsigned int const degree, double const smoothing_range,
+        std::shared_ptr<dealii::DiagonalMatrix<LA_Vector>> const &unit_diagonal)
+        const
+{
+  typename Smoother::AdditionalData data;
+  data.degree = degree;
+  data.smoothing_range = smoothing_range;
+  data.eig_cg_n_iterations = 10;
+  // The operator is not symmetric in the Euclidean inner product, so we use
+  // the power iteration instead of the Lanczos iteration to estimate the
+  // largest eigenvalue.
+  data.eigenvalue_algorithm =
+      Smoother::AdditionalData::EigenvalueAlgorithm::power_iteration;
+  data.preconditioner = unit_diagonal;
+
+  return data;
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename QuadratureType>
+void ThermalMultigridPreconditioner<dim, n_materials, p_order, MaterialStates,
+                                    QuadratureType>::
+    update(ImplicitOperator<dim, dealii::MemorySpace::Host> const
+               &fine_operator)
+{
+  if ((&fine_operator != _fine_operator) ||
+      (fine_operator.get_tau() != _smoothers_tau))
+    _smoothers_up_to_date = false;
+  _fine_operator = &fine_operator;
+
+  // Linearize the coarse operator around the interpolation of the fine
+  // linearization point.
+  _transfer.interpolate(_coarse_linearization_point,
+                        fine_operator.get_linearization_point());
+  _coarse_operator->set_tau(fine_operator.get_tau());
+  _coarse_operator->set_linearization_point(_coarse_linearization_point);
+
+  // The smoothers keep a reference to the operators, so they use the new
+  // linearization point without being rebuilt. Rebuilding them would rerun the
+  // estimation of the largest eigenvalue, which is done during the first
+  // vmult() after initialize(). The small change of the spectrum due to the new
+  // linearization point is covered by the safety factor of the estimate.
+  if (_smoothers_up_to_date)
+    return;
+
+  _fine_smoother.initialize(
+      fine_operator,
+      chebyshev_data(_smoother_degree, 20., _fine_unit_diagonal));
+  // The coarse level is "solved" using Chebyshev iterations of higher degree
+  // over a wider part of the spectrum.
+  _coarse_solver.initialize(
+      *_coarse_operator,
+      chebyshev_data(4 * _smoother_degree, 100., _coarse_unit_diagonal));
+  _smoothers_tau = fine_operator.get_tau();
+  _smoothers_up_to_date = true;
+}
+
+template <int dim, int n_materials, int p_order, typename MaterialStates,
+          typename QuadratureType>
+void ThermalMultigridPreconditioner<dim, n_materials, p_order, MaterialStates,
+                                    QuadratureType>::vmult(LA_Vector &dst,
+                                                           LA_Vector const &src)
+    const
+{
+  ASSERT(_fine_operator != nullptr, "update() has not been called.");
+
+  // Pre-smoothing
+  _fine_smoother.vmult(dst, src);
+
+  // Compute the residual and move it to the coarse level. Since the operators
+  // are scaled by the inverse of the mass matrix, the residual is multiplied by
+  // the fine mass matrix before the restriction and by the inverse of the
+  // coarse mass matrix after the restriction.
+  _fine_operator->vmult(_fine_residual, dst);
+  _fine_residual.sadd(-1., 1., src);
+  _fine_residual.scale(_fine_mass_matrix);
+  _coarse_residual = 0.;
+  _transfer.restrict_and_add(_coarse_residual, _fine_residual);
+  _coarse_residual.scale(*_coarse_thermal_operator->get_inverse_mass_matrix());
+
+  // Coarse correction
+  _coarse_solver.vmult(_coarse_correction, _coarse_residual);
+  _transfer.prolongate_and_add(dst, _coarse_correction);
+
+  // Post-smoothing
+  _fine_smoother.step(dst, src);
+}
+} // namespace adamantine
+
+#endif
@@ -6,31 +6,55 @@
 #define THERMAL_OPERATOR_HH
 
 #include <Boundary.hh>
+#include <CubeHeatSource.hh>
+#include <ElectronBeamHeatSource.hh>
+#include <GoldakHeatSource.hh>
 #include <HeatSource.hh>
 #include <MaterialProperty.hh>
 #include <MaterialStates.hh>
 #include <ThermalOperatorBase.hh>
 
 #include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/matrix_free/matrix_free.h>
 
+#include <algorithm>
+
 namespace adamantine
 {
 /**
  * This class is the operator associated with the heat equation, i.e., vmult
- * performs \f$ dst = -\nabla k \nabla src \f$.
+ * performs \f$ dst = -\nabla k \nabla src \f$. The cell and face integrals
+ * are evaluated with the floating point type @p Number. When @p Number is
+ * float, the vectors, the inverse of the mass matrix, and the time integration
+ * stay in double precision, only the operator evaluation is done in single
+ * precision.
  */
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType,
+          typename Number = double>
 class ThermalOperator final : public ThermalOperatorBase<dim, MemorySpaceType>
 {
 public:
+  /**
+   * Constructor. If @p coefficient_cache_tolerance is positive, the material
+   * coefficients at each quadrature point are cached and they are only
+   * recomputed when the temperature has changed by more than
+   * @p coefficient_cache_tolerance or when it reaches the solidus. If
+   * @p enthalpy_formulation is true, the operator is not divided by
+   * \f$ \rho C_p \f$, i.e., vmult computes the time derivative of the
+   * volumetric enthalpy while @p src is still the temperature.
+   */
   ThermalOperator(
       MPI_Comm const &communicator, Boundary const &boundary,
       MaterialProperty<dim, n_materials, p_order, MaterialStates,
                        MemorySpaceType> &material_properties,
-      std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources);
+      std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources,
+      double coefficient_cache_tolerance = 0.,
+      bool enthalpy_formulation = false);
 
   /**
    * Associate the AffineConstraints<double> and the MatrixFree objects to the
@@ -41,7 +65,10 @@ public:
               dealii::hp::QCollection<1> const &quad) override;
 
   /**
-   * Compute the inverse of the mass matrix.
+   * Compute the inverse of the mass matrix. The mass matrix is lumped using the
+   * Gauss-Lobatto quadrature registered in the MatrixFree object by reinit(),
+   * so @p dof_handler and @p affine_constraints must be the ones passed to
+   * reinit().
    */
   void compute_inverse_mass_matrix(
       dealii::DoFHandler<dim> const &dof_handler,
@@ -65,12 +92,21 @@ public:
   /**
    * Return a shared pointer to the underlying MatrixFree object.
    */
-  dealii::MatrixFree<dim, double> const &get_matrix_free() const;
+  dealii::MatrixFree<dim, Number> const &get_matrix_free() const;
 
   void vmult(dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
              dealii::LA::distributed::Vector<double, MemorySpaceType> const
                  &src) const override;
 
+  void vmult_frozen_state(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const override;
+
+  void update_state(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const override;
+
   void vmult_add(dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
                  dealii::LA::distributed::Vector<double, MemorySpaceType> const
                      &src) const override;
@@ -93,15 +129,69 @@ public:
 
   void set_time(double t) override;
 
+  void set_multirate_dof_periods(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const
+          &dof_periods) override;
+
+  void set_multirate_micro_step(unsigned int micro_step) override;
+
+  void low_storage_rk_stage(
+      double factor_solution, double factor_ai,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const
+          &current_ri,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &vec_ki,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &next_ri)
+      const override;
+
 private:
+  /**
+   * Copy the powder ratio and the material id of @p cell to the lane @p lane
+   * of all the quadrature points of the face batch @p face.
+   */
+  void set_face_state(
+      unsigned int face, unsigned int lane,
+      typename dealii::Triangulation<dim>::active_cell_iterator const &cell);
+
+  /**
+   * Set the solidus, the liquidus, the latent heat, and the inverse of the
+   * melting range of each cell or face batch given its material ids.
+   */
+  void set_material_constants(
+      dealii::Table<2, std::array<dealii::types::material_id,
+                                  dealii::VectorizedArray<Number>::size()>>
+          const &material_id,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> &solidus,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> &liquidus,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> &latent_heat,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> &inv_melting_range)
+      const;
+
+  /**
+   * Set the boundary type and the temperatures at infinity of each face batch.
+   * The face batches that are not at the boundary of the activated domain are
+   * marked as adiabatic so that face_local_apply can skip them.
+   */
+  void set_face_boundary_data();
+
+  /**
+   * Return the liquid ratio given the temperature and the melting range of the
+   * material.
+   */
+  dealii::VectorizedArray<Number> compute_liquid_ratio(
+      dealii::VectorizedArray<Number> const &temperature,
+      dealii::VectorizedArray<Number> const &solidus,
+      dealii::VectorizedArray<Number> const &liquidus,
+      dealii::VectorizedArray<Number> const &inv_melting_range) const;
+
   /**
    * Update the ratios of the material state.
    * @note The input variables are not used when the only valid state is solid.
    */
   void update_state_ratios(
       [[maybe_unused]] unsigned int cell, [[maybe_unused]] unsigned int q,
-      [[maybe_unused]] dealii::VectorizedArray<double> temperature,
-      std::array<dealii::VectorizedArray<double>,
+      [[maybe_unused]] dealii::VectorizedArray<Number> temperature,
+      std::array<dealii::VectorizedArray<Number>,
                  MaterialStates::n_material_states> &state_ratios) const;
 
   /**
@@ -110,27 +200,71 @@ private:
    */
   void update_face_state_ratios(
       [[maybe_unused]] unsigned int face, [[maybe_unused]] unsigned int q,
-      [[maybe_unused]] dealii::VectorizedArray<double> temperature,
-      std::array<dealii::VectorizedArray<double>,
+      [[maybe_unused]] dealii::VectorizedArray<Number> temperature,
+      std::array<dealii::VectorizedArray<Number>,
                  MaterialStates::n_material_states> &state_ratios) const;
   /**
    * Return the value of \f$ \frac{1}{\rho C_p} \f$ for a given matrix-free
    * cell/face and quadrature point.
    */
-  dealii::VectorizedArray<double> get_inv_rho_cp(
+  dealii::VectorizedArray<Number> get_inv_rho_cp(
       std::array<dealii::types::material_id,
-                 dealii::VectorizedArray<double>::size()> const &material_id,
-      std::array<dealii::VectorizedArray<double>,
+                 dealii::VectorizedArray<Number>::size()> const &material_id,
+      std::array<dealii::VectorizedArray<Number>,
                  MaterialStates::n_material_states> const &state_ratios,
-      dealii::VectorizedArray<double> const &temperature,
-      dealii::AlignedVector<dealii::VectorizedArray<double>> const
+      dealii::VectorizedArray<Number> const &temperature,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> const
+          &temperature_powers,
+      [[maybe_unused]] dealii::VectorizedArray<Number> const &latent_heat,
+      [[maybe_unused]] dealii::VectorizedArray<Number> const &inv_melting_range)
+      const;
+
+  /**
+   * Return the thermal conductivity tensor, rotated by the deposition angle,
+   * for a given matrix-free cell and quadrature point.
+   */
+  dealii::Tensor<2, dim, dealii::VectorizedArray<Number>>
+  get_thermal_conductivity(
+      unsigned int cell, unsigned int q,
+      std::array<dealii::types::material_id,
+                 dealii::VectorizedArray<Number>::size()> const &material_id,
+      std::array<dealii::VectorizedArray<Number>,
+                 MaterialStates::n_material_states> const &state_ratios,
+      dealii::VectorizedArray<Number> const &temperature,
+      dealii::AlignedVector<dealii::VectorizedArray<Number>> const
           &temperature_powers) const;
 
+  /**
+   * Size the coefficient cache and mark all its entries as out of date. The
+   * cache is left empty if the coefficient caching is disabled.
+   */
+  void reset_coefficient_cache();
+
+  /**
+   * Return true if the cached coefficients of a given matrix-free cell and
+   * quadrature point can be used at @p temperature.
+   */
+  bool
+  use_cached_coefficients(unsigned int cell, unsigned int q,
+                          dealii::VectorizedArray<Number> const &temperature)
+      const;
+
+  /**
+   * Store the coefficients of a given matrix-free cell and quadrature point
+   * computed at @p temperature.
+   */
+  void update_coefficient_cache(
+      unsigned int cell, unsigned int q,
+      dealii::VectorizedArray<Number> const &temperature,
+      dealii::VectorizedArray<Number> const &inv_rho_cp,
+      dealii::Tensor<2, dim, dealii::VectorizedArray<Number>> const
+          &thermal_conductivity) const;
+
   /**
    * Apply the operator on a given set of quadrature points inside each cell.
    */
   void cell_local_apply(
-      dealii::MatrixFree<dim, double> const &data,
+      dealii::MatrixFree<dim, Number> const &data,
       dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
       dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
       std::pair<unsigned int, unsigned int> const &cell_range) const;
@@ -139,7 +273,7 @@ private:
    * Apply the operator on a given set of quadrature points on each face.
    */
   void face_local_apply(
-      dealii::MatrixFree<dim, double> const &data,
+      dealii::MatrixFree<dim, Number> const &data,
       dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
       dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
       std::pair<unsigned int, unsigned int> const &face_range) const;
@@ -148,7 +282,7 @@ private:
    * Apply the mass operator on a given set of quadrature points.
    */
   void cell_local_mass(
-      dealii::MatrixFree<dim, double> const &data,
+      dealii::MatrixFree<dim, Number> const &data,
       dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
       dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
       std::pair<unsigned int, unsigned int> const &cell_range) const;
@@ -166,6 +300,16 @@ private:
    * Flag set to true if at least one heat source is on at the current time.
    */
   bool _heat_sources_on = true;
+  /**
+   * Maximum change of temperature before the cached coefficients are
+   * recomputed. The coefficients are not cached if the tolerance is zero.
+   */
+  double const _coefficient_cache_tolerance;
+  /**
+   * Flag set to true if the operator computes the time derivative of the
+   * enthalpy instead of the time derivative of the temperature.
+   */
+  bool const _enthalpy_formulation;
   /**
    * Boundary ids associated to the domain.
    */
@@ -173,11 +317,11 @@ private:
   /**
    * Data to configure the MatrixFree object.
    */
-  typename dealii::MatrixFree<dim, double>::AdditionalData _matrix_free_data;
+  typename dealii::MatrixFree<dim, Number>::AdditionalData _matrix_free_data;
   /**
    * Table of thermal conductivity coefficient.
    */
-  dealii::Table<2, dealii::VectorizedArray<double>> _thermal_conductivity;
+  dealii::Table<2, dealii::VectorizedArray<Number>> _thermal_conductivity;
   /**
    * Material properties associated with the domain.
    */
@@ -187,10 +331,19 @@ private:
    * Vector of heat sources.
    */
   std::vector<std::shared_ptr<HeatSource<dim>>> _heat_sources;
+  /**
+   * Heat sources that are on at the current time, sorted by type. The type of
+   * the heat sources is resolved once in set_time() so that cell_local_apply()
+   * evaluates each source without any virtual call per quadrature point.
+   */
+  std::vector<GoldakHeatSource<dim> const *> _goldak_heat_sources;
+  std::vector<ElectronBeamHeatSource<dim> const *> _electron_beam_heat_sources;
+  std::vector<CubeHeatSource<dim> const *> _cube_heat_sources;
+  std::vector<HeatSource<dim> const *> _other_heat_sources;
   /**
    * Underlying MatrixFree object.
    */
-  dealii::MatrixFree<dim, double> _matrix_free;
+  dealii::MatrixFree<dim, Number> _matrix_free;
   /**
    * Non-owning pointer to the AffineConstraints from ThermalPhysics.
    */
@@ -203,90 +356,195 @@ private:
   std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
       _inverse_mass_matrix;
   /**
-   * Map between the cell iterator and the position in _inv_rho_cp table.
+   * Map between the active cell index and the position (cell batch, lane) of
+   * the cell in the matrix-free tables.
    */
-  std::map<typename dealii::DoFHandler<dim>::cell_iterator,
-           std::pair<unsigned int, unsigned int>>
-      _cell_it_to_mf_cell_map;
+  std::vector<std::pair<unsigned int, unsigned int>> _cell_index_to_mf_cell_map;
   /**
    * Table of the powder fraction inside cells; mutable so that it can be
    * changed in cell_local_apply which is const.
    */
-  mutable dealii::Table<2, dealii::VectorizedArray<double>> _liquid_ratio;
+  mutable dealii::Table<2, dealii::VectorizedArray<Number>> _liquid_ratio;
   /**
    * Table of the powder fraction inside cells; mutable so that it can be
    * changed in cell_local_apply which is const.
    */
-  mutable dealii::Table<2, dealii::VectorizedArray<double>> _powder_ratio;
+  mutable dealii::Table<2, dealii::VectorizedArray<Number>> _powder_ratio;
   /**
    * Table of the powder fraction on faces; mutable so that it can be changed in
    * face_local_apply which is const.
    */
-  mutable dealii::Table<2, dealii::VectorizedArray<double>> _face_powder_ratio;
+  mutable dealii::Table<2, dealii::VectorizedArray<Number>> _face_powder_ratio;
+  /**
+   * Flag set to true while vmult_frozen_state is applied. The state ratios are
+   * then computed but not written to the tables above.
+   */
+  mutable bool _frozen_state = false;
   /**
    * Table of the material index inside cells; mutable so that it can be changed
    * in cell_local_apply which is const.
    */
   mutable dealii::Table<2, std::array<dealii::types::material_id,
-                                      dealii::VectorizedArray<double>::size()>>
+                                      dealii::VectorizedArray<Number>::size()>>
       _material_id;
   /**
    * Table of the material index on faces; mutable so that it can be changed in
    * face_local_apply which is const.
    */
   mutable dealii::Table<2, std::array<dealii::types::material_id,
-                                      dealii::VectorizedArray<double>::size()>>
+                                      dealii::VectorizedArray<Number>::size()>>
       _face_material_id;
+  /**
+   * Solidus of the material of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _solidus;
+  /**
+   * Liquidus of the material of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _liquidus;
+  /**
+   * Latent heat of the material of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _latent_heat;
+  /**
+   * Inverse of the difference between the liquidus and the solidus of the
+   * material of each cell batch. It is zero if the liquidus is equal to the
+   * solidus.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _inv_melting_range;
+  /**
+   * Solidus of the material of each face batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _face_solidus;
+  /**
+   * Liquidus of the material of each face batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _face_liquidus;
+  /**
+   * Latent heat of the material of each face batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> _face_latent_heat;
+  /**
+   * Inverse of the difference between the liquidus and the solidus of the
+   * material of each face batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>>
+      _face_inv_melting_range;
+  /**
+   * Boundary type of each face batch.
+   */
+  std::vector<BoundaryType> _face_boundary_type;
+  /**
+   * Convection temperature at infinity of the material of each face batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>>
+      _face_convection_temperature_infty;
+  /**
+   * Radiation temperature at infinity of the material of each face batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<Number>>
+      _face_radiation_temperature_infty;
   /**
    * Table of the material deposition cosine angles.
    */
-  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_cos;
+  dealii::Table<2, dealii::VectorizedArray<Number>> _deposition_cos;
   /**
    * Table of the material deposition cosine angles.
    */
-  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_sin;
+  dealii::Table<2, dealii::VectorizedArray<Number>> _deposition_sin;
+  /**
+   * Cached values of \f$ \frac{1}{\rho C_p} \f$; mutable so that it can be
+   * changed in cell_local_apply which is const.
+   */
+  mutable dealii::Table<2, dealii::VectorizedArray<Number>> _cached_inv_rho_cp;
+  /**
+   * Cached rotated thermal conductivity tensors; mutable so that it can be
+   * changed in cell_local_apply which is const.
+   */
+  mutable dealii::Table<2,
+                        dealii::Tensor<2, dim, dealii::VectorizedArray<Number>>>
+      _cached_thermal_conductivity;
+  /**
+   * Lower bound of the temperature range in which the cached coefficients are
+   * used. NaN marks an out-of-date entry.
+   */
+  mutable dealii::Table<2, dealii::VectorizedArray<Number>>
+      _cached_temperature_min;
+  /**
+   * Upper bound (excluded) of the temperature range in which the cached
+   * coefficients are used.
+   */
+  mutable dealii::Table<2, dealii::VectorizedArray<Number>>
+      _cached_temperature_max;
+  /**
+   * Locally owned constrained DoFs of _matrix_free sorted in increasing order.
+   */
+  std::vector<unsigned int> _sorted_constrained_dofs;
+  /**
+   * Bounding box of each cell batch.
+   */
+  std::vector<dealii::BoundingBox<dim>> _cell_batch_bounding_boxes;
+  /**
+   * Flag set to true if the cell batch intersects the support of at least one
+   * heat source at the current time.
+   */
+  std::vector<bool> _cell_batch_heat_sources_on;
+  /**
+   * Number of multirate micro steps between two evaluations of each cell batch.
+   * The vector is empty if all the cell batches are evaluated.
+   */
+  std::vector<unsigned int> _cell_batch_periods;
+  /**
+   * Number of multirate micro steps between two evaluations of each face batch.
+   * The vector is empty if all the face batches are evaluated.
+   */
+  std::vector<unsigned int> _face_batch_periods;
+  /**
+   * Current multirate micro step.
+   */
+  unsigned int _micro_step = 0;
 };
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 inline dealii::types::global_dof_index
 ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
-                MemorySpaceType>::m() const
+                MemorySpaceType, Number>::m() const
 {
   return _matrix_free.get_vector_partitioner()->size();
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 inline dealii::types::global_dof_index
 ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
-                MemorySpaceType>::n() const
+                MemorySpaceType, Number>::n() const
 {
   return _matrix_free.get_vector_partitioner()->size();
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 inline std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
 ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
-                MemorySpaceType>::get_inverse_mass_matrix() const
+                MemorySpaceType, Number>::get_inverse_mass_matrix() const
 {
   return _inverse_mass_matrix;
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
-inline dealii::MatrixFree<dim, double> const &
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+inline dealii::MatrixFree<dim, Number> const &
 ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
-                MemorySpaceType>::get_matrix_free() const
+                MemorySpaceType, Number>::get_matrix_free() const
 {
   return _matrix_free;
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 inline void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                            MaterialStates, MemorySpaceType>::
+                            MaterialStates, MemorySpaceType, Number>::
     initialize_dof_vector(
         dealii::LA::distributed::Vector<double, MemorySpaceType> &vector) const
 {
@@ -294,18 +552,61 @@ inline void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 inline void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                            MaterialStates, MemorySpaceType>::set_time(double t)
+                            MaterialStates, MemorySpaceType,
+                            Number>::set_time(double t)
 {
   _heat_sources_on = false;
+  _goldak_heat_sources.clear();
+  _electron_beam_heat_sources.clear();
+  _cube_heat_sources.clear();
+  _other_heat_sources.clear();
+  std::vector<dealii::BoundingBox<dim>> supports;
   for (auto &beam : _heat_sources)
   {
     beam->update_time(t);
     if (beam->is_source_on())
+    {
       _heat_sources_on = true;
+      supports.push_back(beam->get_support_bounding_box());
+      if (auto goldak = dynamic_cast<GoldakHeatSource<dim> const *>(beam.get()))
+        _goldak_heat_sources.push_back(goldak);
+      else if (auto electron_beam =
+                   dynamic_cast<ElectronBeamHeatSource<dim> const *>(
+                       beam.get()))
+        _electron_beam_heat_sources.push_back(electron_beam);
+      else if (auto cube =
+                   dynamic_cast<CubeHeatSource<dim> const *>(beam.get()))
+        _cube_heat_sources.push_back(cube);
+      else
+        _other_heat_sources.push_back(beam.get());
+    }
+  }
+
+  // Only the cell batches that intersect the support of a heat source need to
+  // evaluate the heat sources.
+  unsigned int const n_cells = _cell_batch_bounding_boxes.size();
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+  {
+    _cell_batch_heat_sources_on[cell] = std::any_of(
+        supports.begin(), supports.end(),
+        [&](dealii::BoundingBox<dim> const &support)
+        {
+          return _cell_batch_bounding_boxes[cell].get_neighbor_type(support) !=
+                 dealii::NeighborType::not_neighbors;
+        });
   }
 }
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+inline void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                            MaterialStates, MemorySpaceType, Number>::
+    set_multirate_micro_step(unsigned int micro_step)
+{
+  _micro_step = micro_step;
+}
 } // namespace adamantine
 
 #endif
@@ -10,6 +10,7 @@
 
 #include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/types.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/dofs/dof_tools.h>
@@ -18,21 +19,27 @@
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 
+#include <algorithm>
+#include <limits>
 #include <type_traits>
 
 namespace adamantine
 {
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
-                MemorySpaceType>::
+                MemorySpaceType, Number>::
     ThermalOperator(
         MPI_Comm const &communicator, Boundary const &boundary,
         MaterialProperty<dim, n_materials, p_order, MaterialStates,
                          MemorySpaceType> &material_properties,
-        std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources)
-    : _communicator(communicator), _boundary(boundary),
+        std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources,
+        double coefficient_cache_tolerance, bool enthalpy_formulation)
+    : _communicator(communicator),
+      _coefficient_cache_tolerance(coefficient_cache_tolerance),
+      _enthalpy_formulation(enthalpy_formulation),
+      _boundary(boundary),
       _material_properties(material_properties), _heat_sources(heat_sources),
       _inverse_mass_matrix(
           new dealii::LA::distributed::Vector<double, MemorySpaceType>())
@@ -41,8 +48,16 @@ ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
       _boundary.get_boundary_ids(BoundaryType::adiabatic).size() ==
       _boundary.n_boundary_ids();
 
+  // When several threads are available, the cell and face loops are split
+  // into tasks. The tasks write the state ratios and the coefficient cache of
+  // their own cell and face batches only and the heat sources are only read
+  // during the loops, so the loops are thread-safe.
+  using AdditionalData =
+      typename dealii::MatrixFree<dim, Number>::AdditionalData;
   _matrix_free_data.tasks_parallel_scheme =
-      dealii::MatrixFree<dim, double>::AdditionalData::partition_color;
+      dealii::MultithreadInfo::n_threads() > 1
+          ? AdditionalData::partition_partition
+          : AdditionalData::none;
   _matrix_free_data.mapping_update_flags =
       dealii::update_values | dealii::update_gradients |
       dealii::update_JxW_values | dealii::update_quadrature_points;
@@ -53,36 +68,79 @@ ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     reinit(dealii::DoFHandler<dim> const &dof_handler,
            dealii::AffineConstraints<double> const &affine_constraints,
            dealii::hp::QCollection<1> const &q_collection)
 {
-  _matrix_free.reinit(dealii::StaticMappingQ1<dim>::mapping, dof_handler,
-                      affine_constraints, q_collection, _matrix_free_data);
+  // The second quadrature is the Gauss-Lobatto quadrature used to lump the
+  // mass matrix. Registering it here lets compute_inverse_mass_matrix reuse the
+  // DoF and mapping data instead of building a second MatrixFree object.
+  dealii::hp::QCollection<1> mass_q_collection;
+  mass_q_collection.push_back(dealii::QGaussLobatto<1>(fe_degree + 1));
+  mass_q_collection.push_back(dealii::QGaussLobatto<1>(2));
+  std::vector<dealii::DoFHandler<dim> const *> dof_handlers = {&dof_handler};
+  std::vector<dealii::AffineConstraints<double> const *> constraints = {
+      &affine_constraints};
+  std::vector<dealii::hp::QCollection<1>> q_collections = {q_collection,
+                                                           mass_q_collection};
+  _matrix_free.reinit(dealii::StaticMappingQ1<dim>::mapping, dof_handlers,
+                      constraints, q_collections, _matrix_free_data);
   _affine_constraints = &affine_constraints;
 
   // Compute mapping between DoFHandler cells and the MatrixFree cells
-  _cell_it_to_mf_cell_map.clear();
+  _cell_index_to_mf_cell_map.assign(
+      dof_handler.get_triangulation().n_active_cells(),
+      std::make_pair(dealii::numbers::invalid_unsigned_int,
+                     dealii::numbers::invalid_unsigned_int));
   unsigned int const n_cells = _matrix_free.n_cell_batches();
   for (unsigned int cell = 0; cell < n_cells; ++cell)
     for (unsigned int i = 0;
          i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
     {
-      typename dealii::DoFHandler<dim>::cell_iterator cell_it =
-          _matrix_free.get_cell_iterator(cell, i);
-      _cell_it_to_mf_cell_map[cell_it] = std::make_pair(cell, i);
+      _cell_index_to_mf_cell_map[_matrix_free.get_cell_iterator(cell, i)
+                                     ->active_cell_index()] =
+          std::make_pair(cell, i);
     }
+
+  // Compute the bounding box of each cell batch. The quadrature points of a
+  // cell are inside the bounding box of its vertices because we use a linear
+  // mapping.
+  _cell_batch_bounding_boxes.resize(n_cells);
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+  {
+    _cell_batch_bounding_boxes[cell] =
+        _matrix_free.get_cell_iterator(cell, 0)->bounding_box();
+    for (unsigned int i = 1;
+         i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+      _cell_batch_bounding_boxes[cell].merge_with(
+          _matrix_free.get_cell_iterator(cell, i)->bounding_box());
+  }
+  // The heat sources are evaluated everywhere until set_time is called.
+  _cell_batch_heat_sources_on.assign(n_cells, true);
+
+  // The cell batches have changed, the multirate periods need to be set again.
+  _cell_batch_periods.clear();
+  _face_batch_periods.clear();
+
+  _sorted_constrained_dofs = _matrix_free.get_constrained_dofs();
+  std::sort(_sorted_constrained_dofs.begin(), _sorted_constrained_dofs.end());
+
+  // The coefficient cache is sized in get_state_from_material_properties.
+  _cached_inv_rho_cp.reinit(0, 0);
+  _cached_thermal_conductivity.reinit(0, 0);
+  _cached_temperature_min.reinit(0, 0);
+  _cached_temperature_max.reinit(0, 0);
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     cell_local_mass(
-        dealii::MatrixFree<dim, double> const &data,
+        dealii::MatrixFree<dim, Number> const &data,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
         dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
         std::pair<unsigned int, unsigned int> const &cell_range) const
@@ -90,7 +148,9 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
   // Get the subrange of cells associated with the fe index 0
   std::pair<unsigned int, unsigned int> cell_subrange =
       data.create_cell_subrange_hp_by_index(cell_range, 0);
-  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(data);
+  // Use the Gauss-Lobatto quadrature to obtain a diagonal mass matrix
+  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> fe_eval(
+      data, 0, 1);
 
   // Loop over the "cells". Note that we don't really work on a cell but on a
   // set of quadrature point.
@@ -115,40 +175,30 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     compute_inverse_mass_matrix(
         dealii::DoFHandler<dim> const &dof_handler,
         dealii::AffineConstraints<double> const &affine_constraints)
 {
-  // Compute the inverse of the mass matrix
-  dealii::hp::QCollection<dim> mass_q_collection;
-  mass_q_collection.push_back(dealii::QGaussLobatto<dim>(fe_degree + 1));
-  mass_q_collection.push_back(dealii::QGaussLobatto<dim>(2));
-
-  typename dealii::MatrixFree<dim, double>::AdditionalData
-      mass_matrix_free_data;
-  mass_matrix_free_data.tasks_parallel_scheme =
-      dealii::MatrixFree<dim, double>::AdditionalData::partition_color;
-  mass_matrix_free_data.mapping_update_flags =
-      dealii::update_values | dealii::update_JxW_values;
+  ASSERT(&_matrix_free.get_dof_handler() == &dof_handler,
+         "The DoFHandler is different from the one used in reinit.");
+  ASSERT(_affine_constraints == &affine_constraints,
+         "The AffineConstraints are different from the ones used in reinit.");
 
-  dealii::MatrixFree<dim, double> mass_matrix_free;
-  mass_matrix_free.reinit(dealii::StaticMappingQ1<dim>::mapping, dof_handler,
-                          affine_constraints, mass_q_collection,
-                          mass_matrix_free_data);
-  mass_matrix_free.initialize_dof_vector(*_inverse_mass_matrix);
+  // Compute the inverse of the mass matrix
+  _matrix_free.initialize_dof_vector(*_inverse_mass_matrix);
   dealii::LA::distributed::Vector<double, MemorySpaceType> unit_vector;
-  mass_matrix_free.initialize_dof_vector(unit_vector);
+  _matrix_free.initialize_dof_vector(unit_vector);
   unit_vector = 1.;
-  mass_matrix_free.cell_loop(&ThermalOperator::cell_local_mass, this,
-                             *_inverse_mass_matrix, unit_vector);
+  _matrix_free.cell_loop(&ThermalOperator::cell_local_mass, this,
+                         *_inverse_mass_matrix, unit_vector);
   // Because cell_loop resolves the constraints, the constrained dofs are not
   // called they stay at zero. Thus, we need to force the value on the
   // constrained dofs by hand.
   std::vector<unsigned int> const &constrained_dofs =
-      mass_matrix_free.get_constrained_dofs();
+      _matrix_free.get_constrained_dofs();
   for (auto &dof : constrained_dofs)
     _inverse_mass_matrix->local_element(dof) += 1.;
 
@@ -163,19 +213,37 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::clear()
+                     MaterialStates, MemorySpaceType, Number>::clear()
 {
-  _cell_it_to_mf_cell_map.clear();
+  _cell_index_to_mf_cell_map.clear();
+  _cell_batch_bounding_boxes.clear();
+  _cell_batch_heat_sources_on.clear();
+  _sorted_constrained_dofs.clear();
+  _cached_inv_rho_cp.reinit(0, 0);
+  _cached_thermal_conductivity.reinit(0, 0);
+  _cached_temperature_min.reinit(0, 0);
+  _cached_temperature_max.reinit(0, 0);
+  _solidus.clear();
+  _liquidus.clear();
+  _latent_heat.clear();
+  _inv_melting_range.clear();
+  _face_solidus.clear();
+  _face_liquidus.clear();
+  _face_latent_heat.clear();
+  _face_inv_melting_range.clear();
+  _face_boundary_type.clear();
+  _face_convection_temperature_infty.clear();
+  _face_radiation_temperature_infty.clear();
   _matrix_free.clear();
   _inverse_mass_matrix->reinit(0);
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     vmult(dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
           dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
         const
@@ -185,9 +253,97 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
+    vmult_frozen_state(
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+        const
+{
+  _frozen_state = true;
+  vmult(dst, src);
+  _frozen_state = false;
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
+    update_state(dealii::LA::distributed::Vector<double, MemorySpaceType> const
+                     &src) const
+{
+  if constexpr (!std::is_same_v<MaterialStates, Solid>)
+  {
+    bool const ghosted = src.has_ghost_elements();
+    if (!ghosted)
+      src.update_ghost_values();
+
+    // Only the values at the quadrature points are needed to update the
+    // state ratios of the cells using FE_Q.
+    dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> fe_eval(
+        _matrix_free);
+    std::array<dealii::VectorizedArray<Number>,
+               MaterialStates::n_material_states>
+        state_ratios;
+    unsigned int const n_cells = _matrix_free.n_cell_batches();
+    for (unsigned int cell = 0; cell < n_cells; ++cell)
+    {
+      if (_matrix_free.get_cell_range_category({cell, cell + 1}) != 0)
+        continue;
+
+      fe_eval.reinit(cell);
+      fe_eval.read_dof_values(src);
+      fe_eval.evaluate(dealii::EvaluationFlags::values);
+      for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+        update_state_ratios(cell, q, fe_eval.get_value(q), state_ratios);
+    }
+
+    // The powder ratio of the faces is only used by the faces that are
+    // integrated in face_local_apply.
+    if (!_adiabatic_only_bc)
+    {
+      std::array<dealii::VectorizedArray<Number>,
+                 MaterialStates::n_material_states>
+          face_state_ratios;
+      dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, Number>
+          interior_fe_face_eval(_matrix_free, true);
+      dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, Number>
+          exterior_fe_face_eval(_matrix_free, false);
+      // The faces that are not at the boundary of the activated domain are
+      // marked as adiabatic in set_face_boundary_data.
+      unsigned int const n_faces = _face_boundary_type.size();
+      for (unsigned int face = 0; face < n_faces; ++face)
+      {
+        BoundaryType const boundary_type = _face_boundary_type[face];
+        if (!(boundary_type & BoundaryType::convective) &&
+            !(boundary_type & BoundaryType::radiative))
+          continue;
+
+        // The FE_Q cell is on the interior side of the face if its fe index
+        // comes first, as in face_local_apply.
+        auto &fe_face_eval =
+            _matrix_free.get_face_range_category({face, face + 1}).first == 0
+                ? interior_fe_face_eval
+                : exterior_fe_face_eval;
+        fe_face_eval.reinit(face);
+        fe_face_eval.read_dof_values(src);
+        fe_face_eval.evaluate(dealii::EvaluationFlags::values);
+        for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
+          update_face_state_ratios(face, q, fe_face_eval.get_value(q),
+                                   face_state_ratios);
+      }
+    }
+
+    if (!ghosted)
+      src.zero_out_ghost_values();
+  }
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     vmult_add(dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
               dealii::LA::distributed::Vector<double, MemorySpaceType> const
                   &src) const
@@ -224,13 +380,146 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
+    low_storage_rk_stage(
+        double factor_solution, double factor_ai,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> const
+            &current_ri,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &vec_ki,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &next_ri) const
+{
+  auto const &inverse_mass_matrix = *_inverse_mass_matrix;
+
+  // MatrixFree calls operation_before_loop on a range of DoFs before any cell
+  // touching these DoFs is processed. Like in vmult_add, the constrained DoFs
+  // are set to the value of the source since cell_local_apply does not write
+  // them.
+  auto operation_before_loop = [&](unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; ++i)
+      vec_ki.local_element(i) = 0.;
+    for (auto dof = std::lower_bound(_sorted_constrained_dofs.begin(),
+                                     _sorted_constrained_dofs.end(), start);
+         (dof != _sorted_constrained_dofs.end()) && (*dof < end); ++dof)
+      vec_ki.local_element(*dof) = current_ri.local_element(*dof);
+  };
+
+  // MatrixFree calls operation_after_loop on a range of DoFs once all the cells
+  // touching these DoFs have been processed. The DoFs are still in cache, so
+  // the scaling by the inverse of the mass matrix and the update of the
+  // Runge-Kutta registers are done without another pass over the vectors.
+  auto operation_after_loop = [&](unsigned int start, unsigned int end)
+  {
+    for (unsigned int i = start; i < end; ++i)
+    {
+      double const k_i =
+          inverse_mass_matrix.local_element(i) * vec_ki.local_element(i);
+      double const solution_i = solution.local_element(i);
+      vec_ki.local_element(i) = k_i;
+      solution.local_element(i) = solution_i + factor_solution * k_i;
+      next_ri.local_element(i) = solution_i + factor_ai * k_i;
+    }
+  };
+
+  if (_adiabatic_only_bc)
+  {
+    _matrix_free.cell_loop(&ThermalOperator::cell_local_apply, this, vec_ki,
+                           current_ri, operation_before_loop,
+                           operation_after_loop);
+  }
+  else
+  {
+    _matrix_free.loop(&ThermalOperator::cell_local_apply,
+                      &ThermalOperator::face_local_apply,
+                      &ThermalOperator::face_local_apply, this, vec_ki,
+                      current_ri, operation_before_loop, operation_after_loop);
+  }
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
+    set_material_constants(
+        dealii::Table<2, std::array<dealii::types::material_id,
+                                    dealii::VectorizedArray<Number>::size()>>
+            const &material_id,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>> &solidus,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>> &liquidus,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>> &latent_heat,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>>
+            &inv_melting_range) const
+{
+  // The solidus and the liquidus of a material without phase change are set to
+  // the largest double which does not fit in a float.
+  double const number_max =
+      static_cast<double>(std::numeric_limits<Number>::max());
+  auto to_number = [&](double value)
+  { return static_cast<Number>(std::min(value, number_max)); };
+
+  unsigned int const n_batches = material_id.size(0);
+  solidus.resize(n_batches);
+  liquidus.resize(n_batches);
+  latent_heat.resize(n_batches);
+  inv_melting_range.resize(n_batches);
+  if (material_id.size(1) == 0)
+  {
+    return;
+  }
+
+  for (unsigned int batch = 0; batch < n_batches; ++batch)
+    for (unsigned int n = 0; n < dealii::VectorizedArray<Number>::size(); ++n)
+    {
+      // The material is the same at all the quadrature points of a cell or a
+      // face.
+      dealii::types::material_id const id = material_id(batch, 0)[n];
+      double const solidus_n = _material_properties.get(id, Property::solidus);
+      double const liquidus_n =
+          _material_properties.get(id, Property::liquidus);
+      solidus[batch][n] = to_number(solidus_n);
+      liquidus[batch][n] = to_number(liquidus_n);
+      latent_heat[batch][n] =
+          to_number(_material_properties.get(id, Property::latent_heat));
+      inv_melting_range[batch][n] =
+          liquidus_n > solidus_n ? 1. / (liquidus_n - solidus_n) : 0.;
+    }
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+dealii::VectorizedArray<Number>
+ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
+                MemorySpaceType, Number>::
+    compute_liquid_ratio(
+        dealii::VectorizedArray<Number> const &temperature,
+        dealii::VectorizedArray<Number> const &solidus,
+        dealii::VectorizedArray<Number> const &liquidus,
+        dealii::VectorizedArray<Number> const &inv_melting_range) const
+{
+  // The liquid ratio is zero below the solidus, one above the liquidus, and it
+  // increases linearly in between. Clamping the linear function gives both
+  // limits without branching. The comparison with the liquidus is needed when
+  // the solidus and the liquidus are equal.
+  dealii::VectorizedArray<Number> const zero(0.);
+  dealii::VectorizedArray<Number> const one(1.);
+  auto const linear = std::min(
+      std::max((temperature - solidus) * inv_melting_range, zero), one);
+
+  return dealii::compare_and_apply_mask<dealii::SIMDComparison::greater_than>(
+      temperature, liquidus, one, linear);
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
     update_state_ratios(
         [[maybe_unused]] unsigned int cell, [[maybe_unused]] unsigned int q,
-        [[maybe_unused]] dealii::VectorizedArray<double> temperature,
-        std::array<dealii::VectorizedArray<double>,
+        [[maybe_unused]] dealii::VectorizedArray<Number> temperature,
+        std::array<dealii::VectorizedArray<Number>,
                    MaterialStates::n_material_states> &state_ratios) const
 {
   unsigned int constexpr solid =
@@ -239,202 +528,114 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
   {
     state_ratios[solid] = 1.;
   }
-  else if constexpr (std::is_same_v<MaterialStates, SolidLiquid>)
-  {
-    unsigned int constexpr liquid =
-        static_cast<unsigned int>(MaterialStates::State::liquid);
-    // Loop over the vectorized arrays
-    for (unsigned int n = 0; n < temperature.size(); ++n)
-    {
-      // Get the material id at this point
-      dealii::types::material_id const material_id = _material_id(cell, q)[n];
-
-      // Get the material thermodynamic properties
-      double const solidus =
-          _material_properties.get(material_id, Property::solidus);
-      double const liquidus =
-          _material_properties.get(material_id, Property::liquidus);
-
-      // Update the state ratios
-      if (temperature[n] < solidus)
-        state_ratios[liquid][n] = 0.;
-      else if (temperature[n] > liquidus)
-        state_ratios[liquid][n] = 1.;
-      else
-      {
-        state_ratios[liquid][n] =
-            (temperature[n] - solidus) / (liquidus - solidus);
-      }
-      state_ratios[solid][n] = 1. - state_ratios[liquid][n];
-    }
-
-    _liquid_ratio(cell, q) = state_ratios[liquid];
-  }
-  else if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
+  else
   {
     unsigned int constexpr liquid =
         static_cast<unsigned int>(MaterialStates::State::liquid);
-    unsigned int constexpr powder =
-        static_cast<unsigned int>(MaterialStates::State::powder);
-
-    // Loop over the vectorized arrays
-    for (unsigned int n = 0; n < temperature.size(); ++n)
+    state_ratios[liquid] =
+        compute_liquid_ratio(temperature, _solidus[cell], _liquidus[cell],
+                             _inv_melting_range[cell]);
+    if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
     {
-      // Get the material id at this point
-      dealii::types::material_id const material_id = _material_id(cell, q)[n];
-
-      // Get the material thermodynamic properties
-      double const solidus =
-          _material_properties.get(material_id, Property::solidus);
-      double const liquidus =
-          _material_properties.get(material_id, Property::liquidus);
-
-      // Update the state ratios
-      state_ratios[powder] = _powder_ratio(cell, q);
-
-      if (temperature[n] < solidus)
-        state_ratios[liquid][n] = 0.;
-      else if (temperature[n] > liquidus)
-        state_ratios[liquid][n] = 1.;
-      else
-      {
-        state_ratios[liquid][n] =
-            (temperature[n] - solidus) / (liquidus - solidus);
-      }
+      unsigned int constexpr powder =
+          static_cast<unsigned int>(MaterialStates::State::powder);
       // Because the powder can only become liquid, the solid can only
       // become liquid, and the liquid can only become solid, the ratio of
       // powder can only decrease.
-      state_ratios[powder][n] =
-          std::min(1. - state_ratios[liquid][n], state_ratios[powder][n]);
-      state_ratios[solid][n] =
-          1. - state_ratios[liquid][n] - state_ratios[powder][n];
+      state_ratios[powder] =
+          std::min(1. - state_ratios[liquid], _powder_ratio(cell, q));
+      state_ratios[solid] = 1. - state_ratios[liquid] - state_ratios[powder];
+      if (!_frozen_state)
+        _powder_ratio(cell, q) = state_ratios[powder];
+    }
+    else
+    {
+      state_ratios[solid] = 1. - state_ratios[liquid];
     }
 
-    _liquid_ratio(cell, q) = state_ratios[liquid];
-    _powder_ratio(cell, q) = state_ratios[powder];
+    if (!_frozen_state)
+      _liquid_ratio(cell, q) = state_ratios[liquid];
   }
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     update_face_state_ratios(
         [[maybe_unused]] unsigned int face, [[maybe_unused]] unsigned int q,
-        [[maybe_unused]] dealii::VectorizedArray<double> temperature,
-        std::array<dealii::VectorizedArray<double>,
+        [[maybe_unused]] dealii::VectorizedArray<Number> temperature,
+        std::array<dealii::VectorizedArray<Number>,
                    MaterialStates::n_material_states> &face_state_ratios) const
 {
   unsigned int constexpr solid =
       static_cast<unsigned int>(MaterialStates::State::solid);
-
   if constexpr (std::is_same_v<MaterialStates, Solid>)
   {
-    // We just nee to fill state_ratios with 1.
-    for (unsigned int n = 0; n < face_state_ratios[solid].size(); ++n)
-    {
-      face_state_ratios[solid][n] = 1.;
-    }
+    face_state_ratios[solid] = 1.;
   }
-  else if constexpr (std::is_same_v<MaterialStates, SolidLiquid>)
-  {
-    unsigned int constexpr liquid =
-        static_cast<unsigned int>(MaterialStates::State::liquid);
-    // Loop over the vectorized arrays
-    for (unsigned int n = 0; n < temperature.size(); ++n)
-    {
-      // Get the material id at this point
-      dealii::types::material_id const material_id =
-          _face_material_id(face, q)[n];
-
-      // Get the material thermodynamic properties
-      double const solidus =
-          _material_properties.get(material_id, Property::solidus);
-      double const liquidus =
-          _material_properties.get(material_id, Property::liquidus);
-
-      // Update the state ratios
-      if (temperature[n] < solidus)
-        face_state_ratios[liquid][n] = 0.;
-      else if (temperature[n] > liquidus)
-        face_state_ratios[liquid][n] = 1.;
-      else
-      {
-        face_state_ratios[liquid][n] =
-            (temperature[n] - solidus) / (liquidus - solidus);
-      }
-      face_state_ratios[solid][n] = 1. - face_state_ratios[liquid][n];
-    }
-  }
-  else if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
+  else
   {
     unsigned int constexpr liquid =
         static_cast<unsigned int>(MaterialStates::State::liquid);
-    unsigned int constexpr powder =
-        static_cast<unsigned int>(MaterialStates::State::powder);
-
-    // Loop over the vectorized arrays
-    for (unsigned int n = 0; n < temperature.size(); ++n)
+    face_state_ratios[liquid] = compute_liquid_ratio(
+        temperature, _face_solidus[face], _face_liquidus[face],
+        _face_inv_melting_range[face]);
+    if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
     {
-      // Get the material id at this point
-      dealii::types::material_id const material_id =
-          _face_material_id(face, q)[n];
-
-      // Get the material thermodynamic properties
-      double const solidus =
-          _material_properties.get(material_id, Property::solidus);
-      double const liquidus =
-          _material_properties.get(material_id, Property::liquidus);
-
-      // Update the state ratios
-      face_state_ratios[powder] = _face_powder_ratio(face, q);
-
-      if (temperature[n] < solidus)
-        face_state_ratios[liquid][n] = 0.;
-      else if (temperature[n] > liquidus)
-        face_state_ratios[liquid][n] = 1.;
-      else
-      {
-        face_state_ratios[liquid][n] =
-            (temperature[n] - solidus) / (liquidus - solidus);
-      }
+      unsigned int constexpr powder =
+          static_cast<unsigned int>(MaterialStates::State::powder);
       // Because the powder can only become liquid, the solid can only
       // become liquid, and the liquid can only become solid, the ratio of
       // powder can only decrease.
-      face_state_ratios[powder][n] = std::min(1. - face_state_ratios[liquid][n],
-                                              face_state_ratios[powder][n]);
-      face_state_ratios[solid][n] =
-          1. - face_state_ratios[liquid][n] - face_state_ratios[powder][n];
+      face_state_ratios[powder] = std::min(1. - face_state_ratios[liquid],
+                                           _face_powder_ratio(face, q));
+      face_state_ratios[solid] =
+          1. - face_state_ratios[liquid] - face_state_ratios[powder];
+      if (!_frozen_state)
+        _face_powder_ratio(face, q) = face_state_ratios[powder];
+    }
+    else
+    {
+      face_state_ratios[solid] = 1. - face_state_ratios[liquid];
     }
-
-    _face_powder_ratio(face, q) = face_state_ratios[powder];
   }
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
-dealii::VectorizedArray<double>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+dealii::VectorizedArray<Number>
 ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
-                MemorySpaceType>::
+                MemorySpaceType, Number>::
     get_inv_rho_cp(
         std::array<dealii::types::material_id,
-                   dealii::VectorizedArray<double>::size()> const &material_id,
-        std::array<dealii::VectorizedArray<double>,
+                   dealii::VectorizedArray<Number>::size()> const &material_id,
+        std::array<dealii::VectorizedArray<Number>,
                    MaterialStates::n_material_states> const &state_ratios,
-        dealii::VectorizedArray<double> const &temperature,
-        dealii::AlignedVector<dealii::VectorizedArray<double>> const
-            &temperature_powers) const
+        dealii::VectorizedArray<Number> const &temperature,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>> const
+            &temperature_powers,
+        [[maybe_unused]] dealii::VectorizedArray<Number> const &latent_heat,
+        [[maybe_unused]] dealii::VectorizedArray<Number> const
+            &inv_melting_range) const
 {
+  // In the enthalpy formulation, the operator computes the time derivative of
+  // the volumetric enthalpy which does not involve the heat capacity.
+  if (_enthalpy_formulation)
+  {
+    return dealii::VectorizedArray<Number>(1.);
+  }
+
   // Here we need the specific heat (including the latent heat contribution)
   // and the density
 
   // Compute the state-dependent properties
-  dealii::VectorizedArray<double> density =
+  dealii::VectorizedArray<Number> density =
       _material_properties.template compute_material_property<
           use_table, StateProperty::density>(material_id, state_ratios,
                                              temperature, temperature_powers);
 
-  dealii::VectorizedArray<double> specific_heat =
+  dealii::VectorizedArray<Number> specific_heat =
       _material_properties.template compute_material_property<
           use_table, StateProperty::specific_heat>(
           material_id, state_ratios, temperature, temperature_powers);
@@ -442,45 +643,185 @@ ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
   // Add in the latent heat contribution
   if constexpr (!std::is_same_v<MaterialStates, Solid>)
   {
-    // Get the state-independent material properties
-    dealii::VectorizedArray<double> solidus, liquidus, latent_heat;
-    for (unsigned int n = 0; n < solidus.size(); ++n)
-    {
-      solidus[n] = _material_properties.get(material_id[n], Property::solidus);
-      liquidus[n] =
-          _material_properties.get(material_id[n], Property::liquidus);
-      latent_heat[n] =
-          _material_properties.get(material_id[n], Property::latent_heat);
-    }
-
     unsigned int constexpr solid =
         static_cast<unsigned int>(MaterialStates::State::solid);
     unsigned int constexpr liquid =
         static_cast<unsigned int>(MaterialStates::State::liquid);
 
     // We only need to take the latent heat into account if both the liquid and
-    // the solid phases are present. We could use an if with two conditions but
-    // that is very slow. Instead, we create a new variable is_mushy that is
-    // non-zero when there is both solid and liquid.
-    auto is_mushy = state_ratios[liquid] * state_ratios[solid];
-    for (unsigned int n = 0; n < specific_heat.size(); ++n)
-    {
-      if (is_mushy[n] > 0.0)
-      {
-        specific_heat[n] += latent_heat[n] / (liquidus[n] - solidus[n]);
-      }
-    }
+    // the solid phases are present. Instead of a branch, we use the variable
+    // is_mushy that is non-zero when there is both solid and liquid to mask
+    // the latent heat contribution.
+    dealii::VectorizedArray<Number> const zero(0.);
+    auto const is_mushy = state_ratios[liquid] * state_ratios[solid];
+    specific_heat +=
+        dealii::compare_and_apply_mask<dealii::SIMDComparison::greater_than>(
+            is_mushy, zero, latent_heat * inv_melting_range, zero);
   }
 
   return 1.0 / (density * specific_heat);
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+dealii::Tensor<2, dim, dealii::VectorizedArray<Number>>
+ThermalOperator<dim, n_materials, use_table, p_order, fe_degree, MaterialStates,
+                MemorySpaceType, Number>::
+    get_thermal_conductivity(
+        [[maybe_unused]] unsigned int cell, [[maybe_unused]] unsigned int q,
+        std::array<dealii::types::material_id,
+                   dealii::VectorizedArray<Number>::size()> const &material_id,
+        std::array<dealii::VectorizedArray<Number>,
+                   MaterialStates::n_material_states> const &state_ratios,
+        dealii::VectorizedArray<Number> const &temperature,
+        dealii::AlignedVector<dealii::VectorizedArray<Number>> const
+            &temperature_powers) const
+{
+  dealii::Tensor<2, dim, dealii::VectorizedArray<Number>> thermal_conductivity;
+
+  // In 2D we only use x and z, and there are no deposition angle
+  if constexpr (dim == 2)
+  {
+    thermal_conductivity[axis<dim>::x][axis<dim>::x] =
+        _material_properties.template compute_material_property<
+            use_table, StateProperty::thermal_conductivity_x>(
+            material_id, state_ratios, temperature, temperature_powers);
+    thermal_conductivity[axis<dim>::z][axis<dim>::z] =
+        _material_properties.template compute_material_property<
+            use_table, StateProperty::thermal_conductivity_z>(
+            material_id, state_ratios, temperature, temperature_powers);
+  }
+
+  if constexpr (dim == 3)
+  {
+    auto const thermal_conductivity_x =
+        _material_properties.template compute_material_property<
+            use_table, StateProperty::thermal_conductivity_x>(
+            material_id, state_ratios, temperature, temperature_powers);
+    auto const thermal_conductivity_y =
+        _material_properties.template compute_material_property<
+            use_table, StateProperty::thermal_conductivity_y>(
+            material_id, state_ratios, temperature, temperature_powers);
+
+    auto cos = _deposition_cos(cell, q);
+    auto sin = _deposition_sin(cell, q);
+
+    // The rotation is performed using the following formula
+    //
+    // (cos  -sin) (x  0) ( cos  sin)
+    // (sin   cos) (0  y) (-sin  cos)
+    // =
+    // ((x*cos^2 + y*sin^2)  ((x-y) * (sin*cos)))
+    // (((x-y) * (sin*cos))  (x*sin^2 + y*cos^2))
+    auto const off_diagonal =
+        (thermal_conductivity_x - thermal_conductivity_y) * sin * cos;
+    thermal_conductivity[axis<dim>::x][axis<dim>::x] =
+        thermal_conductivity_x * cos * cos + thermal_conductivity_y * sin * sin;
+    thermal_conductivity[axis<dim>::x][axis<dim>::y] = off_diagonal;
+    thermal_conductivity[axis<dim>::y][axis<dim>::x] = off_diagonal;
+    thermal_conductivity[axis<dim>::y][axis<dim>::y] =
+        thermal_conductivity_x * sin * sin + thermal_conductivity_y * cos * cos;
+
+    // There is no deposition angle for the z axis
+    thermal_conductivity[axis<dim>::z][axis<dim>::z] =
+        _material_properties.template compute_material_property<
+            use_table, StateProperty::thermal_conductivity_z>(
+            material_id, state_ratios, temperature, temperature_powers);
+  }
+
+  return thermal_conductivity;
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType,
+                     Number>::reset_coefficient_cache()
+{
+  if (_coefficient_cache_tolerance <= 0.)
+  {
+    return;
+  }
+
+  unsigned int const n_cells = _matrix_free.n_cell_batches();
+  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> fe_eval(
+      _matrix_free);
+  _cached_inv_rho_cp.reinit(n_cells, fe_eval.n_q_points);
+  _cached_thermal_conductivity.reinit(n_cells, fe_eval.n_q_points);
+  _cached_temperature_min.reinit(n_cells, fe_eval.n_q_points);
+  _cached_temperature_max.reinit(n_cells, fe_eval.n_q_points);
+  // NaN never satisfies the range check in use_cached_coefficients, so every
+  // entry is recomputed the next time it is used.
+  _cached_temperature_min.fill(dealii::VectorizedArray<Number>(
+      std::numeric_limits<Number>::quiet_NaN()));
+  _cached_temperature_max.fill(dealii::VectorizedArray<Number>(
+      std::numeric_limits<Number>::quiet_NaN()));
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+bool ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
+    use_cached_coefficients(
+        unsigned int cell, unsigned int q,
+        dealii::VectorizedArray<Number> const &temperature) const
+{
+  // Build a mask that is one on the lanes where the temperature is inside of
+  // the cached range and zero elsewhere. The comparisons with NaN are false, so
+  // the entries that were reset are never used. The lanes are then reduced
+  // without branching.
+  dealii::VectorizedArray<Number> const zero = 0.;
+  dealii::VectorizedArray<Number> const one = 1.;
+  auto const below_max =
+      dealii::compare_and_apply_mask<dealii::SIMDComparison::less_than>(
+          temperature, _cached_temperature_max(cell, q), one, zero);
+  auto const in_range = dealii::compare_and_apply_mask<
+      dealii::SIMDComparison::greater_than_or_equal>(
+      temperature, _cached_temperature_min(cell, q), below_max, zero);
+  Number n_lanes_in_range = 0.;
+  for (unsigned int n = 0; n < in_range.size(); ++n)
+    n_lanes_in_range += in_range[n];
+
+  return n_lanes_in_range == static_cast<Number>(in_range.size());
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
+    update_coefficient_cache(
+        unsigned int cell, unsigned int q,
+        dealii::VectorizedArray<Number> const &temperature,
+        dealii::VectorizedArray<Number> const &inv_rho_cp,
+        dealii::Tensor<2, dim, dealii::VectorizedArray<Number>> const
+            &thermal_conductivity) const
+{
+  _cached_inv_rho_cp(cell, q) = inv_rho_cp;
+  _cached_thermal_conductivity(cell, q) = thermal_conductivity;
+  auto temperature_min = temperature - _coefficient_cache_tolerance;
+  auto temperature_max = temperature + _coefficient_cache_tolerance;
+  if constexpr (!std::is_same_v<MaterialStates, Solid>)
+  {
+    // Above the solidus, the state ratios and the latent heat depend on the
+    // temperature. The cached coefficients can only be used while the
+    // temperature stays below the solidus.
+    auto const &solidus = _solidus[cell];
+    temperature_max = dealii::compare_and_apply_mask<
+        dealii::SIMDComparison::greater_than_or_equal>(
+        temperature, solidus,
+        dealii::VectorizedArray<Number>(std::numeric_limits<Number>::lowest()),
+        std::min(temperature_max, solidus));
+  }
+  _cached_temperature_min(cell, q) = temperature_min;
+  _cached_temperature_max(cell, q) = temperature_max;
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
     cell_local_apply(
-        dealii::MatrixFree<dim, double> const &data,
+        dealii::MatrixFree<dim, Number> const &data,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
         dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
         std::pair<unsigned int, unsigned int> const &cell_range) const
@@ -489,26 +830,52 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
   std::pair<unsigned int, unsigned int> cell_subrange =
       data.create_cell_subrange_hp_by_index(cell_range, 0);
 
-  auto const integration_flags =
-      _heat_sources_on
-          ? dealii::EvaluationFlags::values | dealii::EvaluationFlags::gradients
-          : dealii::EvaluationFlags::gradients;
-  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(data);
-  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
+  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> fe_eval(data);
+  std::array<dealii::VectorizedArray<Number>, MaterialStates::n_material_states>
       state_ratios;
 
   // We need powers of temperature to compute the material properties. We
   // could compute it in MaterialProperty but because it's in a hot loop.
   // It's really worth to compute it once and pass it when we compute a
   // material property.
-  dealii::AlignedVector<dealii::VectorizedArray<double>> temperature_powers(
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> temperature_powers(
       p_order + 1);
+  // Quadrature points and values of the heat sources of the current cell batch.
+  // The heat sources are evaluated on all the quadrature points at once. They
+  // are always evaluated in double precision. In single precision, a batch of
+  // quadrature points is split into several double-precision batches.
+  unsigned int constexpr n_double_lanes =
+      dealii::VectorizedArray<double>::size();
+  unsigned int constexpr n_source_batches =
+      dealii::VectorizedArray<Number>::size() / n_double_lanes;
+  static_assert(n_source_batches * n_double_lanes ==
+                dealii::VectorizedArray<Number>::size());
+  dealii::AlignedVector<dealii::Point<dim, dealii::VectorizedArray<double>>>
+      q_points(n_source_batches * fe_eval.n_q_points);
+  dealii::AlignedVector<dealii::VectorizedArray<double>> q_sources(
+      n_source_batches * fe_eval.n_q_points);
+
+  bool const coefficient_cache_on = _cached_inv_rho_cp.size(0) > 0;
 
   // Loop over the "cells". Note that we don't really work on a cell but on a
   // set of quadrature point.
   for (unsigned int cell = cell_subrange.first; cell < cell_subrange.second;
        ++cell)
   {
+    // With multirate time stepping, skip the cell batches whose DoFs are not
+    // updated during the current micro step.
+    if (!_cell_batch_periods.empty() &&
+        (_micro_step % _cell_batch_periods[cell] != 0))
+      continue;
+
+    // Only evaluate the heat sources if the cell batch intersects one of them
+    bool const heat_sources_on =
+        _heat_sources_on && _cell_batch_heat_sources_on[cell];
+    auto const integration_flags =
+        heat_sources_on ? dealii::EvaluationFlags::values |
+                              dealii::EvaluationFlags::gradients
+                        : dealii::EvaluationFlags::gradients;
+
     // Reinit fe_eval on the current cell
     fe_eval.reinit(cell);
     // Store in a local vector the local values of src
@@ -516,97 +883,105 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
     // Evaluate the function and its gradient on the reference cell
     fe_eval.evaluate(dealii::EvaluationFlags::values |
                      dealii::EvaluationFlags::gradients);
+    // Evaluate the heat sources on all the quadrature points of the batch
+    if (heat_sources_on)
+    {
+      for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+      {
+        if constexpr (std::is_same_v<Number, double>)
+        {
+          q_points[q] = fe_eval.quadrature_point(q);
+        }
+        else
+        {
+          auto const point = fe_eval.quadrature_point(q);
+          for (unsigned int n = 0; n < point[0].size(); ++n)
+            for (unsigned int d = 0; d < dim; ++d)
+              q_points[q * n_source_batches + n / n_double_lanes][d]
+                      [n % n_double_lanes] = point[d][n];
+        }
+      }
+      for (auto &source : q_sources)
+        source = 0.;
+      dealii::ArrayView<
+          dealii::Point<dim, dealii::VectorizedArray<double>> const>
+          points_view(q_points.data(), q_points.size());
+      dealii::ArrayView<dealii::VectorizedArray<double>> sources_view(
+          q_sources.data(), q_sources.size());
+      for (auto beam : _goldak_heat_sources)
+        beam->add_values(points_view, sources_view);
+      for (auto beam : _electron_beam_heat_sources)
+        beam->add_values(points_view, sources_view);
+      for (auto beam : _cube_heat_sources)
+        beam->add_values(points_view, sources_view);
+      for (auto beam : _other_heat_sources)
+        beam->add_values(points_view, sources_view);
+    }
     // Apply the Jacobian of the transformation, multiply by the variable
     // coefficients and the quadrature points
     for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
     {
       auto temperature = fe_eval.get_value(q);
-      // Precompute the powers of temperature.
-      temperature_powers[0] = 1.0;
-      for (unsigned int i = 1; i <= p_order; ++i)
+      dealii::VectorizedArray<Number> inv_rho_cp;
+      dealii::Tensor<2, dim, dealii::VectorizedArray<Number>>
+          thermal_conductivity;
+      if (coefficient_cache_on && use_cached_coefficients(cell, q, temperature))
       {
-        temperature_powers[i] = temperature_powers[i - 1] * temperature;
+        // The cache is only valid below the solidus, where update_state_ratios
+        // sets the liquid ratio to zero and leaves the powder ratio unchanged.
+        // The cache may have been filled by an evaluation with a frozen state
+        // which did not write the ratios, so the liquid ratio is written here.
+        if constexpr (!std::is_same_v<MaterialStates, Solid>)
+        {
+          if (!_frozen_state)
+            _liquid_ratio(cell, q) = 0.;
+        }
+        inv_rho_cp = _cached_inv_rho_cp(cell, q);
+        thermal_conductivity = _cached_thermal_conductivity(cell, q);
       }
-
-      // Calculate the local material properties
-      update_state_ratios(cell, q, temperature, state_ratios);
-      auto material_id = _material_id(cell, q);
-      auto inv_rho_cp = get_inv_rho_cp(material_id, state_ratios, temperature,
-                                       temperature_powers);
-      auto th_conductivity_grad = fe_eval.get_gradient(q);
-
-      // In 2D we only use x and z, and there are no deposition angle
-      if constexpr (dim == 2)
+      else
       {
-        th_conductivity_grad[axis<dim>::x] *=
-            _material_properties.template compute_material_property<
-                use_table, StateProperty::thermal_conductivity_x>(
-                material_id, state_ratios, temperature, temperature_powers);
-        th_conductivity_grad[axis<dim>::z] *=
-            _material_properties.template compute_material_property<
-                use_table, StateProperty::thermal_conductivity_z>(
-                material_id, state_ratios, temperature, temperature_powers);
-      }
+        // Precompute the powers of temperature.
+        temperature_powers[0] = 1.0;
+        for (unsigned int i = 1; i <= p_order; ++i)
+        {
+          temperature_powers[i] = temperature_powers[i - 1] * temperature;
+        }
 
-      if constexpr (dim == 3)
-      {
-        auto const th_conductivity_grad_x = th_conductivity_grad[axis<dim>::x];
-        auto const th_conductivity_grad_y = th_conductivity_grad[axis<dim>::y];
-        auto const thermal_conductivity_x =
-            _material_properties.template compute_material_property<
-                use_table, StateProperty::thermal_conductivity_x>(
-                material_id, state_ratios, temperature, temperature_powers);
-        auto const thermal_conductivity_y =
-            _material_properties.template compute_material_property<
-                use_table, StateProperty::thermal_conductivity_y>(
-                material_id, state_ratios, temperature, temperature_powers);
-
-        auto cos = _deposition_cos(cell, q);
-        auto sin = _deposition_sin(cell, q);
-
-        // The rotation is performed using the following formula
-        //
-        // (cos  -sin) (x  0) ( cos  sin)
-        // (sin   cos) (0  y) (-sin  cos)
-        // =
-        // ((x*cos^2 + y*sin^2)  ((x-y) * (sin*cos)))
-        // (((x-y) * (sin*cos))  (x*sin^2 + y*cos^2))
-
-        th_conductivity_grad[axis<dim>::x] =
-            (thermal_conductivity_x * cos * cos +
-             thermal_conductivity_y * sin * sin) *
-                th_conductivity_grad_x +
-            ((thermal_conductivity_x - thermal_conductivity_y) * sin * cos) *
-                th_conductivity_grad_y;
-        th_conductivity_grad[axis<dim>::y] =
-            ((thermal_conductivity_x - thermal_conductivity_y) * sin * cos) *
-                th_conductivity_grad_x +
-            (thermal_conductivity_x * sin * sin +
-             thermal_conductivity_y * cos * cos) *
-                th_conductivity_grad_y;
-
-        // There is no deposition angle for the z axis
-        th_conductivity_grad[axis<dim>::z] *=
-            _material_properties.template compute_material_property<
-                use_table, StateProperty::thermal_conductivity_z>(
-                material_id, state_ratios, temperature, temperature_powers);
+        // Calculate the local material properties
+        update_state_ratios(cell, q, temperature, state_ratios);
+        auto material_id = _material_id(cell, q);
+        inv_rho_cp = get_inv_rho_cp(material_id, state_ratios, temperature,
+                                    temperature_powers, _latent_heat[cell],
+                                    _inv_melting_range[cell]);
+        thermal_conductivity = get_thermal_conductivity(
+            cell, q, material_id, state_ratios, temperature,
+            temperature_powers);
+        if (coefficient_cache_on)
+        {
+          update_coefficient_cache(cell, q, temperature, inv_rho_cp,
+                                   thermal_conductivity);
+        }
       }
 
-      fe_eval.submit_gradient(-inv_rho_cp * th_conductivity_grad, q);
+      fe_eval.submit_gradient(
+          -inv_rho_cp * (thermal_conductivity * fe_eval.get_gradient(q)), q);
 
       // Compute source term
-      if (_heat_sources_on)
+      if (heat_sources_on)
       {
-        dealii::Point<dim, dealii::VectorizedArray<double>> const &q_point =
-            fe_eval.quadrature_point(q);
-
-        dealii::VectorizedArray<double> quad_pt_source = 0.0;
-        for (auto &beam : _heat_sources)
-          quad_pt_source += beam->value(q_point);
-
-        quad_pt_source *= inv_rho_cp;
-
-        fe_eval.submit_value(quad_pt_source, q);
+        if constexpr (std::is_same_v<Number, double>)
+        {
+          fe_eval.submit_value(inv_rho_cp * q_sources[q], q);
+        }
+        else
+        {
+          dealii::VectorizedArray<Number> source;
+          for (unsigned int n = 0; n < source.size(); ++n)
+            source[n] = q_sources[q * n_source_batches + n / n_double_lanes]
+                                 [n % n_double_lanes];
+          fe_eval.submit_value(inv_rho_cp * source, q);
+        }
       }
     }
     // Sum over the quadrature points.
@@ -616,11 +991,11 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     face_local_apply(
-        dealii::MatrixFree<dim, double> const &data,
+        dealii::MatrixFree<dim, Number> const &data,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
         dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
         std::pair<unsigned int, unsigned int> const &face_range) const
@@ -652,35 +1027,43 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 
   // Create the FEFaceEvaluation object. The boolean in the constructor is
   // used to decided which cell the face should be exterior to.
-  dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, double>
+  dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, Number>
       fe_face_eval(data, adjacent_cells_fe_index.first == 0);
-  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
+  std::array<dealii::VectorizedArray<Number>, MaterialStates::n_material_states>
       face_state_ratios;
 
-  // Create variables used to compute boundary conditions.
-  auto conv_temperature_infty = dealii::make_vectorized_array<double>(0.);
-  auto conv_heat_transfer_coef = dealii::make_vectorized_array<double>(0.);
-  auto rad_temperature_infty = dealii::make_vectorized_array<double>(0.);
-  auto rad_heat_transfer_coef = dealii::make_vectorized_array<double>(0.);
-
   // We need powers of temperature to compute the material properties. We
   // could compute it in MaterialProperty but because it's in a hot loop,
   // it's really worth to compute it once and pass it when we compute a
   // material property.
-  dealii::AlignedVector<dealii::VectorizedArray<double>> temperature_powers(
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> temperature_powers(
       p_order + 1);
-
   // Loop over the faces
   for (unsigned int face = face_range.first; face < face_range.second; ++face)
   {
-    conv_heat_transfer_coef = 0.;
-    rad_heat_transfer_coef = 0.;
+    // With multirate time stepping, skip the face batches whose DoFs are not
+    // updated during the current micro step.
+    if (!_face_batch_periods.empty() &&
+        (_micro_step % _face_batch_periods[face] != 0))
+      continue;
+
+    // The boundary type and the temperatures at infinity are precomputed in
+    // set_face_boundary_data. Adiabatic faces do not contribute.
+    BoundaryType const boundary_type = _face_boundary_type[face];
+    bool const convective = boundary_type & BoundaryType::convective;
+    bool const radiative = boundary_type & BoundaryType::radiative;
+    if (!convective && !radiative)
+    {
+      continue;
+    }
+    auto const &conv_temperature_infty =
+        _face_convection_temperature_infty[face];
+    auto const &rad_temperature_infty = _face_radiation_temperature_infty[face];
+    auto const rad_temperature_infty_square =
+        rad_temperature_infty * rad_temperature_infty;
 
     // Reinit fe_face_eval on the current face
     fe_face_eval.reinit(face);
-    // Get the boundary type
-    BoundaryType const boundary_type =
-        _boundary.get_boundary_type(fe_face_eval.boundary_id());
     // Store in a local vector the local values of src
     fe_face_eval.read_dof_values(src);
     // Evalue the function on the reference cell
@@ -700,48 +1083,38 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
       // Compute the local_properties
       auto material_id = _face_material_id(face, q);
       update_face_state_ratios(face, q, temperature, face_state_ratios);
-      auto const inv_rho_cp = get_inv_rho_cp(material_id, face_state_ratios,
-                                             temperature, temperature_powers);
-      if (boundary_type & BoundaryType::convective)
+      auto const inv_rho_cp = get_inv_rho_cp(
+          material_id, face_state_ratios, temperature, temperature_powers,
+          _face_latent_heat[face], _face_inv_melting_range[face]);
+      auto heat_flux = dealii::make_vectorized_array<Number>(0.);
+      if (convective)
       {
-        for (unsigned int n = 0; n < conv_temperature_infty.size(); ++n)
-        {
-          conv_temperature_infty[n] = _material_properties.get(
-              material_id[n], Property::convection_temperature_infty);
-        }
-        conv_heat_transfer_coef =
+        auto const conv_heat_transfer_coef =
             _material_properties.template compute_material_property<
                 use_table, StateProperty::convection_heat_transfer_coef>(
                 material_id, face_state_ratios, temperature,
                 temperature_powers);
+        heat_flux +=
+            conv_heat_transfer_coef * (temperature - conv_temperature_infty);
       }
-      if (boundary_type & BoundaryType::radiative)
+      if (radiative)
       {
-        for (unsigned int n = 0; n < rad_temperature_infty.size(); ++n)
-        {
-          rad_temperature_infty[n] = _material_properties.get(
-              material_id[n], Property::radiation_temperature_infty);
-        }
-
         // We need the radiation heat transfer coefficient but it is not a
         // real material property but it is derived from other material
         // properties: h_rad = emissitivity * stefan-boltzmann constant * (T
         // + T_infty) (T^2 + T^2_infty).
-        rad_heat_transfer_coef =
+        auto const rad_heat_transfer_coef =
             _material_properties.template compute_material_property<
                 use_table, StateProperty::emissivity>(
                 material_id, face_state_ratios, temperature,
                 temperature_powers) *
             Constant::stefan_boltzmann * (temperature + rad_temperature_infty) *
-            (temperature * temperature +
-             rad_temperature_infty * rad_temperature_infty);
+            (temperature * temperature + rad_temperature_infty_square);
+        heat_flux +=
+            rad_heat_transfer_coef * (temperature - rad_temperature_infty);
       }
 
-      auto const boundary_val =
-          -inv_rho_cp *
-          (conv_heat_transfer_coef * (temperature - conv_temperature_infty) +
-           rad_heat_transfer_coef * (temperature - rad_temperature_infty));
-      fe_face_eval.submit_value(boundary_val, q);
+      fe_face_eval.submit_value(-inv_rho_cp * heat_flux, q);
     }
     // Sum over the quadrature points
     fe_face_eval.integrate(dealii::EvaluationFlags::values);
@@ -750,13 +1123,37 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
+    set_face_state(
+        unsigned int face, unsigned int lane,
+        typename dealii::Triangulation<dim>::active_cell_iterator const &cell)
+{
+  // The state and the material are constant on the cell, so they are read once
+  // and copied to all the quadrature points of the face.
+  unsigned int const n_q_points = _face_material_id.size(1);
+  if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
+  {
+    double const powder_ratio = _material_properties.get_state_ratio(
+        cell, MaterialStates::State::powder);
+    for (unsigned int q = 0; q < n_q_points; ++q)
+      _face_powder_ratio(face, q)[lane] = powder_ratio;
+  }
+
+  dealii::types::material_id const material_id = cell->material_id();
+  for (unsigned int q = 0; q < n_q_points; ++q)
+    _face_material_id(face, q)[lane] = material_id;
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates,
-                     MemorySpaceType>::get_state_from_material_properties()
+                     MaterialStates, MemorySpaceType,
+                     Number>::get_state_from_material_properties()
 {
   unsigned int const n_cells = _matrix_free.n_cell_batches();
-  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(
+  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> fe_eval(
       _matrix_free);
 
   if constexpr (!std::is_same_v<MaterialStates, Solid>)
@@ -771,31 +1168,54 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
 
   _material_id.reinit(n_cells, fe_eval.n_q_points);
 
+  // The material and the state have changed, the cached coefficients need to
+  // be recomputed.
+  reset_coefficient_cache();
+
+  // The state and the material are constant on a cell, so they are read once
+  // per cell and copied to all the quadrature points.
   for (unsigned int cell = 0; cell < n_cells; ++cell)
-    for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
-      for (unsigned int i = 0;
-           i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+    for (unsigned int i = 0;
+         i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+    {
+      typename dealii::DoFHandler<dim>::cell_iterator cell_it =
+          _matrix_free.get_cell_iterator(cell, i);
+      // Cast to Triangulation<dim>::cell_iterator to access the material_id
+      typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
+          cell_it);
+
+      if constexpr (!std::is_same_v<MaterialStates, Solid>)
       {
-        typename dealii::DoFHandler<dim>::cell_iterator cell_it =
-            _matrix_free.get_cell_iterator(cell, i);
-        // Cast to Triangulation<dim>::cell_iterator to access the material_id
-        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
-            cell_it);
+        double const liquid_ratio = _material_properties.get_state_ratio(
+            cell_tria, MaterialStates::State::liquid);
+        for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+          _liquid_ratio(cell, q)[i] = liquid_ratio;
+      }
 
-        if constexpr (!std::is_same_v<MaterialStates, Solid>)
-        {
-          _liquid_ratio(cell, q)[i] = _material_properties.get_state_ratio(
-              cell_tria, MaterialStates::State::liquid);
-        }
+      if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
+      {
+        double const powder_ratio = _material_properties.get_state_ratio(
+            cell_tria, MaterialStates::State::powder);
+        for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+          _powder_ratio(cell, q)[i] = powder_ratio;
+      }
 
-        if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
-        {
-          _powder_ratio(cell, q)[i] = _material_properties.get_state_ratio(
-              cell_tria, MaterialStates::State::powder);
-        }
+      dealii::types::material_id const material_id = cell_tria->material_id();
+      for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+        _material_id(cell, q)[i] = material_id;
+    }
 
-        _material_id(cell, q)[i] = cell_tria->material_id();
-      }
+  // The unused lanes of the cell batches use the material of the first lane.
+  // This way, a batch that contains only one material is recognized as such by
+  // MaterialProperty which can then broadcast the material coefficients.
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+    for (unsigned int i = _matrix_free.n_active_entries_per_cell_batch(cell);
+         i < dealii::VectorizedArray<Number>::size(); ++i)
+      for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+        _material_id(cell, q)[i] = _material_id(cell, q)[0];
+
+  set_material_constants(_material_id, _solidus, _liquidus, _latent_heat,
+                         _inv_melting_range);
 
   // If we are using boundary conditions other than adiabatic, we also need to
   // update the face variables
@@ -805,7 +1225,7 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
     unsigned int const n_boundary_faces =
         _matrix_free.n_boundary_face_batches();
     unsigned int const n_faces = n_inner_faces + n_boundary_faces;
-    dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, double>
+    dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, Number>
         fe_face_eval(_matrix_free, true);
 
     if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
@@ -816,126 +1236,219 @@ void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
     _face_material_id.reinit(n_faces, fe_face_eval.n_q_points);
 
     for (unsigned int face = 0; face < n_inner_faces; ++face)
-      for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
-        for (unsigned int i = 0;
-             i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+      for (unsigned int i = 0;
+           i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+      {
+        // We get the two cells associated with the face
+        auto [cell_1, face_1] = _matrix_free.get_face_iterator(face, i, true);
+        auto [cell_2, face_2] = _matrix_free.get_face_iterator(face, i, false);
+        // We only care for cells that are at the boundary between activated
+        // and deactivated domains
+        unsigned int const active_fe_index_1 = cell_1->active_fe_index();
+        unsigned int const active_fe_index_2 = cell_2->active_fe_index();
+        if (active_fe_index_1 == active_fe_index_2)
         {
-          // We get the two cells associated with the face
-          auto [cell_1, face_1] = _matrix_free.get_face_iterator(face, i, true);
-          auto [cell_2, face_2] =
-              _matrix_free.get_face_iterator(face, i, false);
-          // We only care for cells that are at the boundary between activated
-          // and deactivated domains
-          unsigned int const active_fe_index_1 = cell_1->active_fe_index();
-          unsigned int const active_fe_index_2 = cell_2->active_fe_index();
-          if (active_fe_index_1 == active_fe_index_2)
-          {
-            continue;
-          }
-          // We need the cell that has FE_Q not the one that has FE_Nothing
-          // Cast to Triangulation<dim>::cell_iterator to access the
-          // material_id
-          typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
-              (active_fe_index_1 == 0) ? cell_1 : cell_2);
-          if (cell_tria->is_locally_owned())
-          {
-            if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
-            {
-              _face_powder_ratio(face, q)[i] =
-                  _material_properties.get_state_ratio(
-                      cell_tria, MaterialStates::State::powder);
-            }
-
-            _face_material_id(face, q)[i] = cell_tria->material_id();
-          }
+          continue;
         }
+        // We need the cell that has FE_Q not the one that has FE_Nothing
+        // Cast to Triangulation<dim>::cell_iterator to access the
+        // material_id
+        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
+            (active_fe_index_1 == 0) ? cell_1 : cell_2);
+        if (cell_tria->is_locally_owned())
+        {
+          set_face_state(face, i, cell_tria);
+        }
+      }
 
     for (unsigned int face = n_inner_faces; face < n_faces; ++face)
-      for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
-        for (unsigned int i = 0;
-             i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+      for (unsigned int i = 0;
+           i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+      {
+        // We get one cell associated with the face
+        auto [cell, face_] = _matrix_free.get_face_iterator(face, i, true);
+        unsigned int const active_fe_index = cell->active_fe_index();
+        if (active_fe_index == 1)
+        {
+          continue;
+        }
+        // We need the cell that has FE_Q not the one that has FE_Nothing
+        // Cast to Triangulation<dim>::cell_iterator to access the
+        // material_id
+        typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
+            cell);
+        if (cell_tria->is_locally_owned())
         {
-          // We get one cell associated with the face
-          auto [cell, face_] = _matrix_free.get_face_iterator(face, i, true);
-          unsigned int const active_fe_index = cell->active_fe_index();
-          if (active_fe_index == 1)
-          {
-            continue;
-          }
-          // We need the cell that has FE_Q not the one that has FE_Nothing
-          // Cast to Triangulation<dim>::cell_iterator to access the
-          // material_id
-          typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
-              cell);
-          if (cell_tria->is_locally_owned())
-          {
-            if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
-            {
-              _face_powder_ratio(face, q)[i] =
-                  _material_properties.get_state_ratio(
-                      cell_tria, MaterialStates::State::powder);
-            }
-
-            _face_material_id(face, q)[i] = cell_tria->material_id();
-          }
+          set_face_state(face, i, cell_tria);
         }
+      }
+
+    set_material_constants(_face_material_id, _face_solidus, _face_liquidus,
+                           _face_latent_heat, _face_inv_melting_range);
+    set_face_boundary_data();
   }
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates,
-                     MemorySpaceType>::set_state_to_material_properties()
+                     MaterialStates, MemorySpaceType,
+                     Number>::set_face_boundary_data()
+{
+  double const number_max =
+      static_cast<double>(std::numeric_limits<Number>::max());
+  auto to_number = [&](double value)
+  { return static_cast<Number>(std::min(value, number_max)); };
+
+  unsigned int const n_inner_faces = _matrix_free.n_inner_face_batches();
+  unsigned int const n_faces = _face_material_id.size(0);
+  _face_boundary_type.assign(n_faces, BoundaryType::adiabatic);
+  _face_convection_temperature_infty.resize(n_faces);
+  _face_radiation_temperature_infty.resize(n_faces);
+  if (_face_material_id.size(1) == 0)
+  {
+    return;
+  }
+
+  for (unsigned int face = 0; face < n_faces; ++face)
+  {
+    // All the faces of a batch share the same fe indices. Only the faces at
+    // the boundary of the activated domain have a flux (see face_local_apply).
+    auto const adjacent_cells_fe_index =
+        _matrix_free.get_face_range_category({face, face + 1});
+    if ((adjacent_cells_fe_index.first == adjacent_cells_fe_index.second) ||
+        ((adjacent_cells_fe_index.first != 0) &&
+         (adjacent_cells_fe_index.second != 0)))
+    {
+      continue;
+    }
+
+    dealii::types::boundary_id const boundary_id =
+        face < n_inner_faces ? dealii::numbers::internal_face_boundary_id
+                             : _matrix_free.get_boundary_id(face);
+    _face_boundary_type[face] = _boundary.get_boundary_type(boundary_id);
+
+    for (unsigned int n = 0; n < dealii::VectorizedArray<Number>::size(); ++n)
+    {
+      // The material is the same at all the quadrature points of a face.
+      dealii::types::material_id const id = _face_material_id(face, 0)[n];
+      _face_convection_temperature_infty[face][n] = to_number(
+          _material_properties.get(id, Property::convection_temperature_infty));
+      _face_radiation_temperature_infty[face][n] = to_number(
+          _material_properties.get(id, Property::radiation_temperature_infty));
+    }
+  }
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType,
+                     Number>::set_state_to_material_properties()
 {
   _material_properties.set_state(_liquid_ratio, _powder_ratio,
-                                 _cell_it_to_mf_cell_map,
+                                 _cell_index_to_mf_cell_map,
                                  _matrix_free.get_dof_handler());
 }
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
-          typename MaterialStates, typename MemorySpaceType>
+          typename MaterialStates, typename MemorySpaceType, typename Number>
 void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
-                     MaterialStates, MemorySpaceType>::
+                     MaterialStates, MemorySpaceType, Number>::
     set_material_deposition_orientation(
         std::vector<double> const &deposition_cos,
         std::vector<double> const &deposition_sin)
 {
   unsigned int const n_cells = _matrix_free.n_cell_batches();
-  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(
+  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> fe_eval(
       _matrix_free);
 
   _deposition_cos.reinit(n_cells, fe_eval.n_q_points);
   _deposition_sin.reinit(n_cells, fe_eval.n_q_points);
+  reset_coefficient_cache();
 
-  using dof_cell_iterator = typename dealii::DoFHandler<dim>::cell_iterator;
-  std::map<dof_cell_iterator, unsigned int> cell_mapping;
+  // The deposition angles are ordered like the locally owned cells using FE_Q.
+  // Use the precomputed map to find the position of each cell in the
+  // matrix-free tables.
   unsigned int pos = 0;
   for (auto const &cell : dealii::filter_iterators(
            _matrix_free.get_dof_handler().active_cell_iterators(),
            dealii::IteratorFilters::LocallyOwnedCell(),
            dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
   {
-    cell_mapping[cell] = pos;
+    ASSERT(pos < deposition_cos.size(), "Out-of-bound access.");
+    auto const [mf_cell, lane] =
+        _cell_index_to_mf_cell_map[cell->active_cell_index()];
+    for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+    {
+      _deposition_cos(mf_cell, q)[lane] = deposition_cos[pos];
+      _deposition_sin(mf_cell, q)[lane] = deposition_sin[pos];
+    }
     ++pos;
   }
-  ASSERT((pos == 0) || (pos - 1 < deposition_cos.size()),
-         "Out-of-bound access.");
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType, typename Number>
+void ThermalOperator<dim, n_materials, use_table, p_order, fe_degree,
+                     MaterialStates, MemorySpaceType, Number>::
+    set_multirate_dof_periods(
+        dealii::LA::distributed::Vector<double, MemorySpaceType> const
+            &dof_periods)
+{
+  _cell_batch_periods.clear();
+  _face_batch_periods.clear();
+  if (dof_periods.size() == 0)
+    return;
 
+  // The period of a cell batch is the smallest period of its DoFs. Since the
+  // periods are powers of two, the cell batch is evaluated every time one of
+  // its DoFs is updated.
+  dof_periods.update_ghost_values();
+  unsigned int const max_period = std::numeric_limits<unsigned int>::max();
+  std::vector<dealii::types::global_dof_index> dof_indices;
+  auto compute_cell_period = [&](auto const &cell_it)
+  {
+    unsigned int period = max_period;
+    // The cells using FE_Nothing have no DoF.
+    dof_indices.resize(cell_it->get_fe().n_dofs_per_cell());
+    cell_it->get_dof_indices(dof_indices);
+    for (auto const dof : dof_indices)
+      period = std::min(period, static_cast<unsigned int>(dof_periods(dof)));
+    return period;
+  };
+
+  unsigned int const n_cells = _matrix_free.n_cell_batches();
+  _cell_batch_periods.resize(n_cells, max_period);
   for (unsigned int cell = 0; cell < n_cells; ++cell)
-    for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
-      for (unsigned int i = 0;
-           i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
-      {
-        dof_cell_iterator cell_it = _matrix_free.get_cell_iterator(cell, i);
+    for (unsigned int i = 0;
+         i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+    {
+      _cell_batch_periods[cell] = std::min(
+          _cell_batch_periods[cell],
+          compute_cell_period(_matrix_free.get_cell_iterator(cell, i)));
+    }
 
-        if (cell_it->active_fe_index() == 0)
-        {
-          unsigned int const j = cell_mapping[cell_it];
-          _deposition_cos(cell, q)[i] = deposition_cos[j];
-          _deposition_sin(cell, q)[i] = deposition_sin[j];
-        }
-      }
+  // The face batches use the smallest period of the DoFs of their adjacent
+  // cells.
+  unsigned int const n_inner_faces = _matrix_free.n_inner_face_batches();
+  unsigned int const n_faces =
+      n_inner_faces + _matrix_free.n_boundary_face_batches();
+  _face_batch_periods.resize(n_faces, max_period);
+  for (unsigned int face = 0; face < n_faces; ++face)
+    for (unsigned int i = 0;
+         i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+    {
+      _face_batch_periods[face] = std::min(
+          _face_batch_periods[face],
+          compute_cell_period(
+              _matrix_free.get_face_iterator(face, i, true).first));
+      if (face < n_inner_faces)
+        _face_batch_periods[face] = std::min(
+            _face_batch_periods[face],
+            compute_cell_period(
+                _matrix_free.get_face_iterator(face, i, false).first));
+    }
 }
 
 } // namespace adamantine
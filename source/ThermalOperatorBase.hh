@@ -42,6 +42,29 @@ public:
         dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
       const = 0;
 
+  /**
+   * Matrix-vector multiplication that does not modify the material state. The
+   * state ratios are computed from the temperature in src but the ratios
+   * stored by the operator are left untouched. This is used to evaluate the
+   * operator at temperatures that may be rejected, like the iterates of a
+   * nonlinear solver.
+   * \param[in] src
+   * \param[out] dst
+   */
+  virtual void vmult_frozen_state(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const = 0;
+
+  /**
+   * Update the material state at the temperature src without applying the
+   * operator. This commits the state of a solution obtained with
+   * vmult_frozen_state.
+   */
+  virtual void update_state(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const = 0;
+
   /**
    * Matrix-vector multiplication and addition of the result to dst. This
    * function applies the operator to the vector src and add the result to the
@@ -82,6 +105,39 @@ public:
       std::vector<double> const &deposition_sin) = 0;
 
   virtual void set_time(double) = 0;
+
+  /**
+   * Set the number of micro steps between two updates of each DoF for the
+   * multirate time stepping. A cell batch is only evaluated during the micro
+   * steps where at least one of its DoFs is updated. An empty vector disables
+   * the filtering of the cell batches.
+   */
+  virtual void set_multirate_dof_periods(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const
+          &dof_periods) = 0;
+
+  /**
+   * Set the current micro step of the multirate time stepping.
+   */
+  virtual void set_multirate_micro_step(unsigned int micro_step) = 0;
+
+  /**
+   * Perform one stage of a low-storage Runge-Kutta scheme in a single pass
+   * over the data. The operator is applied to @p current_ri and the result,
+   * scaled by the inverse of the mass matrix, is stored in @p vec_ki. Then,
+   * with \f$ u \f$ the value of @p solution before the stage,
+   * @p solution is set to \f$ u + factor\_solution \; k_i \f$ and @p next_ri
+   * to \f$ u + factor\_ai \; k_i \f$. @p current_ri may be the same vector as
+   * @p solution or @p next_ri. set_time() needs to be called before.
+   */
+  virtual void low_storage_rk_stage(
+      double factor_solution, double factor_ai,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const
+          &current_ri,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &vec_ki,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &next_ri)
+      const = 0;
 };
 } // namespace adamantine
 #endif
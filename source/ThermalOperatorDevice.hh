@@ -8,6 +8,7 @@
 #include <Boundary.hh>
 #include <MaterialProperty.hh>
 #include <ThermalOperatorBase.hh>
+#include <utils.hh>
 
 #include <deal.II/base/types.h>
 #include <deal.II/matrix_free/portable_matrix_free.h>
@@ -45,6 +46,15 @@ public:
              dealii::LA::distributed::Vector<double, MemorySpaceType> const
                  &src) const override;
 
+  void vmult_frozen_state(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const override;
+
+  void update_state(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const override;
+
   void vmult_add(dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
                  dealii::LA::distributed::Vector<double, MemorySpaceType> const
                      &src) const override;
@@ -76,6 +86,28 @@ public:
     // TODO
   }
 
+  void set_multirate_dof_periods(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const
+          &dof_periods) override
+  {
+    ASSERT_THROW(dof_periods.size() == 0,
+                 "Multirate time stepping is not supported on the device.");
+  }
+
+  void set_multirate_micro_step(unsigned int) override {}
+
+  void low_storage_rk_stage(
+      double, double,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &)
+      const override
+  {
+    ASSERT_THROW(false, "Low-storage Runge-Kutta time stepping is not "
+                        "supported on the device.");
+  }
+
   /**
    * Update \f$ \frac{1}{\rho C_p} \f$ on the cells using the values computed at
    * the quadrature points.
@@ -114,6 +146,16 @@ private:
   dealii::Portable::MatrixFree<dim, double> _matrix_free;
   Kokkos::View<double *, kokkos_default> _liquid_ratio;
   Kokkos::View<double *, kokkos_default> _powder_ratio;
+  /**
+   * Flag set to true while vmult_frozen_state is applied. The state ratios are
+   * then not written.
+   */
+  mutable bool _frozen_state = false;
+  /**
+   * Result of the operator application used by update_state.
+   */
+  mutable dealii::LA::distributed::Vector<double, MemorySpaceType>
+      _state_update;
   Kokkos::View<dealii::types::material_id *, kokkos_default> _material_id;
   Kokkos::View<double *, kokkos_default> _inv_rho_cp;
   Kokkos::View<double *, kokkos_default> _deposition_cos;
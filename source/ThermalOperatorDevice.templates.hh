@@ -92,6 +92,8 @@ class ThermalOperatorQuad
 {
 public:
   using kokkos_default = dealii::MemorySpace::Default::kokkos_space;
+  // The tables are only read, which allows Kokkos to use the texture cache.
+  using random_access = Kokkos::MemoryTraits<Kokkos::RandomAccess>;
 
   KOKKOS_FUNCTION ThermalOperatorQuad(
       unsigned int cell,
@@ -103,13 +105,23 @@ public:
       Kokkos::View<dealii::types::material_id *, kokkos_default> material_id,
       Kokkos::View<double *, kokkos_default> inv_rho_cp,
       Kokkos::View<double **, kokkos_default> properties,
-      Kokkos::View<double *****, kokkos_default> state_property_tables,
-      Kokkos::View<double ****, kokkos_default> state_property_polynomials)
+      Kokkos::View<double const *****, kokkos_default, random_access>
+          state_property_tables,
+      Kokkos::View<unsigned int const ****, kokkos_default, random_access>
+          state_property_sample_intervals,
+      Kokkos::View<double const ****, kokkos_default, random_access>
+          state_property_sample_grids,
+      Kokkos::View<double ****, kokkos_default> state_property_polynomials,
+      bool frozen_state)
       : _cell(cell), _gpu_data(gpu_data), _cos(cos), _sin(sin),
         _powder_ratio(powder_ratio), _liquid_ratio(liquid_ratio),
         _material_id(material_id), _inv_rho_cp(inv_rho_cp),
-        _properties(properties), _state_property_tables(state_property_tables),
-        _state_property_polynomials(state_property_polynomials)
+        _properties(properties),
+        _state_property_tables(state_property_tables),
+        _state_property_sample_intervals(state_property_sample_intervals),
+        _state_property_sample_grids(state_property_sample_grids),
+        _state_property_polynomials(state_property_polynomials),
+        _frozen_state(frozen_state)
   {
   }
 
@@ -144,8 +156,14 @@ private:
   Kokkos::View<dealii::types::material_id *, kokkos_default> _material_id;
   Kokkos::View<double *, kokkos_default> _inv_rho_cp;
   Kokkos::View<double **, kokkos_default> _properties;
-  Kokkos::View<double *****, kokkos_default> _state_property_tables;
+  Kokkos::View<double const *****, kokkos_default, random_access>
+      _state_property_tables;
+  Kokkos::View<unsigned int const ****, kokkos_default, random_access>
+      _state_property_sample_intervals;
+  Kokkos::View<double const ****, kokkos_default, random_access>
+      _state_property_sample_grids;
   Kokkos::View<double ****, kokkos_default> _state_property_polynomials;
+  bool _frozen_state;
 };
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
@@ -196,7 +214,8 @@ KOKKOS_FUNCTION void ThermalOperatorQuad<
       // round-off.
       state_ratios[solid] = 1. - state_ratios[liquid];
 
-      _liquid_ratio(pos) = state_ratios[liquid];
+      if (!_frozen_state)
+        _liquid_ratio(pos) = state_ratios[liquid];
     }
     else if constexpr (std::is_same_v<MaterialStates,
                                       adamantine::SolidLiquidPowder>)
@@ -223,8 +242,11 @@ KOKKOS_FUNCTION void ThermalOperatorQuad<
 
       state_ratios[solid] = 1. - state_ratios[liquid] - state_ratios[powder];
 
-      _powder_ratio(pos) = state_ratios[powder];
-      _liquid_ratio(pos) = state_ratios[liquid];
+      if (!_frozen_state)
+      {
+        _powder_ratio(pos) = state_ratios[powder];
+        _liquid_ratio(pos) = state_ratios[liquid];
+      }
     }
   }
 }
@@ -297,9 +319,10 @@ KOKKOS_FUNCTION double ThermalOperatorQuad<dim, n_materials, use_table, p_order,
                adamantine::MaterialProperty<dim, n_materials, p_order,
                                             MaterialStates,
                                             dealii::MemorySpace::Default>::
-                   compute_property_from_table(_state_property_tables, m_id,
-                                               property_index, material_state,
-                                               temperature);
+                   compute_property_from_samples(
+                       _state_property_tables, _state_property_sample_intervals,
+                       _state_property_sample_grids, m_id, property_index,
+                       material_state, temperature);
     }
   }
   else
@@ -401,6 +424,8 @@ class LocalThermalOperatorDevice
 {
 public:
   using kokkos_default = dealii::MemorySpace::Default::kokkos_space;
+  // The tables are only read, which allows Kokkos to use the texture cache.
+  using random_access = Kokkos::MemoryTraits<Kokkos::RandomAccess>;
 
   LocalThermalOperatorDevice(
       Kokkos::View<double *, kokkos_default> cos,
@@ -410,13 +435,22 @@ public:
       Kokkos::View<dealii::types::material_id *, kokkos_default> material_id,
       Kokkos::View<double *, kokkos_default> inv_rho_cp,
       Kokkos::View<double **, kokkos_default> properties,
-      Kokkos::View<double *****, kokkos_default> state_property_tables,
-      Kokkos::View<double ****, kokkos_default> state_property_polynomials)
+      Kokkos::View<double const *****, kokkos_default, random_access>
+          state_property_tables,
+      Kokkos::View<unsigned int const ****, kokkos_default, random_access>
+          state_property_sample_intervals,
+      Kokkos::View<double const ****, kokkos_default, random_access>
+          state_property_sample_grids,
+      Kokkos::View<double ****, kokkos_default> state_property_polynomials,
+      bool frozen_state)
       : _cos(cos), _sin(sin), _powder_ratio(powder_ratio),
         _liquid_ratio(liquid_ratio), _material_id(material_id),
         _inv_rho_cp(inv_rho_cp), _properties(properties),
         _state_property_tables(state_property_tables),
-        _state_property_polynomials(state_property_polynomials)
+        _state_property_sample_intervals(state_property_sample_intervals),
+        _state_property_sample_grids(state_property_sample_grids),
+        _state_property_polynomials(state_property_polynomials),
+        _frozen_state(frozen_state)
   {
   }
 
@@ -449,8 +483,14 @@ private:
   Kokkos::View<dealii::types::material_id *, kokkos_default> _material_id;
   Kokkos::View<double *, kokkos_default> _inv_rho_cp;
   Kokkos::View<double **, kokkos_default> _properties;
-  Kokkos::View<double *****, kokkos_default> _state_property_tables;
+  Kokkos::View<double const *****, kokkos_default, random_access>
+      _state_property_tables;
+  Kokkos::View<unsigned int const ****, kokkos_default, random_access>
+      _state_property_sample_intervals;
+  Kokkos::View<double const ****, kokkos_default, random_access>
+      _state_property_sample_grids;
   Kokkos::View<double ****, kokkos_default> _state_property_polynomials;
+  bool _frozen_state;
 };
 
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
@@ -490,7 +530,8 @@ operator()(
                       MaterialStates>
       quad(cell, gpu_data, _cos, _sin, _powder_ratio, _liquid_ratio,
            _material_id, _inv_rho_cp, _properties, _state_property_tables,
-           _state_property_polynomials);
+           _state_property_sample_intervals, _state_property_sample_grids,
+           _state_property_polynomials, _frozen_state);
 #if DEAL_II_VERSION_GTE(9, 8, 0)
   gpu_data->for_each_quad_point([&](const int &q_point)
                                 { quad(&fe_eval, q_point); });
@@ -647,6 +688,33 @@ void ThermalOperatorDevice<dim, n_materials, use_table, p_order, fe_degree,
   vmult_add(dst, src);
 }
 
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperatorDevice<dim, n_materials, use_table, p_order, fe_degree,
+                           MaterialStates, MemorySpaceType>::
+    vmult_frozen_state(
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+        const
+{
+  _frozen_state = true;
+  vmult(dst, src);
+  _frozen_state = false;
+}
+
+template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperatorDevice<dim, n_materials, use_table, p_order, fe_degree,
+                           MaterialStates, MemorySpaceType>::
+    update_state(dealii::LA::distributed::Vector<double, MemorySpaceType> const
+                     &src) const
+{
+  // The state ratios are computed inside the operator kernel, so the operator
+  // is applied. The result is stored in a buffer that is reused.
+  _state_update.reinit(src, true);
+  vmult(_state_update, src);
+}
+
 template <int dim, int n_materials, bool use_table, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType>
 void ThermalOperatorDevice<dim, n_materials, use_table, p_order, fe_degree,
@@ -663,7 +731,10 @@ void ThermalOperatorDevice<dim, n_materials, use_table, p_order, fe_degree,
                      _liquid_ratio, _material_id, _inv_rho_cp,
                      _material_properties.get_properties(),
                      _material_properties.get_state_property_tables(),
-                     _material_properties.get_state_property_polynomials());
+                     _material_properties.get_state_property_sample_intervals(),
+                     _material_properties.get_state_property_sample_grids(),
+                     _material_properties.get_state_property_polynomials(),
+                     _frozen_state);
   _matrix_free.cell_loop(local_operator, src, dst);
   _matrix_free.copy_constrained_values(src, dst);
 }
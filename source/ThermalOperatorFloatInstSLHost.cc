@@ -0,0 +1,8 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <ThermalOperator.templates.hh>
+#include <instantiation.hh>
+
+INSTANTIATE_DIM_NMAT_USETABLE_PORDER_FEDEGREE_SL_HOST_FLOAT(ThermalOperator)
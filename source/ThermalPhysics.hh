@@ -6,8 +6,12 @@
 #define THERMAL_PHYSICS_HH
 
 #include <Boundary.hh>
+#include <CellDataBuffer.hh>
+#include <EnthalpyTable.hh>
 #include <Geometry.hh>
 #include <HeatSource.hh>
+#include <ImplicitOperator.hh>
+#include <ThermalMultigridPreconditioner.hh>
 #include <ThermalOperatorBase.hh>
 #include <ThermalPhysicsInterface.hh>
 
@@ -76,6 +80,10 @@ public:
       dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
       std::vector<Timer> &timers) override;
 
+  bool has_adaptive_time_stepping() const override;
+
+  double get_next_time_step() const override;
+
   void
   initialize_dof_vector(double const value,
                         dealii::LA::distributed::Vector<double, MemorySpaceType>
@@ -119,6 +127,21 @@ public:
 
   unsigned int get_fe_degree() const override;
 
+  CellDataBuffer &get_data_to_transfer() override;
+
+  CellDataBuffer &get_transferred_data() override;
+
+  /**
+   * Return the volumetric enthalpy at the end of the last time step. The
+   * vector is only used by the enthalpy formulation and it is empty before the
+   * first time step.
+   */
+  dealii::LA::distributed::Vector<double, MemorySpaceType> const &
+  get_enthalpy() const;
+
+  dealii::LA::distributed::Vector<double, MemorySpaceType> &
+  get_enthalpy() override;
+
 private:
   using LA_Vector =
       typename dealii::LA::distributed::Vector<double, MemorySpaceType>;
@@ -130,15 +153,165 @@ private:
   void update_material_deposition_orientation();
 
   /**
-   * Compute the right-hand side and apply the TermalOperator.
+   * Compute the right-hand side and apply the TermalOperator. If
+   * @p frozen_state is true, the material state is not updated.
    */
   LA_Vector evaluate_thermal_physics(double const t, LA_Vector const &y,
-                                     std::vector<Timer> &timers) const;
+                                     std::vector<Timer> &timers,
+                                     bool const frozen_state = false) const;
+
+  /**
+   * Same as above but the result is written in @p value. The memory of
+   * @p value is reused if it already uses the partitioner of @p y.
+   */
+  void evaluate_thermal_physics(double const t, LA_Vector const &y,
+                                LA_Vector &value,
+                                std::vector<Timer> &timers) const;
+
+  /**
+   * Compute \f$ (I - \tau J)^{-1} y \f$ where \f$ J \f$ is the Jacobian of
+   * the thermal physics linearized around the last state passed to
+   * evaluate_thermal_physics. This function is used by the implicit time
+   * stepping schemes.
+   */
+  LA_Vector id_minus_tau_J_inverse(double const t, double const tau,
+                                   LA_Vector const &y,
+                                   std::vector<Timer> &timers) const;
+
+  /**
+   * Compute the number of multirate micro steps between two updates of each
+   * DoF. The period of a DoF is set by the finest cell it belongs to.
+   */
+  void compute_multirate_periods();
+
+  /**
+   * Evolve the solution using the multirate forward Euler scheme.
+   */
+  double evolve_multirate(double const t, double const delta_t,
+                          LA_Vector &solution, std::vector<Timer> &timers);
+
+  /**
+   * Evolve the solution using a low-storage Runge-Kutta scheme. Each stage is
+   * performed by ThermalOperator::low_storage_rk_stage in a single pass over
+   * the data.
+   */
+  double evolve_low_storage(double const t, double const delta_t,
+                            LA_Vector &solution, std::vector<Timer> &timers);
+
+  /**
+   * Compute the material id associated with each DoF. It is used to convert
+   * between the temperature and the enthalpy.
+   */
+  void compute_dof_material_ids();
+
+  /**
+   * Evolve the solution using the enthalpy formulation. The time stepping
+   * scheme advances the volumetric enthalpy and the temperature is recovered
+   * using the EnthalpyTable.
+   */
+  double evolve_enthalpy(double const t, double const delta_t,
+                         LA_Vector &solution, std::vector<Timer> &timers);
+
+  /**
+   * Compute the volumetric enthalpy at the locally owned DoFs given the
+   * temperature.
+   */
+  void temperature_to_enthalpy(LA_Vector const &temperature,
+                               LA_Vector &enthalpy) const;
+
+  /**
+   * Compute the temperature at the locally owned DoFs given the volumetric
+   * enthalpy.
+   */
+  void enthalpy_to_temperature(LA_Vector const &enthalpy,
+                               LA_Vector &temperature) const;
+
+  /**
+   * Return the weight of @p cell used for load balancing. The weight models
+   * the cost of the cell in the evaluation of the thermal physics once it uses
+   * @p future_fe: the cell integral, the face integrals of the convective and
+   * radiative boundary conditions on the boundary of the domain and on the
+   * interface with the cells using FE_Nothing, and the evaluation of the heat
+   * sources. The cells using FE_Nothing are only visited by the loops over all
+   * the cells.
+   */
+  unsigned int compute_cell_weight(
+      typename dealii::DoFHandler<dim>::cell_iterator const &cell,
+      dealii::FiniteElement<dim> const &future_fe) const;
 
   /**
    * This flag is true if the time stepping method is forward euler.
    */
   bool _forward_euler = false;
+  /**
+   * This flag is true if the time stepping method is the multirate forward
+   * euler.
+   */
+  bool _multirate = false;
+  /**
+   * Number of micro steps in a multirate time step, i.e., the number of
+   * updates of the DoFs of the finest cells.
+   */
+  unsigned int _n_micro_steps = 1;
+  /**
+   * Number of micro steps between two updates of each DoF.
+   */
+  LA_Vector _multirate_periods;
+  /**
+   * Scratch vectors of the multirate scheme. They are kept between time steps
+   * to avoid allocating new vectors at every micro step.
+   */
+  LA_Vector _multirate_start;
+  LA_Vector _multirate_end;
+  LA_Vector _multirate_value;
+  /**
+   * Coefficients \f$ a_i \f$ of the low-storage Runge-Kutta scheme. The
+   * vectors are empty if another time stepping method is used.
+   */
+  std::vector<double> _low_storage_a;
+  /**
+   * Weights \f$ b_i \f$ of the low-storage Runge-Kutta scheme.
+   */
+  std::vector<double> _low_storage_b;
+  /**
+   * Nodes \f$ c_i \f$ of the low-storage Runge-Kutta scheme.
+   */
+  std::vector<double> _low_storage_c;
+  /**
+   * Registers of the low-storage Runge-Kutta scheme. They are kept between
+   * time steps to avoid allocating new vectors.
+   */
+  LA_Vector _low_storage_ri;
+  LA_Vector _low_storage_ki;
+  /**
+   * Table of the enthalpy used by the enthalpy formulation. The pointer is null
+   * if the temperature formulation is used.
+   */
+  std::unique_ptr<EnthalpyTable<dim, n_materials, p_order, MaterialStates,
+                                MemorySpaceType>>
+      _enthalpy_table;
+  /**
+   * Material id associated with each DoF. Only used by the enthalpy
+   * formulation.
+   */
+  LA_Vector _dof_material_ids;
+  /**
+   * Volumetric enthalpy at the end of the last time step. Only used by the
+   * enthalpy formulation.
+   */
+  LA_Vector _enthalpy;
+  /**
+   * Temperature computed from _enthalpy at the end of the last time step. It
+   * is used to detect the DoFs whose temperature was modified between two time
+   * steps. Only used by the enthalpy formulation.
+   */
+  LA_Vector _enthalpy_temperature;
+  /**
+   * Temperature recovered from the enthalpy at each stage of the time
+   * stepping scheme. It is resized when the DoFs are set up. Only used by the
+   * enthalpy formulation.
+   */
+  LA_Vector _stage_temperature;
   /**
    * Associated geometry.
    */
@@ -165,7 +338,7 @@ private:
   dealii::hp::QCollection<1> _q_collection;
   /**
    * Object used to attach to each cell, a weight (used for load balancing)
-   * equal to the number of degrees of freedom associated with the cell.
+   * computed by compute_cell_weight().
    */
   dealii::parallel::CellWeights<dim> _cell_weights;
   /**
@@ -204,14 +377,68 @@ private:
    */
   std::unique_ptr<dealii::TimeStepping::ExplicitRungeKutta<LA_Vector>>
       _time_stepping;
+  /**
+   * Unique pointer to the underlying implicit time stepping scheme. The pointer
+   * is null if the time stepping scheme is explicit.
+   */
+  std::unique_ptr<dealii::TimeStepping::ImplicitRungeKutta<LA_Vector>>
+      _implicit_time_stepping;
+  /**
+   * Unique pointer to the underlying embedded explicit time stepping scheme.
+   * The pointer is null if the time step is not adaptive.
+   */
+  std::unique_ptr<dealii::TimeStepping::EmbeddedExplicitRungeKutta<LA_Vector>>
+      _embedded_time_stepping;
+  /**
+   * Time step suggested by the embedded time stepping scheme for the next time
+   * step.
+   */
+  double _next_time_step = 0.;
+  /**
+   * Operator \f$ I - \tau J \f$ used by the implicit time stepping schemes.
+   */
+  std::unique_ptr<ImplicitOperator<dim, MemorySpaceType>> _implicit_operator;
+  /**
+   * Maximum number of iterations of the Krylov solver used by the implicit
+   * time stepping schemes.
+   */
+  unsigned int _max_iter = 1000;
+  /**
+   * Relative tolerance of the Krylov solver used by the implicit time stepping
+   * schemes.
+   */
+  double _tolerance = 1e-12;
+  /**
+   * Number of temporary vectors used by GMRES, i.e., the restart length.
+   */
+  unsigned int _n_tmp_vectors = 30;
+  /**
+   * Preconditioner used by the implicit time stepping schemes.
+   */
+  ImplicitPreconditioner _preconditioner_type =
+      ImplicitPreconditioner::identity;
+  /**
+   * Degree of the Chebyshev polynomial used by the preconditioners.
+   */
+  unsigned int _chebyshev_degree = 3;
+  /**
+   * Polynomial multigrid preconditioner. Only used on the host.
+   */
+  std::unique_ptr<ThermalMultigridPreconditioner<
+      dim, n_materials, p_order, MaterialStates, QuadratureType>>
+      _multigrid;
+  /**
+   * Flag set to false when the multigrid preconditioner needs to be rebuilt,
+   * i.e., when the DoFHandler, the material state, or the deposition
+   * orientation has changed.
+   */
+  bool _multigrid_up_to_date = false;
   /**
    * Cell data transfer object used for updating _solution, _has_melted,
    * _deposition_cos, _deposition_sin, and state of _material_properties when
    * the triangulation is updated when adding material
    */
-  std::unique_ptr<dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>>
-      _cell_data_trans;
+  std::unique_ptr<CellDataBufferTransfer<dim>> _cell_data_trans;
 
   /**
    * Temporary data used in _cell_data_trans for _solution
@@ -219,9 +446,12 @@ private:
   dealii::Vector<double> _cell_solution;
 
   /**
-   * Temporary data used in _cell_data_trans for transfer
+   * Temporary data used in _cell_data_trans for transfer. The buffers are
+   * reused by all the mesh updates, including the refinement and the
+   * repartitioning done in the application.
    */
-  std::vector<std::vector<double>> _data_to_transfer;
+  CellDataBuffer _data_to_transfer;
+  CellDataBuffer _transferred_data;
 };
 
 template <int dim, int n_materials, int p_order, int fe_degree,
@@ -234,6 +464,7 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
 {
   _thermal_operator->set_material_deposition_orientation(_deposition_cos,
                                                          _deposition_sin);
+  _multigrid_up_to_date = false;
 }
 
 template <int dim, int n_materials, int p_order, int fe_degree,
@@ -250,6 +481,47 @@ inline void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   update_material_deposition_orientation();
 }
 
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+inline bool
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::has_adaptive_time_stepping()
+    const
+{
+  return _embedded_time_stepping != nullptr;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+inline double
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::get_next_time_step() const
+{
+  return _next_time_step;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+inline dealii::LA::distributed::Vector<double, MemorySpaceType> const &
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::get_enthalpy() const
+{
+  return _enthalpy;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+inline dealii::LA::distributed::Vector<double, MemorySpaceType> &
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::get_enthalpy()
+{
+  return _enthalpy;
+}
+
 template <int dim, int n_materials, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType,
           typename QuadratureType>
@@ -342,6 +614,26 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
 {
   return fe_degree;
 }
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+inline CellDataBuffer &
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::get_data_to_transfer()
+{
+  return _data_to_transfer;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+inline CellDataBuffer &
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::get_transferred_data()
+{
+  return _transferred_data;
+}
 } // namespace adamantine
 
 #endif
@@ -24,16 +24,21 @@
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/hp/q_collection.h>
+#include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/precondition.h>
 #include <deal.II/lac/read_write_vector.h>
+#include <deal.II/lac/solver_control.h>
 #include <deal.II/lac/solver_gmres.h>
 #include <deal.II/lac/vector_operation.h>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #ifdef ADAMANTINE_WITH_CALIPER
 #include <caliper/cali.h>
 #endif
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 
 namespace adamantine
@@ -44,25 +49,28 @@ template <int dim, int fe_degree, typename MemorySpaceType,
           std::enable_if_t<
               std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value,
               int> = 0>
-dealii::LA::distributed::Vector<double, MemorySpaceType>
-evaluate_thermal_physics_impl(
+void evaluate_thermal_physics_impl(
     std::shared_ptr<ThermalOperatorBase<dim, MemorySpaceType>> thermal_operator,
     dealii::hp::FECollection<dim> const &fe_collection,
     double const t,
     dealii::DoFHandler<dim> const &dof_handler,
     std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources,
-    bool const print_heat_input,
+    bool const print_heat_input, bool const frozen_state,
     dealii::LA::distributed::Vector<double, MemorySpaceType> const &y,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> &value,
     std::vector<Timer> &timers)
 {
   timers[evol_time_eval_th_ph].start();
   thermal_operator->set_time(t);
 
-  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> value(
-      y.get_partitioner());
-  value = 0.;
+  // reinit does not allocate new memory if value already uses the partitioner
+  // of y.
+  value.reinit(y, true);
   // Apply the Thermal Operator.
-  thermal_operator->vmult_add(value, y);
+  if (frozen_state)
+    thermal_operator->vmult_frozen_state(value, y);
+  else
+    thermal_operator->vmult(value, y);
 
   // Integrate the total heat added to the system
   if (print_heat_input)
@@ -119,8 +127,6 @@ evaluate_thermal_physics_impl(
   value.scale(*thermal_operator->get_inverse_mass_matrix());
 
   timers[evol_time_eval_th_ph].stop();
-
-  return value;
 }
 
 template <int dim, int fe_degree, typename MemorySpaceType,
@@ -148,7 +154,7 @@ evaluate_thermal_physics_impl(
     dealii::hp::FECollection<dim> const &fe_collection, double const t,
     dealii::DoFHandler<dim> const &dof_handler,
     std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources,
-    bool const print_heat_input,
+    bool const print_heat_input, bool const frozen_state,
     Boundary const &boundary,
     MaterialProperty<dim, n_materials, p_order, MaterialStates, MemorySpaceType>
         &material_properties,
@@ -169,12 +175,21 @@ evaluate_thermal_physics_impl(
       y.get_partitioner());
 
   // Apply the Thermal Operator.
-  thermal_operator_dev->vmult(value_dev, y);
+  if (frozen_state)
+    thermal_operator_dev->vmult_frozen_state(value_dev, y);
+  else
+    thermal_operator_dev->vmult(value_dev, y);
 
-  // Compute the source term.
-  // TODO do this on the GPU
+  // Compute the source term. The heat sources are evaluated on the host with
+  // their batched SIMD kernels: the quadrature points of a cell are packed in
+  // VectorizedArray and each heat source is called once per cell.
+  std::vector<dealii::BoundingBox<dim>> supports;
   for (auto &beam : heat_sources)
+  {
     beam->update_time(t);
+    if (beam->is_source_on())
+      supports.push_back(beam->get_support_bounding_box());
+  }
   dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> source(
       y.get_partitioner());
   source = 0.;
@@ -200,6 +215,11 @@ evaluate_thermal_physics_impl(
           dealii::update_JxW_values);
   unsigned int const n_face_q_points = face_quadrature.size();
   dealii::Vector<double> cell_source(dofs_per_cell);
+  unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
+  unsigned int const n_q_batches = (n_q_points + n_lanes - 1) / n_lanes;
+  std::vector<dealii::Point<dim, dealii::VectorizedArray<double>>>
+      q_point_batches(n_q_batches);
+  std::vector<dealii::VectorizedArray<double>> q_source_batches(n_q_batches);
   bool const adiabatic_only_bc =
       boundary.get_boundary_ids(BoundaryType::adiabatic).size() ==
       boundary.n_boundary_ids();
@@ -216,28 +236,51 @@ evaluate_thermal_physics_impl(
            dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
   {
     cell_source = 0.;
-    hp_fe_values.reinit(cell);
-    dealii::FEValues<dim> const &fe_values =
-        hp_fe_values.get_present_fe_values();
 
-    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+    // Only evaluate the heat sources on the cells that intersect one of them.
+    dealii::BoundingBox<dim> const cell_bounding_box = cell->bounding_box();
+    bool const heat_sources_on = std::any_of(
+        supports.begin(), supports.end(),
+        [&](dealii::BoundingBox<dim> const &support)
+        {
+          return cell_bounding_box.get_neighbor_type(support) !=
+                 dealii::NeighborType::not_neighbors;
+        });
+    if (heat_sources_on)
     {
-      for (unsigned int q = 0; q < n_q_points; ++q)
+      hp_fe_values.reinit(cell);
+      dealii::FEValues<dim> const &fe_values =
+          hp_fe_values.get_present_fe_values();
+
+      // The unused lanes of the last batch are padded with the last
+      // quadrature point.
+      for (unsigned int q = 0; q < n_q_batches * n_lanes; ++q)
+      {
+        dealii::Point<dim> const &q_point =
+            fe_values.quadrature_point(std::min(q, n_q_points - 1));
+        for (unsigned int d = 0; d < dim; ++d)
+          q_point_batches[q / n_lanes][d][q % n_lanes] = q_point[d];
+      }
+      for (auto &source : q_source_batches)
+        source = 0.;
+      for (auto &beam : heat_sources)
+        beam->add_values(q_point_batches, q_source_batches);
+
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
       {
-        double const inv_rho_cp = thermal_operator_dev->get_inv_rho_cp(cell, q);
-        double quad_pt_source = 0.;
-        dealii::Point<dim> const &q_point = fe_values.quadrature_point(q);
-        for (auto &beam : heat_sources)
+        for (unsigned int q = 0; q < n_q_points; ++q)
         {
-          quad_pt_source += beam->value(q_point);
-        }
-        
-        cell_source[i] += inv_rho_cp * quad_pt_source *
-                          fe_values.shape_value(i, q) * fe_values.JxW(q);
-                            
-        heat_added += quad_pt_source *
-                      fe_values.shape_value(i, q) * fe_values.JxW(q);
+          double const inv_rho_cp =
+              thermal_operator_dev->get_inv_rho_cp(cell, q);
+          double const quad_pt_source =
+              q_source_batches[q / n_lanes][q % n_lanes];
+
+          cell_source[i] += inv_rho_cp * quad_pt_source *
+                            fe_values.shape_value(i, q) * fe_values.JxW(q);
 
+          heat_added += quad_pt_source * fe_values.shape_value(i, q) *
+                        fe_values.JxW(q);
+        }
       }
     }
 
@@ -357,7 +400,9 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
       _dof_handler(_geometry.get_triangulation()),
       _cell_weights(
           _dof_handler,
-          dealii::parallel::CellWeights<dim>::ndofs_weighting({1, 1})),
+          [this](typename dealii::DoFHandler<dim>::cell_iterator const &cell,
+                 dealii::FiniteElement<dim> const &future_fe)
+          { return compute_cell_weight(cell, future_fe); }),
       _material_properties(material_properties)
 {
   // Create the FECollection
@@ -411,25 +456,81 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   }
 
   // Create the thermal operator
+  // PropertyTreeInput discretization.thermal.precision
+  bool const single_precision = boost::iequals(
+      database.get<std::string>("discretization.thermal.precision", "double"),
+      "single");
+  // PropertyTreeInput discretization.thermal.formulation
+  bool const enthalpy_formulation = boost::iequals(
+      database.get<std::string>("discretization.thermal.formulation",
+                                "temperature"),
+      "enthalpy");
+  if (enthalpy_formulation)
+  {
+    ASSERT_THROW(
+        (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>),
+        "The enthalpy formulation is only available on the host.");
+    ASSERT_THROW(
+        (!std::is_same_v<MaterialStates, SolidLiquidPowder>),
+        "The enthalpy formulation does not support materials with powder.");
+    // PropertyTreeInput materials.n_materials
+    unsigned int const n_material_ids =
+        database.get<unsigned int>("materials.n_materials");
+    // PropertyTreeInput discretization.thermal.enthalpy_max_temperature
+    double const enthalpy_max_temperature = database.get(
+        "discretization.thermal.enthalpy_max_temperature", 4000.);
+    _enthalpy_table = std::make_unique<EnthalpyTable<
+        dim, n_materials, p_order, MaterialStates, MemorySpaceType>>(
+        _material_properties, n_material_ids, enthalpy_max_temperature);
+  }
   if (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value)
   {
+    // PropertyTreeInput time_stepping.coefficient_cache_tolerance
+    double const coefficient_cache_tolerance =
+        database.get("time_stepping.coefficient_cache_tolerance", 0.);
     if (_material_properties.properties_use_table())
     {
-      _thermal_operator = std::make_shared<
-          ThermalOperator<dim, n_materials, true, p_order, fe_degree,
-                          MaterialStates, MemorySpaceType>>(
-          communicator, _boundary, _material_properties, _heat_sources);
+      if (single_precision)
+      {
+        _thermal_operator = std::make_shared<
+            ThermalOperator<dim, n_materials, true, p_order, fe_degree,
+                            MaterialStates, MemorySpaceType, float>>(
+            communicator, _boundary, _material_properties, _heat_sources,
+            coefficient_cache_tolerance, enthalpy_formulation);
+      }
+      else
+      {
+        _thermal_operator = std::make_shared<
+            ThermalOperator<dim, n_materials, true, p_order, fe_degree,
+                            MaterialStates, MemorySpaceType>>(
+            communicator, _boundary, _material_properties, _heat_sources,
+            coefficient_cache_tolerance, enthalpy_formulation);
+      }
     }
     else
     {
-      _thermal_operator = std::make_shared<
-          ThermalOperator<dim, n_materials, false, p_order, fe_degree,
-                          MaterialStates, MemorySpaceType>>(
-          communicator, _boundary, _material_properties, _heat_sources);
+      if (single_precision)
+      {
+        _thermal_operator = std::make_shared<
+            ThermalOperator<dim, n_materials, false, p_order, fe_degree,
+                            MaterialStates, MemorySpaceType, float>>(
+            communicator, _boundary, _material_properties, _heat_sources,
+            coefficient_cache_tolerance, enthalpy_formulation);
+      }
+      else
+      {
+        _thermal_operator = std::make_shared<
+            ThermalOperator<dim, n_materials, false, p_order, fe_degree,
+                            MaterialStates, MemorySpaceType>>(
+            communicator, _boundary, _material_properties, _heat_sources,
+            coefficient_cache_tolerance, enthalpy_formulation);
+      }
     }
   }
   else
   {
+    ASSERT_THROW(!single_precision,
+                 "Single precision is only available on the host.");
     if (_material_properties.properties_use_table())
     {
       _thermal_operator = std::make_shared<
@@ -457,6 +558,28 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   {
     _forward_euler = true;
   }
+  else if (method.compare("multirate_forward_euler") == 0)
+  {
+    ASSERT_THROW(
+        (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>),
+        "Multirate time stepping is only available on the host.");
+    _multirate = true;
+  }
+  else if ((method.compare("low_storage_rk_third_order") == 0) ||
+           (method.compare("low_storage_rk_fourth_order") == 0))
+  {
+    ASSERT_THROW(
+        (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>),
+        "Low-storage Runge-Kutta time stepping is only available on the host.");
+    // The schemes of Kennedy, Carpenter, and Lewis only need two registers in
+    // addition to the solution.
+    dealii::TimeStepping::LowStorageRungeKutta<LA_Vector> low_storage_rk(
+        method.compare("low_storage_rk_third_order") == 0
+            ? dealii::TimeStepping::LOW_STORAGE_RK_STAGE3_ORDER3
+            : dealii::TimeStepping::LOW_STORAGE_RK_STAGE5_ORDER4);
+    low_storage_rk.get_coefficients(_low_storage_a, _low_storage_b,
+                                    _low_storage_c);
+  }
   else if (method.compare("rk_third_order") == 0)
   {
     _time_stepping =
@@ -469,6 +592,135 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
         std::make_unique<dealii::TimeStepping::ExplicitRungeKutta<LA_Vector>>(
             dealii::TimeStepping::RK_CLASSIC_FOURTH_ORDER);
   }
+  else if ((method.compare("bogacki_shampine") == 0) ||
+           (method.compare("dopri") == 0))
+  {
+    // The embedded schemes estimate the local error using a lower order
+    // solution. The time step is decreased when the l2 norm of the error is
+    // larger than error_tolerance and it is increased when the error is smaller
+    // than coarsening_tolerance.
+    // PropertyTreeInput time_stepping.error_tolerance
+    double const refine_tol =
+        time_stepping_database.get("error_tolerance", 1e-3);
+    // PropertyTreeInput time_stepping.coarsening_tolerance
+    double const coarsen_tol =
+        time_stepping_database.get("coarsening_tolerance", 1e-2 * refine_tol);
+    // PropertyTreeInput time_stepping.refining_factor
+    double const refine_param =
+        time_stepping_database.get("refining_factor", 0.8);
+    // PropertyTreeInput time_stepping.coarsening_factor
+    double const coarsen_param =
+        time_stepping_database.get("coarsening_factor", 1.2);
+    // PropertyTreeInput time_stepping.min_time_step
+    double const min_delta =
+        time_stepping_database.get("min_time_step", 1e-14);
+    // PropertyTreeInput time_stepping.max_time_step
+    double const max_delta = time_stepping_database.get(
+        "max_time_step", std::numeric_limits<double>::max());
+    _embedded_time_stepping = std::make_unique<
+        dealii::TimeStepping::EmbeddedExplicitRungeKutta<LA_Vector>>(
+        method.compare("dopri") == 0 ? dealii::TimeStepping::DOPRI
+                                     : dealii::TimeStepping::BOGACKI_SHAMPINE,
+        coarsen_param, refine_param, min_delta, max_delta, refine_tol,
+        coarsen_tol);
+  }
+  else
+  {
+    // The implicit schemes use a Newton solver for the nonlinearity introduced
+    // by the temperature-dependent material properties. The linear systems are
+    // solved matrix-free using GMRES.
+    // PropertyTreeInput time_stepping.newton_max_iteration
+    unsigned int const newton_max_iter =
+        time_stepping_database.get("newton_max_iteration", 100);
+    // PropertyTreeInput time_stepping.newton_tolerance
+    double const newton_tolerance =
+        time_stepping_database.get("newton_tolerance", 1e-6);
+    // PropertyTreeInput time_stepping.max_iteration
+    _max_iter = time_stepping_database.get("max_iteration", _max_iter);
+    // PropertyTreeInput time_stepping.tolerance
+    _tolerance = time_stepping_database.get("tolerance", _tolerance);
+    // PropertyTreeInput time_stepping.n_tmp_vectors
+    _n_tmp_vectors =
+        time_stepping_database.get("n_tmp_vectors", _n_tmp_vectors);
+
+    dealii::TimeStepping::runge_kutta_method implicit_method =
+        dealii::TimeStepping::BACKWARD_EULER;
+    if (method.compare("backward_euler") == 0)
+    {
+      implicit_method = dealii::TimeStepping::BACKWARD_EULER;
+    }
+    else if (method.compare("implicit_midpoint") == 0)
+    {
+      implicit_method = dealii::TimeStepping::IMPLICIT_MIDPOINT;
+    }
+    else if (method.compare("crank_nicolson") == 0)
+    {
+      implicit_method = dealii::TimeStepping::CRANK_NICOLSON;
+    }
+    else if (method.compare("sdirk2") == 0)
+    {
+      implicit_method = dealii::TimeStepping::SDIRK_TWO_STAGES;
+    }
+    else
+    {
+      ASSERT_THROW(false, "Time stepping method '" + method +
+                              "' not recognized.");
+    }
+
+    _implicit_time_stepping =
+        std::make_unique<dealii::TimeStepping::ImplicitRungeKutta<LA_Vector>>(
+            implicit_method, newton_max_iter, newton_tolerance);
+    _implicit_operator =
+        std::make_unique<ImplicitOperator<dim, MemorySpaceType>>(
+            _thermal_operator);
+
+    // PropertyTreeInput time_stepping.preconditioner
+    std::string preconditioner =
+        time_stepping_database.get<std::string>("preconditioner", "identity");
+    std::transform(preconditioner.begin(), preconditioner.end(),
+                   preconditioner.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    // PropertyTreeInput time_stepping.chebyshev_degree
+    _chebyshev_degree =
+        time_stepping_database.get("chebyshev_degree", _chebyshev_degree);
+    if (preconditioner.compare("identity") == 0)
+    {
+      _preconditioner_type = ImplicitPreconditioner::identity;
+    }
+    else if (preconditioner.compare("chebyshev") == 0)
+    {
+      _preconditioner_type = ImplicitPreconditioner::chebyshev;
+    }
+    else if (preconditioner.compare("multigrid") == 0)
+    {
+      _preconditioner_type = ImplicitPreconditioner::multigrid;
+      if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+      {
+        _multigrid = std::make_unique<ThermalMultigridPreconditioner<
+            dim, n_materials, p_order, MaterialStates, QuadratureType>>(
+            communicator, _boundary, _material_properties, _chebyshev_degree);
+      }
+      else
+      {
+        ASSERT_THROW(false,
+                     "The multigrid preconditioner is only available on the "
+                     "host.");
+      }
+    }
+    else
+    {
+      ASSERT_THROW(false, "Preconditioner '" + preconditioner +
+                              "' not recognized.");
+    }
+  }
+  // The enthalpy is integrated by the generic explicit schemes. The other
+  // schemes work directly on the temperature.
+  ASSERT_THROW(!_enthalpy_table ||
+                   (!_multirate && _low_storage_c.empty() &&
+                    !_implicit_time_stepping),
+               "The enthalpy formulation only supports the forward Euler, the "
+               "explicit Runge-Kutta, and the embedded Runge-Kutta methods.");
+
   // Set material on part of the domain
   // PropertyTreeInput geometry.material_height
   double const material_height = database.get("geometry.material_height", 1e9);
@@ -521,6 +773,186 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   _affine_constraints.close();
 
   _thermal_operator->reinit(_dof_handler, _affine_constraints, _q_collection);
+  if (_multirate)
+    compute_multirate_periods();
+  if (_enthalpy_table)
+  {
+    compute_dof_material_ids();
+    _thermal_operator->initialize_dof_vector(_stage_temperature);
+    // The enthalpy kept between time steps uses the previous DoFs. The mesh
+    // updates interpolate it on the new DoFs with the solution. Otherwise, it
+    // is recomputed from the temperature at the next time step.
+    _enthalpy.reinit(0);
+    _enthalpy_temperature.reinit(0);
+  }
+  _multigrid_up_to_date = false;
+  // The first-same-as-last stage stored by the embedded schemes is only valid
+  // on the previous discretization.
+  if (_embedded_time_stepping)
+    _embedded_time_stepping->free_memory();
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                    MemorySpaceType,
+                    QuadratureType>::compute_multirate_periods()
+{
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    // Find the range of refinement levels of the activated cells.
+    int min_level = std::numeric_limits<int>::max();
+    int max_level = 0;
+    for (auto const &cell : dealii::filter_iterators(
+             _dof_handler.active_cell_iterators(),
+             dealii::IteratorFilters::LocallyOwnedCell(),
+             dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+    {
+      min_level = std::min(min_level, cell->level());
+      max_level = std::max(max_level, cell->level());
+    }
+    MPI_Comm const communicator = _dof_handler.get_communicator();
+    min_level = dealii::Utilities::MPI::min(min_level, communicator);
+    max_level = dealii::Utilities::MPI::max(max_level, communicator);
+    if (min_level > max_level)
+      min_level = max_level;
+    // The cells of the finest level are updated at every micro step. Each
+    // coarser level halves the number of updates.
+    _n_micro_steps = 1u << (max_level - min_level);
+
+    // The period of a DoF is the smallest period of the cells it belongs to.
+    // The cells owned by other processors may contribute to the locally owned
+    // DoFs, so we also write in the ghost entries and reduce them using the
+    // minimum.
+    _thermal_operator->initialize_dof_vector(_multirate_periods);
+    unsigned int const local_size =
+        _multirate_periods.locally_owned_size() +
+        _multirate_periods.get_partitioner()->n_ghost_indices();
+    for (unsigned int i = 0; i < local_size; ++i)
+      _multirate_periods.local_element(i) = _n_micro_steps;
+    std::vector<dealii::types::global_dof_index> dof_indices;
+    for (auto const &cell : dealii::filter_iterators(
+             _dof_handler.active_cell_iterators(),
+             dealii::IteratorFilters::LocallyOwnedCell(),
+             dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+    {
+      double const cell_period = 1u << (max_level - cell->level());
+      dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+      cell->get_dof_indices(dof_indices);
+      for (auto const dof : dof_indices)
+        _multirate_periods(dof) =
+            std::min(_multirate_periods(dof), cell_period);
+    }
+    _multirate_periods.compress(dealii::VectorOperation::min);
+
+    _thermal_operator->set_multirate_dof_periods(_multirate_periods);
+  }
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+unsigned int
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::
+    compute_cell_weight(
+        typename dealii::DoFHandler<dim>::cell_iterator const &cell,
+        dealii::FiniteElement<dim> const &future_fe) const
+{
+  unsigned int const dofs_per_cell = future_fe.n_dofs_per_cell();
+  if (dofs_per_cell == 0)
+    return 1;
+
+  // The cost of the cell integral scales with the number of DoFs
+  unsigned int weight = dofs_per_cell;
+
+  // Return true if all the cells sharing the face f of the cell use FE_Q
+  auto const neighbor_has_material = [&](unsigned int const f)
+  {
+    auto const neighbor = cell->neighbor(f);
+    if (neighbor->is_active())
+      return neighbor->active_fe_index() == 0;
+
+    // The neighbor is refined: the face is shared with its children
+    unsigned int const neighbor_face = cell->neighbor_of_neighbor(f);
+    for (unsigned int sf = 0; sf < neighbor->face(neighbor_face)->n_children();
+         ++sf)
+    {
+      auto const neighbor_child =
+          neighbor->child(dealii::GeometryInfo<dim>::child_cell_on_face(
+              neighbor->refinement_case(), neighbor_face, sf));
+      if (neighbor_child->is_active() &&
+          (neighbor_child->active_fe_index() != 0))
+        return false;
+    }
+    return true;
+  };
+
+  // The faces on the boundary of the domain and the faces shared with a cell
+  // without material are the boundary of the activated domain. They are
+  // integrated by the ThermalOperator when their boundary condition is
+  // convective or radiative.
+  for (unsigned int f = 0; f < dealii::GeometryInfo<dim>::faces_per_cell; ++f)
+  {
+    dealii::types::boundary_id boundary_id =
+        dealii::numbers::internal_face_boundary_id;
+    if (cell->face(f)->at_boundary())
+      boundary_id = cell->face(f)->boundary_id();
+    else if (neighbor_has_material(f))
+      continue;
+
+    BoundaryType const boundary_type = _boundary.get_boundary_type(boundary_id);
+    if ((boundary_type & BoundaryType::convective) ||
+        (boundary_type & BoundaryType::radiative))
+      weight += future_fe.n_dofs_per_face();
+  }
+
+  // The heat sources are evaluated at the quadrature points of the cells that
+  // intersect their support
+  dealii::BoundingBox<dim> const cell_bounding_box = cell->bounding_box();
+  for (auto const &beam : _heat_sources)
+  {
+    if (beam->is_source_on() &&
+        (beam->get_support_bounding_box().get_neighbor_type(
+             cell_bounding_box) != dealii::NeighborType::not_neighbors))
+    {
+      weight += dofs_per_cell;
+      break;
+    }
+  }
+
+  return weight;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                    MemorySpaceType,
+                    QuadratureType>::compute_dof_material_ids()
+{
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    // A DoF shared by cells of different materials uses the largest material
+    // id. The cells owned by other processors may contribute to the locally
+    // owned DoFs, so we also write in the ghost entries and reduce them using
+    // the maximum.
+    _thermal_operator->initialize_dof_vector(_dof_material_ids);
+    std::vector<dealii::types::global_dof_index> dof_indices;
+    for (auto const &cell : dealii::filter_iterators(
+             _dof_handler.active_cell_iterators(),
+             dealii::IteratorFilters::LocallyOwnedCell(),
+             dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+    {
+      double const material_id = (n_materials == 1) ? 0. : cell->material_id();
+      dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+      cell->get_dof_indices(dof_indices);
+      for (auto const dof : dof_indices)
+        _dof_material_ids(dof) = std::max(_dof_material_ids(dof), material_id);
+    }
+    _dof_material_ids.compress(dealii::VectorOperation::max);
+  }
 }
 
 template <int dim, int n_materials, int p_order, int fe_degree,
@@ -614,18 +1046,22 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
 
   _thermal_operator->clear();
   // The data on each cell is stored in the following order: solution, direction
-  // of deposition (cosine and sine), prior melting indictor, and state ratio.
-  _data_to_transfer.clear();
+  // of deposition (cosine and sine), prior melting indictor, state ratio, and,
+  // for the enthalpy formulation, enthalpy.
   unsigned int const n_dofs_per_cell = _dof_handler.get_fe().n_dofs_per_cell();
   unsigned int const direction_data_size = 2;
   unsigned int const phase_history_data_size = 1;
   unsigned int constexpr n_material_states = MaterialStates::n_material_states;
+  unsigned int const enthalpy_offset = n_dofs_per_cell + direction_data_size +
+                                       phase_history_data_size +
+                                       n_material_states;
+  bool const transfer_enthalpy = _enthalpy.size() == solution.size();
   unsigned int const data_size_per_cell =
-      n_dofs_per_cell + direction_data_size + phase_history_data_size +
-      n_material_states;
+      enthalpy_offset + (transfer_enthalpy ? n_dofs_per_cell : 0);
   _cell_solution.reinit(n_dofs_per_cell);
-  std::vector<double> dummy_cell_data(data_size_per_cell,
-                                      std::numeric_limits<double>::infinity());
+  _data_to_transfer.reinit(_dof_handler.get_triangulation().n_active_cells(),
+                           data_size_per_cell,
+                           std::numeric_limits<double>::infinity());
 
   solution.update_ghost_values();
 
@@ -635,25 +1071,33 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   rw_index_set.add_indices(solution.get_partitioner()->ghost_indices());
   dealii::LA::ReadWriteVector<double> rw_solution(rw_index_set);
   rw_solution.import_elements(solution, dealii::VectorOperation::insert);
+  dealii::LA::ReadWriteVector<double> rw_enthalpy;
+  if (transfer_enthalpy)
+  {
+    _enthalpy.update_ghost_values();
+    rw_enthalpy.reinit(rw_index_set);
+    rw_enthalpy.import_elements(_enthalpy, dealii::VectorOperation::insert);
+  }
 
   auto state_host = Kokkos::create_mirror_view_and_copy(
       Kokkos::HostSpace{}, _material_properties.get_state());
   unsigned int locally_owned_cell_id = 0;
   unsigned int activated_cell_id = 0;
-  unsigned int cell_id = 0;
-  std::map<typename dealii::DoFHandler<dim>::active_cell_iterator, int>
-      cell_to_id;
   for (auto const &cell : _dof_handler.active_cell_iterators())
   {
     if (cell->is_locally_owned())
     {
+      double *cell_data = _data_to_transfer[cell->active_cell_index()];
       if (cell->active_fe_index() == 0)
       {
-        std::vector<double> cell_data(
-            direction_data_size + phase_history_data_size + n_material_states);
         cell->get_dof_values(rw_solution, _cell_solution);
-        cell_data.insert(cell_data.begin(), _cell_solution.begin(),
-                         _cell_solution.end());
+        std::copy(_cell_solution.begin(), _cell_solution.end(), cell_data);
+        if (transfer_enthalpy)
+        {
+          cell->get_dof_values(rw_enthalpy, _cell_solution);
+          std::copy(_cell_solution.begin(), _cell_solution.end(),
+                    cell_data + enthalpy_offset);
+        }
         cell_data[n_dofs_per_cell] = _deposition_cos[activated_cell_id];
         cell_data[n_dofs_per_cell + 1] = _deposition_sin[activated_cell_id];
 
@@ -662,31 +1106,15 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
         else
           cell_data[n_dofs_per_cell + direction_data_size] = 0.0;
 
-        for (unsigned int i = 0; i < n_material_states; ++i)
-          cell_data[n_dofs_per_cell + direction_data_size +
-                    phase_history_data_size + i] =
-              state_host(i, locally_owned_cell_id);
-        _data_to_transfer.push_back(cell_data);
-
         ++activated_cell_id;
       }
-      else
-      {
-        std::vector<double> cell_data = dummy_cell_data;
-        for (unsigned int i = 0; i < n_material_states; ++i)
-          cell_data[n_dofs_per_cell + direction_data_size +
-                    phase_history_data_size + i] =
-              state_host(i, locally_owned_cell_id);
-        _data_to_transfer.push_back(cell_data);
-      }
+
+      for (unsigned int i = 0; i < n_material_states; ++i)
+        cell_data[n_dofs_per_cell + direction_data_size +
+                  phase_history_data_size + i] =
+            state_host(i, locally_owned_cell_id);
       ++locally_owned_cell_id;
     }
-    else
-    {
-      _data_to_transfer.push_back(dummy_cell_data);
-    }
-    cell_to_id[cell] = cell_id;
-    ++cell_id;
   }
 
   // Activate elements by updating the fe_index
@@ -697,13 +1125,11 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
       if (cell->active_fe_index() != 0)
       {
         cell->set_future_fe_index(0);
-        _data_to_transfer[cell_to_id[cell]][n_dofs_per_cell] =
-            new_deposition_cos[i];
-        _data_to_transfer[cell_to_id[cell]][n_dofs_per_cell + 1] =
-            new_deposition_sin[i];
+        double *cell_data = _data_to_transfer[cell->active_cell_index()];
+        cell_data[n_dofs_per_cell] = new_deposition_cos[i];
+        cell_data[n_dofs_per_cell + 1] = new_deposition_sin[i];
 
-        if (_data_to_transfer[cell_to_id[cell]]
-                             [n_dofs_per_cell + direction_data_size] > 0.5)
+        if (cell_data[n_dofs_per_cell + direction_data_size] > 0.5)
           new_has_melted[i] = true;
         else
           new_has_melted[i] = false;
@@ -717,8 +1143,7 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
               _dof_handler.get_triangulation()));
   triangulation.prepare_coarsening_and_refinement();
   _cell_data_trans =
-      std::make_unique<dealii::parallel::distributed::CellDataTransfer<
-          dim, dim, std::vector<std::vector<double>>>>(triangulation);
+      std::make_unique<CellDataBufferTransfer<dim>>(triangulation);
 
   _cell_data_trans->prepare_for_coarsening_and_refinement(_data_to_transfer);
 }
@@ -746,29 +1171,40 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   for (auto val : solution.locally_owned_elements())
     rw_solution[val] = new_material_temperature;
 
-  dealii::parallel::distributed::Triangulation<dim> &triangulation =
-      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
-          const_cast<dealii::Triangulation<dim> &>(
-              _dof_handler.get_triangulation()));
-
   // Unpack the material state and repopulate the material state
   unsigned int constexpr n_material_states = MaterialStates::n_material_states;
   unsigned int const n_dofs_per_cell = _dof_handler.get_fe().n_dofs_per_cell();
   unsigned int const direction_data_size = 2;
   unsigned int const phase_history_data_size = 1;
-  unsigned int const data_size_per_cell =
-      n_dofs_per_cell + direction_data_size + phase_history_data_size +
-      n_material_states;
+  unsigned int const enthalpy_offset = n_dofs_per_cell + direction_data_size +
+                                       phase_history_data_size +
+                                       n_material_states;
 
-  std::vector<std::vector<double>> transferred_data(
-      triangulation.n_active_cells(), std::vector<double>(data_size_per_cell));
-  _cell_data_trans->unpack(transferred_data);
+  _cell_data_trans->unpack(_transferred_data);
+
+  // The enthalpy was packed with the solution if the stride is larger. The
+  // enthalpy of the new material is computed from its temperature.
+  bool transfer_enthalpy = false;
+  dealii::LA::ReadWriteVector<double> rw_enthalpy;
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    transfer_enthalpy =
+        _transferred_data.stride() == enthalpy_offset + n_dofs_per_cell;
+    if (transfer_enthalpy)
+    {
+      initialize_dof_vector(0., _enthalpy);
+      rw_enthalpy.reinit(rw_index_set);
+      for (auto val : solution.locally_owned_elements())
+        rw_enthalpy[val] = _enthalpy_table->get_enthalpy(
+            static_cast<dealii::types::material_id>(_dof_material_ids(val)),
+            new_material_temperature);
+    }
+  }
   auto state = _material_properties.get_state();
   auto state_host = Kokkos::create_mirror_view(state);
   _deposition_cos.clear();
   _deposition_sin.clear();
   _has_melted.clear();
-  unsigned int cell_id = 0;
   unsigned int locally_owned_cell_id = 0;
   std::vector<dealii::types::global_dof_index> local_dof_indices(
       n_dofs_per_cell);
@@ -776,11 +1212,10 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   {
     if (cell->is_locally_owned())
     {
-      if (transferred_data[cell_id][0] !=
-          std::numeric_limits<double>::infinity())
+      double const *cell_data = _transferred_data[cell->active_cell_index()];
+      if (cell_data[0] != std::numeric_limits<double>::infinity())
       {
-        std::copy(transferred_data[cell_id].begin(),
-                  transferred_data[cell_id].begin() + n_dofs_per_cell,
+        std::copy(cell_data, cell_data + n_dofs_per_cell,
                   _cell_solution.begin());
         cell->get_dof_indices(local_dof_indices);
         for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
@@ -788,17 +1223,18 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
           if (rw_index_set.is_element(local_dof_indices[i]))
           {
             rw_solution[local_dof_indices[i]] = _cell_solution(i);
+            if (transfer_enthalpy)
+              rw_enthalpy[local_dof_indices[i]] =
+                  cell_data[enthalpy_offset + i];
           }
         }
       }
 
       if (cell->active_fe_index() == 0)
       {
-        _deposition_cos.push_back(transferred_data[cell_id][n_dofs_per_cell]);
-        _deposition_sin.push_back(
-            transferred_data[cell_id][n_dofs_per_cell + 1]);
-        if (transferred_data[cell_id][n_dofs_per_cell + direction_data_size] >
-            0.5)
+        _deposition_cos.push_back(cell_data[n_dofs_per_cell]);
+        _deposition_sin.push_back(cell_data[n_dofs_per_cell + 1]);
+        if (cell_data[n_dofs_per_cell + direction_data_size] > 0.5)
           _has_melted.push_back(true);
         else
           _has_melted.push_back(false);
@@ -806,12 +1242,11 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
       for (unsigned int i = 0; i < n_material_states; ++i)
       {
         state_host(i, locally_owned_cell_id) =
-            transferred_data[cell_id][n_dofs_per_cell + direction_data_size +
-                                      phase_history_data_size + i];
+            cell_data[n_dofs_per_cell + direction_data_size +
+                      phase_history_data_size + i];
       }
       ++locally_owned_cell_id;
     }
-    ++cell_id;
   }
   Kokkos::deep_copy(state, state_host);
   get_state_from_material_properties();
@@ -822,6 +1257,8 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   solution.zero_out_ghost_values();
   solution.import_elements(rw_solution, dealii::VectorOperation::insert);
   solution.update_ghost_values();
+  if (transfer_enthalpy)
+    _enthalpy.import_elements(rw_enthalpy, dealii::VectorOperation::insert);
 }
 
 template <int dim, int n_materials, int p_order, int fe_degree,
@@ -849,6 +1286,11 @@ void ThermalPhysics<
 
     source_index++;
   }
+
+  // The right-hand side has changed, so the stage reused by the embedded
+  // schemes is not valid anymore.
+  if (_embedded_time_stepping)
+    _embedded_time_stepping->free_memory();
 }
 
 template <int dim, int n_materials, int p_order, int fe_degree,
@@ -861,6 +1303,11 @@ double ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
         std::vector<Timer> &timers)
 {
+  if (_enthalpy_table)
+  {
+    return evolve_enthalpy(t, delta_t, solution, timers);
+  }
+
   // For very small time steps (e.g., less than 1e-4 second), using deal.II to
   // perform a forward steps becomes costly. In that case, we just peform the
   // forward euler ourselves.
@@ -870,6 +1317,67 @@ double ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
 
     return (t + delta_t);
   }
+  else if (_multirate)
+  {
+    return evolve_multirate(t, delta_t, solution, timers);
+  }
+  else if (!_low_storage_c.empty())
+  {
+    return evolve_low_storage(t, delta_t, solution, timers);
+  }
+  else if (_embedded_time_stepping)
+  {
+    // The stages of the rejected trial steps are thrown away and the powder
+    // ratio can only decrease, so the stages must not change the material
+    // state.
+    auto eval = [&](double const t, LA_Vector const &y)
+    { return evaluate_thermal_physics(t, y, timers, true); };
+
+    // The time step is reduced until the error estimate is below the
+    // tolerance, so the returned time may be smaller than t + delta_t.
+    double time = _embedded_time_stepping->evolve_one_time_step(
+        eval, t, delta_t, solution);
+    _next_time_step = _embedded_time_stepping->get_status().delta_t_guess;
+
+    // Commit the material state of the accepted solution.
+    _thermal_operator->update_state(solution);
+
+    return time;
+  }
+  else if (_implicit_time_stepping)
+  {
+    if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+    {
+      if (_multigrid && !_multigrid_up_to_date)
+      {
+        _multigrid->reinit(_dof_handler, _affine_constraints, _thermal_operator,
+                           _deposition_cos, _deposition_sin);
+        _multigrid_up_to_date = true;
+      }
+    }
+
+    // Every evaluation of the right-hand side by the Newton solver is done at
+    // the current iterate, so this is where the Jacobian is linearized. The
+    // iterates are not converged, so they must not change the material state.
+    auto eval = [&](double const t, LA_Vector const &y)
+    {
+      LA_Vector value = evaluate_thermal_physics(t, y, timers, true);
+      _implicit_operator->set_linearization_point(y);
+      return value;
+    };
+    auto id_minus_tau_J_inv =
+        [&](double const t, double const tau, LA_Vector const &y)
+    { return id_minus_tau_J_inverse(t, tau, y, timers); };
+
+    double time = _implicit_time_stepping->evolve_one_time_step(
+        eval, id_minus_tau_J_inv, t, delta_t, solution);
+
+    // Commit the material state of the accepted solution.
+    _thermal_operator->update_state(solution);
+
+    // Return the time at the end of the time step.
+    return time;
+  }
   else
   {
     auto eval = [&](double const t, LA_Vector const &y)
@@ -909,6 +1417,7 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
                     QuadratureType>::get_state_from_material_properties()
 {
   _thermal_operator->get_state_from_material_properties();
+  _multigrid_up_to_date = false;
 }
 
 template <int dim, int n_materials, int p_order, int fe_degree,
@@ -921,6 +1430,243 @@ void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   _thermal_operator->set_state_to_material_properties();
 }
 
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+double ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                      MemorySpaceType, QuadratureType>::
+    evolve_multirate(double const t, double const delta_t, LA_Vector &solution,
+                     std::vector<Timer> &timers)
+{
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    // Each DoF is advanced using forward Euler with its own time step,
+    // period * micro_delta_t. While a DoF is between two updates, its value is
+    // interpolated linearly between the beginning and the end of its time step.
+    // This way, the DoFs of the fine cells see a time-accurate value of their
+    // coarser neighbors at the interfaces between levels.
+    double const micro_delta_t = delta_t / _n_micro_steps;
+    bool const has_ghost_elements = solution.has_ghost_elements();
+    // The scratch vectors are kept between time steps. reinit does not
+    // allocate new memory if they already use the partitioner of the solution.
+    LA_Vector &start = _multirate_start;
+    LA_Vector &end = _multirate_end;
+    start.reinit(solution, true);
+    end.reinit(solution, true);
+    start.copy_locally_owned_data_from(solution);
+    end.copy_locally_owned_data_from(solution);
+    unsigned int const local_size = solution.locally_owned_size();
+    for (unsigned int micro_step = 0; micro_step < _n_micro_steps; ++micro_step)
+    {
+      for (unsigned int i = 0; i < local_size; ++i)
+      {
+        unsigned int const period = _multirate_periods.local_element(i);
+        unsigned int const position = micro_step % period;
+        if (position == 0)
+        {
+          start.local_element(i) = end.local_element(i);
+          solution.local_element(i) = end.local_element(i);
+        }
+        else
+        {
+          solution.local_element(i) =
+              start.local_element(i) +
+              static_cast<double>(position) / period *
+                  (end.local_element(i) - start.local_element(i));
+        }
+      }
+      // The locally owned values have changed, the ghost values need to be
+      // updated by the ThermalOperator.
+      solution.zero_out_ghost_values();
+
+      _thermal_operator->set_multirate_micro_step(micro_step);
+      LA_Vector &value = _multirate_value;
+      evaluate_thermal_physics(t + micro_step * micro_delta_t, solution, value,
+                               timers);
+
+      for (unsigned int i = 0; i < local_size; ++i)
+      {
+        unsigned int const period = _multirate_periods.local_element(i);
+        if (micro_step % period == 0)
+          end.local_element(i) =
+              start.local_element(i) +
+              period * micro_delta_t * value.local_element(i);
+      }
+    }
+    // All the DoFs are now at the end of their time step. Reset the micro step
+    // so that the next applications of the ThermalOperator use all the cells.
+    _thermal_operator->set_multirate_micro_step(0);
+    solution.copy_locally_owned_data_from(end);
+    if (has_ghost_elements)
+      solution.update_ghost_values();
+  }
+
+  return t + delta_t;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+double ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                      MemorySpaceType, QuadratureType>::
+    evolve_low_storage(double const t, double const delta_t,
+                       LA_Vector &solution, std::vector<Timer> &timers)
+{
+#ifdef ADAMANTINE_WITH_CALIPER
+  CALI_CXX_MARK_FUNCTION;
+#endif
+  timers[evol_time_eval_th_ph].start();
+
+  // The locally owned values of the solution are modified during the stages,
+  // so the ghost values would become out of date.
+  bool const has_ghost_elements = solution.has_ghost_elements();
+  solution.zero_out_ghost_values();
+  // reinit does not allocate new memory if the registers already use the
+  // partitioner of the solution.
+  _low_storage_ri.reinit(solution, true);
+  _low_storage_ki.reinit(solution, true);
+
+  // The first stage is applied to the solution itself. The following stages
+  // are applied to the register computed by the previous stage.
+  unsigned int const n_stages = _low_storage_c.size();
+  for (unsigned int stage = 0; stage < n_stages; ++stage)
+  {
+    double const factor_ai =
+        (stage == n_stages - 1) ? 0. : _low_storage_a[stage] * delta_t;
+    _thermal_operator->set_time(t + _low_storage_c[stage] * delta_t);
+    _thermal_operator->low_storage_rk_stage(
+        _low_storage_b[stage] * delta_t, factor_ai,
+        stage == 0 ? solution : _low_storage_ri, _low_storage_ki, solution,
+        _low_storage_ri);
+  }
+
+  if (has_ghost_elements)
+    solution.update_ghost_values();
+
+  timers[evol_time_eval_th_ph].stop();
+
+  return t + delta_t;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+double ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                      MemorySpaceType, QuadratureType>::
+    evolve_enthalpy(double const t, double const delta_t, LA_Vector &solution,
+                    std::vector<Timer> &timers)
+{
+  double time = t + delta_t;
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    // The time integration is done on the enthalpy. The temperature is
+    // recovered before each evaluation of the ThermalOperator and at the end
+    // of the time step, so the rest of the code only sees the temperature.
+    // The enthalpy is the state of the formulation and it is kept between time
+    // steps: going back and forth between the temperature and the enthalpy
+    // would not conserve the energy in the freezing range. It is only
+    // recomputed at the DoFs whose temperature was modified since the end of
+    // the last time step, e.g., by the deposition of material or by data
+    // assimilation. When the mesh is updated, the enthalpy is transferred with
+    // the temperature and both are used as they are.
+    bool const has_ghost_elements = solution.has_ghost_elements();
+    unsigned int const local_size = solution.locally_owned_size();
+    if (_enthalpy.size() != solution.size())
+    {
+      _enthalpy.reinit(solution.get_partitioner());
+      _enthalpy_temperature.reinit(solution.get_partitioner());
+      temperature_to_enthalpy(solution, _enthalpy);
+    }
+    else if (_enthalpy_temperature.size() != solution.size())
+    {
+      _enthalpy_temperature.reinit(solution.get_partitioner());
+      _enthalpy_temperature.copy_locally_owned_data_from(solution);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < local_size; ++i)
+      {
+        double const temperature = solution.local_element(i);
+        if (temperature != _enthalpy_temperature.local_element(i))
+          _enthalpy.local_element(i) = _enthalpy_table->get_enthalpy(
+              static_cast<dealii::types::material_id>(
+                  _dof_material_ids.local_element(i)),
+              temperature);
+      }
+    }
+    LA_Vector &enthalpy = _enthalpy;
+    LA_Vector &temperature = _stage_temperature;
+    auto eval = [&](double const t, LA_Vector const &y)
+    {
+      enthalpy_to_temperature(y, temperature);
+      return evaluate_thermal_physics(t, temperature, timers);
+    };
+
+    if (_forward_euler)
+    {
+      enthalpy.sadd(1., delta_t, eval(t, enthalpy));
+    }
+    else if (_embedded_time_stepping)
+    {
+      time = _embedded_time_stepping->evolve_one_time_step(eval, t, delta_t,
+                                                           enthalpy);
+      _next_time_step = _embedded_time_stepping->get_status().delta_t_guess;
+    }
+    else
+    {
+      time = _time_stepping->evolve_one_time_step(eval, t, delta_t, enthalpy);
+    }
+
+    enthalpy_to_temperature(enthalpy, solution);
+    _enthalpy_temperature.copy_locally_owned_data_from(solution);
+    if (has_ghost_elements)
+      solution.update_ghost_values();
+  }
+
+  return time;
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                    MemorySpaceType, QuadratureType>::
+    temperature_to_enthalpy(LA_Vector const &temperature,
+                            LA_Vector &enthalpy) const
+{
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    unsigned int const local_size = temperature.locally_owned_size();
+    for (unsigned int i = 0; i < local_size; ++i)
+      enthalpy.local_element(i) = _enthalpy_table->get_enthalpy(
+          static_cast<dealii::types::material_id>(
+              _dof_material_ids.local_element(i)),
+          temperature.local_element(i));
+  }
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                    MemorySpaceType, QuadratureType>::
+    enthalpy_to_temperature(LA_Vector const &enthalpy,
+                            LA_Vector &temperature) const
+{
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    // The locally owned values change, the ghost values need to be updated by
+    // the ThermalOperator.
+    temperature.zero_out_ghost_values();
+    unsigned int const local_size = enthalpy.locally_owned_size();
+    for (unsigned int i = 0; i < local_size; ++i)
+      temperature.local_element(i) = _enthalpy_table->get_temperature(
+          static_cast<dealii::types::material_id>(
+              _dof_material_ids.local_element(i)),
+          enthalpy.local_element(i));
+  }
+}
+
 template <int dim, int n_materials, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType,
           typename QuadratureType>
@@ -930,16 +1676,19 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
     evaluate_thermal_physics(
         double const t,
         dealii::LA::distributed::Vector<double, MemorySpaceType> const &y,
-        std::vector<Timer> &timers) const
+        std::vector<Timer> &timers, bool const frozen_state) const
 {
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_CXX_MARK_FUNCTION;
 #endif
   if constexpr (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value)
   {
-    return evaluate_thermal_physics_impl<dim, fe_degree, MemorySpaceType>(
+    LA_Vector value;
+    evaluate_thermal_physics_impl<dim, fe_degree, MemorySpaceType>(
         _thermal_operator, _fe_collection, t, _dof_handler, _heat_sources,
-        _print_heat_input, y, timers);
+        _print_heat_input, frozen_state, y, value, timers);
+
+    return value;
   }
   else
   {
@@ -949,7 +1698,7 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
                                            fe_degree, MaterialStates,
                                            MemorySpaceType>(
           _thermal_operator, _fe_collection, t, _dof_handler, _heat_sources,
-          _print_heat_input, _boundary, _material_properties,
+          _print_heat_input, frozen_state, _boundary, _material_properties,
           _affine_constraints, y, timers);
     }
     else
@@ -958,7 +1707,7 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
                                            fe_degree, MaterialStates,
                                            MemorySpaceType>(
           _thermal_operator, _fe_collection, t, _dof_handler, _heat_sources,
-          _print_heat_input, _boundary, _material_properties,
+          _print_heat_input, frozen_state, _boundary, _material_properties,
           _affine_constraints, y, timers);
     }
   }
@@ -967,6 +1716,91 @@ ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
   return dealii::LA::distributed::Vector<double, MemorySpaceType>();
 }
 
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+void ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+                    MemorySpaceType, QuadratureType>::
+    evaluate_thermal_physics(double const t, LA_Vector const &y,
+                             LA_Vector &value,
+                             std::vector<Timer> &timers) const
+{
+  if constexpr (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value)
+  {
+    evaluate_thermal_physics_impl<dim, fe_degree, MemorySpaceType>(
+        _thermal_operator, _fe_collection, t, _dof_handler, _heat_sources,
+        _print_heat_input, false, y, value, timers);
+  }
+  else
+  {
+    value = evaluate_thermal_physics(t, y, timers);
+  }
+}
+
+template <int dim, int n_materials, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType,
+          typename QuadratureType>
+dealii::LA::distributed::Vector<double, MemorySpaceType>
+ThermalPhysics<dim, n_materials, p_order, fe_degree, MaterialStates,
+               MemorySpaceType, QuadratureType>::
+    id_minus_tau_J_inverse(
+        double const /*t*/, double const tau,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> const &y,
+        std::vector<Timer> &timers) const
+{
+#ifdef ADAMANTINE_WITH_CALIPER
+  CALI_CXX_MARK_FUNCTION;
+#endif
+  timers[evol_time_eval_th_ph].start();
+  _implicit_operator->set_tau(tau);
+
+  dealii::SolverControl solver_control(_max_iter, _tolerance * y.l2_norm());
+  typename dealii::SolverGMRES<LA_Vector>::AdditionalData additional_data(
+      _n_tmp_vectors);
+  dealii::SolverGMRES<LA_Vector> solver(solver_control, additional_data);
+
+  LA_Vector solution(y.get_partitioner());
+  solution = 0.;
+  if (_preconditioner_type == ImplicitPreconditioner::chebyshev)
+  {
+    // The ImplicitOperator is already scaled by the inverse of the mass
+    // matrix, so the Chebyshev iterations use a unit diagonal.
+    using Chebyshev =
+        dealii::PreconditionChebyshev<ImplicitOperator<dim, MemorySpaceType>,
+                                      LA_Vector>;
+    typename Chebyshev::AdditionalData chebyshev_data;
+    chebyshev_data.degree = _chebyshev_degree;
+    chebyshev_data.smoothing_range = 20.;
+    chebyshev_data.eig_cg_n_iterations = 10;
+    chebyshev_data.eigenvalue_algorithm =
+        Chebyshev::AdditionalData::EigenvalueAlgorithm::power_iteration;
+    chebyshev_data.preconditioner =
+        std::make_shared<dealii::DiagonalMatrix<LA_Vector>>();
+    _thermal_operator->initialize_dof_vector(
+        chebyshev_data.preconditioner->get_vector());
+    chebyshev_data.preconditioner->get_vector() = 1.;
+    Chebyshev chebyshev;
+    chebyshev.initialize(*_implicit_operator, chebyshev_data);
+    solver.solve(*_implicit_operator, solution, y, chebyshev);
+  }
+  else if (_preconditioner_type == ImplicitPreconditioner::multigrid)
+  {
+    if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+    {
+      _multigrid->update(*_implicit_operator);
+      solver.solve(*_implicit_operator, solution, y, *_multigrid);
+    }
+  }
+  else
+  {
+    dealii::PreconditionIdentity preconditioner;
+    solver.solve(*_implicit_operator, solution, y, preconditioner);
+  }
+  timers[evol_time_eval_th_ph].stop();
+
+  return solution;
+}
+
 template <int dim, int n_materials, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType,
           typename QuadratureType>
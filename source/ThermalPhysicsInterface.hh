@@ -14,6 +14,7 @@
 namespace adamantine
 {
 // Forward declarations
+class CellDataBuffer;
 class Timer;
 
 template <int dim>
@@ -88,6 +89,17 @@ public:
       dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
       std::vector<Timer> &timers) = 0;
 
+  /**
+   * Return true if the time stepping scheme adapts the time step.
+   */
+  virtual bool has_adaptive_time_stepping() const = 0;
+
+  /**
+   * Return the time step suggested by the adaptive time stepping scheme for the
+   * next call to evolve_one_time_step().
+   */
+  virtual double get_next_time_step() const = 0;
+
   /**
    * Initialize the given vector with the given value.
    */
@@ -186,6 +198,27 @@ public:
    * Return the degree of the finite element.
    */
   virtual unsigned int get_fe_degree() const = 0;
+
+  /**
+   * Return the buffer used to pack the cell data before the mesh is updated.
+   * The buffer keeps its memory between mesh updates.
+   */
+  virtual CellDataBuffer &get_data_to_transfer() = 0;
+
+  /**
+   * Return the buffer used to unpack the cell data after the mesh is updated.
+   * The buffer keeps its memory between mesh updates.
+   */
+  virtual CellDataBuffer &get_transferred_data() = 0;
+
+  /**
+   * Return the volumetric enthalpy kept between time steps by the enthalpy
+   * formulation. The vector is empty when the temperature formulation is used
+   * and before the first time step. The mesh updates transfer it with the
+   * solution.
+   */
+  virtual dealii::LA::distributed::Vector<double, MemorySpaceType> &
+  get_enthalpy() = 0;
 };
 } // namespace adamantine
 #endif
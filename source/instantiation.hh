@@ -116,6 +116,69 @@
       ((NAME))(                                                                \
           ADAMANTINE_DIM)(ADAMANTINE_N_MATERIALS)(ADAMANTINE_USE_TABLE)(ADAMANTINE_P_ORDER)(ADAMANTINE_FE_DEGREE))
 
+// Instantiation of the class for:
+//   - dim = 2 and 3
+//   - n_materials = -1 and 1
+//   - use_table = true and false
+//   - p_order = 0 to 4
+//   - fe_degree = 1 to 5
+//   - material_state = Solid
+//   - memory_space = Host
+//   - number = float
+#define ADAMANTINE_D_N_U_P_F_S_HOST_FLOAT(z, SEQ)                              \
+  template class adamantine::BOOST_PP_SEQ_ELEM(                                \
+      0, SEQ)<BOOST_PP_SEQ_ELEM(1, SEQ), BOOST_PP_SEQ_ELEM(2, SEQ),            \
+              BOOST_PP_SEQ_ELEM(3, SEQ), BOOST_PP_SEQ_ELEM(4, SEQ),            \
+              BOOST_PP_SEQ_ELEM(5, SEQ), adamantine::Solid,                    \
+              dealii::MemorySpace::Host, float>;
+#define INSTANTIATE_DIM_NMAT_USETABLE_PORDER_FEDEGREE_S_HOST_FLOAT(NAME)       \
+  BOOST_PP_SEQ_FOR_EACH_PRODUCT(                                               \
+      ADAMANTINE_D_N_U_P_F_S_HOST_FLOAT,                                       \
+      ((NAME))(                                                                \
+          ADAMANTINE_DIM)(ADAMANTINE_N_MATERIALS)(ADAMANTINE_USE_TABLE)(ADAMANTINE_P_ORDER)(ADAMANTINE_FE_DEGREE))
+
+// Instantiation of the class for:
+//   - dim = 2 and 3
+//   - n_materials = -1 and 1
+//   - use_table = true and false
+//   - p_order = 0 to 4
+//   - fe_degree = 1 to 5
+//   - material_state = SolidLiquid
+//   - memory_space = Host
+//   - number = float
+#define ADAMANTINE_D_N_U_P_F_SL_HOST_FLOAT(z, SEQ)                             \
+  template class adamantine::BOOST_PP_SEQ_ELEM(                                \
+      0, SEQ)<BOOST_PP_SEQ_ELEM(1, SEQ), BOOST_PP_SEQ_ELEM(2, SEQ),            \
+              BOOST_PP_SEQ_ELEM(3, SEQ), BOOST_PP_SEQ_ELEM(4, SEQ),            \
+              BOOST_PP_SEQ_ELEM(5, SEQ), adamantine::SolidLiquid,              \
+              dealii::MemorySpace::Host, float>;
+#define INSTANTIATE_DIM_NMAT_USETABLE_PORDER_FEDEGREE_SL_HOST_FLOAT(NAME)      \
+  BOOST_PP_SEQ_FOR_EACH_PRODUCT(                                               \
+      ADAMANTINE_D_N_U_P_F_SL_HOST_FLOAT,                                      \
+      ((NAME))(                                                                \
+          ADAMANTINE_DIM)(ADAMANTINE_N_MATERIALS)(ADAMANTINE_USE_TABLE)(ADAMANTINE_P_ORDER)(ADAMANTINE_FE_DEGREE))
+
+// Instantiation of the class for:
+//   - dim = 2 and 3
+//   - n_materials = -1 and 1
+//   - use_table = true and false
+//   - p_order = 0 to 4
+//   - fe_degree = 1 to 5
+//   - material_state = SolidLiquidPowder
+//   - memory_space = Host
+//   - number = float
+#define ADAMANTINE_D_N_U_P_F_SLP_HOST_FLOAT(z, SEQ)                            \
+  template class adamantine::BOOST_PP_SEQ_ELEM(                                \
+      0, SEQ)<BOOST_PP_SEQ_ELEM(1, SEQ), BOOST_PP_SEQ_ELEM(2, SEQ),            \
+              BOOST_PP_SEQ_ELEM(3, SEQ), BOOST_PP_SEQ_ELEM(4, SEQ),            \
+              BOOST_PP_SEQ_ELEM(5, SEQ), adamantine::SolidLiquidPowder,        \
+              dealii::MemorySpace::Host, float>;
+#define INSTANTIATE_DIM_NMAT_USETABLE_PORDER_FEDEGREE_SLP_HOST_FLOAT(NAME)     \
+  BOOST_PP_SEQ_FOR_EACH_PRODUCT(                                               \
+      ADAMANTINE_D_N_U_P_F_SLP_HOST_FLOAT,                                     \
+      ((NAME))(                                                                \
+          ADAMANTINE_DIM)(ADAMANTINE_N_MATERIALS)(ADAMANTINE_USE_TABLE)(ADAMANTINE_P_ORDER)(ADAMANTINE_FE_DEGREE))
+
 // Instantiation of the class for:
 //   - dim = 2 and 3
 //   - n_materials = -1 and 1
@@ -147,6 +147,17 @@ enum Timing
   n_timers
 };
 
+/**
+ * Enum on the possible preconditioners used by the implicit time stepping
+ * schemes.
+ */
+enum class ImplicitPreconditioner
+{
+  identity,
+  chebyshev,
+  multigrid
+};
+
 /**
  * Structure that stores constants.
  */
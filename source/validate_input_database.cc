@@ -10,6 +10,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 
 #include <algorithm>
+#include <limits>
 
 namespace adamantine
 {
@@ -154,6 +155,61 @@ void validate_input_database(boost::property_tree::ptree &database)
         ASSERT_THROW(false, "Unknown quadrature type.");
       }
     }
+
+    // PropertyTreeInput discretization.thermal.precision
+    boost::optional<std::string> precision_optional =
+        database.get_optional<std::string>("discretization.thermal.precision");
+
+    if (precision_optional)
+    {
+      std::string precision = precision_optional.get();
+      if (!((boost::iequals(precision, "double") ||
+             (boost::iequals(precision, "single")))))
+      {
+        ASSERT_THROW(false, "Unknown precision of the thermal operator.");
+      }
+      ASSERT_THROW(
+          boost::iequals(precision, "double") ||
+              boost::iequals(database.get("memory_space", "host"), "host"),
+          "Single precision is only available on the host.");
+    }
+
+    // PropertyTreeInput discretization.thermal.formulation
+    boost::optional<std::string> formulation_optional =
+        database.get_optional<std::string>(
+            "discretization.thermal.formulation");
+
+    if (formulation_optional)
+    {
+      std::string formulation = formulation_optional.get();
+      if (!((boost::iequals(formulation, "temperature") ||
+             (boost::iequals(formulation, "enthalpy")))))
+      {
+        ASSERT_THROW(false, "Unknown formulation of the heat equation.");
+      }
+      if (boost::iequals(formulation, "enthalpy"))
+      {
+        ASSERT_THROW(
+            boost::iequals(database.get("memory_space", "host"), "host"),
+            "The enthalpy formulation is only available on the host.");
+        // PropertyTreeInput discretization.thermal.enthalpy_max_temperature
+        ASSERT_THROW(
+            database.get("discretization.thermal.enthalpy_max_temperature",
+                         4000.) > 0.,
+            "The maximum temperature of the enthalpy table must be "
+            "positive.");
+        std::string method =
+            database.get<std::string>("time_stepping.method", "");
+        ASSERT_THROW(
+            boost::iequals(method, "forward_euler") ||
+                boost::iequals(method, "rk_third_order") ||
+                boost::iequals(method, "rk_fourth_order") ||
+                boost::iequals(method, "bogacki_shampine") ||
+                boost::iequals(method, "dopri"),
+            "The enthalpy formulation only supports the forward Euler, the "
+            "explicit Runge-Kutta, and the embedded Runge-Kutta methods.");
+      }
+    }
   }
 
   // Tree: geometry
@@ -352,6 +408,10 @@ void validate_input_database(boost::property_tree::ptree &database)
             "', is not recognized. Valid options are: 'host' and 'device'");
   }
 
+  // Tree: n_threads
+  ASSERT_THROW(database.get("n_threads", 0) >= 0,
+               "The number of threads must be non-negative.");
+
   // Tree: post_processor
   ASSERT_THROW(database.get_child("post_processor").count("filename_prefix") !=
                    0,
@@ -360,6 +420,22 @@ void validate_input_database(boost::property_tree::ptree &database)
   // Tree: refinement
   ASSERT_THROW(database.count("refinement") != 0,
                "A refinement section of the input file must exist.");
+  double const refine_fraction =
+      database.get("refinement.error_estimator_refine_fraction", 0.);
+  double const coarsen_fraction =
+      database.get("refinement.error_estimator_coarsen_fraction", 0.);
+  ASSERT_THROW((refine_fraction >= 0.) && (coarsen_fraction >= 0.) &&
+                   (refine_fraction + coarsen_fraction <= 1.),
+               "The error estimator refine and coarsen fractions must be "
+               "positive and their sum must not be greater than one.");
+  double const load_imbalance_threshold =
+      database.get("refinement.load_imbalance_threshold", 0.);
+  ASSERT_THROW((load_imbalance_threshold == 0.) ||
+                   (load_imbalance_threshold > 1.),
+               "The load imbalance threshold must be greater than one.");
+  ASSERT_THROW(
+      database.get("refinement.time_steps_between_load_balancing", 1u) > 0,
+      "The number of time steps between load balancing must be positive.");
 
   // Tree: sources
   unsigned int n_beams = database.get<unsigned int>("sources.n_beams");
@@ -401,12 +477,95 @@ void validate_input_database(boost::property_tree::ptree &database)
   // Tree: time_stepping
   std::string time_stepping_method =
       database.get<std::string>("time_stepping.method");
+  bool const implicit_time_stepping =
+      boost::iequals(time_stepping_method, "backward_euler") ||
+      boost::iequals(time_stepping_method, "implicit_midpoint") ||
+      boost::iequals(time_stepping_method, "crank_nicolson") ||
+      boost::iequals(time_stepping_method, "sdirk2");
+  bool const adaptive_time_stepping =
+      boost::iequals(time_stepping_method, "bogacki_shampine") ||
+      boost::iequals(time_stepping_method, "dopri");
   ASSERT_THROW(boost::iequals(time_stepping_method, "forward_euler") ||
+                   boost::iequals(time_stepping_method,
+                                  "multirate_forward_euler") ||
                    boost::iequals(time_stepping_method, "rk_third_order") ||
-                   boost::iequals(time_stepping_method, "rk_fourth_order"),
+                   boost::iequals(time_stepping_method, "rk_fourth_order") ||
+                   boost::iequals(time_stepping_method,
+                                  "low_storage_rk_third_order") ||
+                   boost::iequals(time_stepping_method,
+                                  "low_storage_rk_fourth_order") ||
+                   implicit_time_stepping || adaptive_time_stepping,
                "Time stepping method, '" + time_stepping_method +
                    "', is not recognized. Valid options are: 'forward_euler', "
-                   "'rk_third_order', and 'rk_fourth_order'.");
+                   "'multirate_forward_euler', 'rk_third_order', "
+                   "'rk_fourth_order', 'low_storage_rk_third_order', "
+                   "'low_storage_rk_fourth_order', 'bogacki_shampine', "
+                   "'dopri', 'backward_euler', 'implicit_midpoint', "
+                   "'crank_nicolson', and 'sdirk2'.");
+
+  // PropertyTreeInput time_stepping.coefficient_cache_tolerance
+  double const coefficient_cache_tolerance =
+      database.get("time_stepping.coefficient_cache_tolerance", 0.);
+  ASSERT_THROW(coefficient_cache_tolerance >= 0.0,
+               "Coefficient cache tolerance must be non-negative.");
+  ASSERT_THROW(
+      (coefficient_cache_tolerance == 0.) ||
+          boost::iequals(database.get("memory_space", "host"), "host"),
+      "The coefficient cache is only available on the host.");
+
+  if (adaptive_time_stepping)
+  {
+    double const error_tolerance =
+        database.get("time_stepping.error_tolerance", 1e-3);
+    ASSERT_THROW(error_tolerance > 0.0, "Error tolerance must be positive.");
+    double const coarsening_tolerance = database.get(
+        "time_stepping.coarsening_tolerance", 1e-2 * error_tolerance);
+    ASSERT_THROW(coarsening_tolerance > 0.0 &&
+                     coarsening_tolerance < error_tolerance,
+                 "Coarsening tolerance must be positive and smaller than the "
+                 "error tolerance.");
+    double const refining_factor =
+        database.get("time_stepping.refining_factor", 0.8);
+    ASSERT_THROW(refining_factor > 0.0 && refining_factor < 1.0,
+                 "Refining factor must be between 0 and 1.");
+    ASSERT_THROW(database.get("time_stepping.coarsening_factor", 1.2) > 1.0,
+                 "Coarsening factor must be greater than 1.");
+    double const min_time_step =
+        database.get("time_stepping.min_time_step", 1e-14);
+    ASSERT_THROW(min_time_step > 0.0, "Minimum time step must be positive.");
+    ASSERT_THROW(database.get("time_stepping.max_time_step",
+                              std::numeric_limits<double>::max()) >=
+                     min_time_step,
+                 "Maximum time step must be larger than the minimum time "
+                 "step.");
+    ASSERT_THROW(!database.get("ensemble.ensemble_simulation", false),
+                 "Adaptive time stepping is not supported for ensemble "
+                 "simulations.");
+  }
+
+  if (implicit_time_stepping)
+  {
+    ASSERT_THROW(database.get("time_stepping.newton_tolerance", 1.) > 0.0,
+                 "Newton tolerance must be positive.");
+    ASSERT_THROW(database.get("time_stepping.tolerance", 1.) > 0.0,
+                 "Krylov solver tolerance must be positive.");
+    ASSERT_THROW(database.get("time_stepping.max_iteration", 1) > 0,
+                 "Krylov solver maximum number of iterations must be "
+                 "positive.");
+    ASSERT_THROW(database.get("time_stepping.newton_max_iteration", 1) > 0,
+                 "Newton solver maximum number of iterations must be "
+                 "positive.");
+    std::string preconditioner =
+        database.get<std::string>("time_stepping.preconditioner", "identity");
+    ASSERT_THROW(boost::iequals(preconditioner, "identity") ||
+                     boost::iequals(preconditioner, "chebyshev") ||
+                     boost::iequals(preconditioner, "multigrid"),
+                 "Preconditioner, '" + preconditioner +
+                     "', is not recognized. Valid options are: 'identity', "
+                     "'chebyshev', and 'multigrid'.");
+    ASSERT_THROW(database.get("time_stepping.chebyshev_degree", 1) > 0,
+                 "Chebyshev degree must be positive.");
+  }
 
   if (database.get("time.scan_path_for_duration", false))
   {
@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2026, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#define BOOST_TEST_MODULE CellDataBuffer
+
+#include <CellDataBuffer.hh>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include "main.cc"
+
+namespace tt = boost::test_tools;
+
+// Check that the data follows the cells when the mesh is refined and coarsened
+// back.
+template <int dim>
+void refine_and_coarsen()
+{
+  dealii::parallel::distributed::Triangulation<dim> triangulation(
+      MPI_COMM_WORLD);
+  dealii::GridGenerator::subdivided_hyper_cube(triangulation, 4);
+
+  // Store the center of each cell and the level of the cell.
+  unsigned int const stride = dim + 1;
+  adamantine::CellDataBuffer data_to_transfer;
+  data_to_transfer.reinit(triangulation.n_active_cells(), stride);
+  BOOST_TEST(data_to_transfer.n_cells() == triangulation.n_active_cells());
+  BOOST_TEST(data_to_transfer.stride() == stride);
+  for (auto const &cell : triangulation.active_cell_iterators())
+    if (cell->is_locally_owned())
+    {
+      double *cell_data = data_to_transfer[cell->active_cell_index()];
+      for (unsigned int d = 0; d < dim; ++d)
+        cell_data[d] = cell->center()[d];
+      cell_data[dim] = 0.;
+      cell->set_refine_flag();
+    }
+
+  // The children get the center of their parent and the level is increased.
+  adamantine::CellDataBufferTransfer<dim> refinement_transfer(
+      triangulation,
+      [](typename dealii::Triangulation<dim>::cell_iterator const &parent,
+         dealii::ArrayView<double const> parent_data,
+         dealii::ArrayView<double> children_data)
+      {
+        for (unsigned int c = 0; c < parent->n_children(); ++c)
+        {
+          double *child_data = children_data.data() + c * parent_data.size();
+          std::copy(parent_data.begin(), parent_data.end(), child_data);
+          child_data[dim] += 1.;
+        }
+      });
+  refinement_transfer.prepare_for_coarsening_and_refinement(data_to_transfer);
+  triangulation.execute_coarsening_and_refinement();
+  adamantine::CellDataBuffer transferred_data;
+  refinement_transfer.unpack(transferred_data);
+
+  BOOST_TEST(transferred_data.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators())
+    if (cell->is_locally_owned())
+    {
+      double const *cell_data = transferred_data[cell->active_cell_index()];
+      for (unsigned int d = 0; d < dim; ++d)
+        BOOST_TEST(cell_data[d] == cell->parent()->center()[d],
+                   tt::tolerance(1e-12));
+      BOOST_TEST(cell_data[dim] == 1.);
+      cell->set_coarsen_flag();
+    }
+
+  // The children have the same data, so the default coarsening strategy can be
+  // used.
+  adamantine::CellDataBufferTransfer<dim> coarsening_transfer(triangulation);
+  coarsening_transfer.prepare_for_coarsening_and_refinement(transferred_data);
+  triangulation.execute_coarsening_and_refinement();
+  coarsening_transfer.unpack(data_to_transfer);
+
+  BOOST_TEST(data_to_transfer.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators())
+    if (cell->is_locally_owned())
+    {
+      double const *cell_data = data_to_transfer[cell->active_cell_index()];
+      for (unsigned int d = 0; d < dim; ++d)
+        BOOST_TEST(cell_data[d] == cell->center()[d], tt::tolerance(1e-12));
+      BOOST_TEST(cell_data[dim] == 1.);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cell_data_buffer_2d) { refine_and_coarsen<2>(); }
+
+BOOST_AUTO_TEST_CASE(cell_data_buffer_3d) { refine_and_coarsen<3>(); }
@@ -4,11 +4,14 @@
 
 #define BOOST_TEST_MODULE HeatSource
 
+#include <CubeHeatSource.hh>
 #include <ElectronBeamHeatSource.hh>
 #include <GoldakHeatSource.hh>
 #include <HeatSource.hh>
 #include <ScanPath.hh>
 
+#include <limits>
+
 #include "main.cc"
 
 namespace utf = boost::unit_test;
@@ -283,6 +286,127 @@ BOOST_AUTO_TEST_CASE(heat_source_value_3d, *utf::tolerance(1e-12))
   BOOST_TEST(eb_value == expected_value);
 }
 
+BOOST_AUTO_TEST_CASE(heat_source_support_bounding_box_3d,
+                     *utf::tolerance(1e-12))
+{
+  boost::property_tree::ptree database;
+
+  database.put("depth", 0.1);
+  database.put("absorption_efficiency", 0.1);
+  database.put("diameter", 1.0);
+  database.put("max_power", 10.);
+  database.put("scan_path_file", "scan_path.txt");
+  database.put("scan_path_file_format", "segment");
+
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  GoldakHeatSource<3> goldak_heat_source(database, units_optional_database);
+  ElectronBeamHeatSource<3> eb_heat_source(database, units_optional_database);
+
+  // The beam center is at (8e-4, 0.1, 0.1) 0.001 s into the second segment
+  goldak_heat_source.update_time(0.001001);
+  eb_heat_source.update_time(0.001001);
+  double const xpy_radius = std::sqrt(5.) * 0.5;
+  for (auto const &box : {goldak_heat_source.get_support_bounding_box(),
+                          eb_heat_source.get_support_bounding_box()})
+  {
+    auto const &[min_corner, max_corner] = box.get_boundary_points();
+    BOOST_TEST(min_corner[0] == 8e-4 - xpy_radius);
+    BOOST_TEST(max_corner[0] == 8e-4 + xpy_radius);
+    BOOST_TEST(min_corner[1] == 0.1 - xpy_radius);
+    BOOST_TEST(max_corner[1] == 0.1 + xpy_radius);
+    BOOST_TEST(min_corner[2] == 0.0);
+    BOOST_TEST(max_corner[2] == std::numeric_limits<double>::max());
+  }
+
+  // The heat sources are zero outside of the bounding box
+  dealii::Point<3> outside_xy(8e-4 + 1.2, 0.1, 0.1);
+  BOOST_TEST(goldak_heat_source.value(outside_xy) == 0.);
+  BOOST_TEST(eb_heat_source.value(outside_xy) == 0.);
+  dealii::Point<3> outside_z(8e-4, 0.1, -0.01);
+  BOOST_TEST(goldak_heat_source.value(outside_z) == 0.);
+  BOOST_TEST(eb_heat_source.value(outside_z) == 0.);
+}
+
+BOOST_AUTO_TEST_CASE(heat_source_swept_bounding_boxes_3d)
+{
+  boost::property_tree::ptree database;
+
+  database.put("depth", 0.1);
+  database.put("absorption_efficiency", 0.1);
+  database.put("diameter", 1.0);
+  database.put("max_power", 10.);
+  database.put("scan_path_file", "scan_path.txt");
+  database.put("scan_path_file_format", "segment");
+
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  GoldakHeatSource<3> goldak_heat_source(database, units_optional_database);
+
+  // The scan path has a spot segment followed by a line along the x axis, so
+  // there is one box per segment.
+  double const end_time = 0.002501;
+  double const scaling_factor = 2.0;
+  auto const swept_boxes = goldak_heat_source.get_swept_bounding_boxes(
+      0., end_time, scaling_factor);
+  BOOST_TEST(swept_boxes.size() == 2u);
+
+  // The boxes cover the bounding box of the heat source at any time of the
+  // interval.
+  unsigned int const n_samples = 100;
+  for (unsigned int i = 0; i <= n_samples; ++i)
+  {
+    double const time = static_cast<double>(i) / n_samples * end_time;
+    auto const box = goldak_heat_source.get_bounding_box(time, scaling_factor);
+    auto const &[min_corner, max_corner] = box.get_boundary_points();
+    bool covered = false;
+    for (auto const &swept_box : swept_boxes)
+    {
+      if (swept_box.point_inside(min_corner, 1e-12) &&
+          swept_box.point_inside(max_corner, 1e-12))
+      {
+        covered = true;
+      }
+    }
+    BOOST_TEST(covered);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(heat_source_swept_bounding_boxes_past_path_end_3d)
+{
+  boost::property_tree::ptree database;
+
+  database.put("depth", 0.1);
+  database.put("absorption_efficiency", 0.1);
+  database.put("diameter", 1.0);
+  database.put("max_power", 10.);
+  database.put("scan_path_file", "scan_path.txt");
+  database.put("scan_path_file_format", "segment");
+
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  GoldakHeatSource<3> goldak_heat_source(database, units_optional_database);
+
+  // The scan path ends at 0.002501. The part of the interval after the end of
+  // the path does not add any box.
+  double const scaling_factor = 2.0;
+  auto const swept_boxes =
+      goldak_heat_source.get_swept_bounding_boxes(0., 0.01, scaling_factor);
+  auto const path_boxes =
+      goldak_heat_source.get_swept_bounding_boxes(0., 0.002501, scaling_factor);
+  BOOST_TEST(swept_boxes.size() == path_boxes.size());
+  for (unsigned int i = 0; i < swept_boxes.size(); ++i)
+  {
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      BOOST_TEST(swept_boxes[i].lower_bound(d) == path_boxes[i].lower_bound(d));
+      BOOST_TEST(swept_boxes[i].upper_bound(d) == path_boxes[i].upper_bound(d));
+    }
+  }
+
+  // There is no box if the interval starts after the end of the path.
+  BOOST_TEST(
+      goldak_heat_source.get_swept_bounding_boxes(0.003, 0.01, scaling_factor)
+          .empty());
+}
+
 BOOST_AUTO_TEST_CASE(heat_source_vectorized_value_3d, *utf::tolerance(1e-12))
 {
   unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
@@ -414,4 +538,117 @@ BOOST_AUTO_TEST_CASE(heat_source_vectorized_value_3d, *utf::tolerance(1e-12))
   }
 }
 
+BOOST_AUTO_TEST_CASE(heat_source_add_values_3d, *utf::tolerance(1e-12))
+{
+  unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
+
+  boost::property_tree::ptree database;
+
+  database.put("depth", 0.1);
+  database.put("absorption_efficiency", 0.1);
+  database.put("diameter", 1.0);
+  database.put("max_power", 10.);
+  database.put("scan_path_file", "scan_path.txt");
+  database.put("scan_path_file_format", "segment");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+
+  GoldakHeatSource<3> goldak_heat_source(database, units_optional_database);
+  ElectronBeamHeatSource<3> eb_heat_source(database, units_optional_database);
+  goldak_heat_source.update_time(0.001001);
+  eb_heat_source.update_time(0.001001);
+
+  // Points at the beam center, slightly off the beam center, outside of the
+  // radius, and below the depth of the heat sources.
+  std::vector<dealii::Point<3>> const scalar_points = {
+      dealii::Point<3>(8.0e-4, 0.1, 0.1), dealii::Point<3>(7.0e-4, 0.1, 0.09),
+      dealii::Point<3>(8.0e-4 + 1.2, 0.1, 0.1),
+      dealii::Point<3>(8.0e-4, 0.1, -0.01)};
+  unsigned int const n_q_points = scalar_points.size();
+  std::vector<dealii::Point<3, dealii::VectorizedArray<double>>> points(
+      n_q_points);
+  for (unsigned int q = 0; q < n_q_points; ++q)
+  {
+    // Shift the points in the different lanes to check that the lanes are
+    // independent.
+    for (unsigned int d = 0; d < 3; ++d)
+      for (unsigned int i = 0; i < n_lanes; ++i)
+        points[q][d][i] = scalar_points[(q + i) % n_q_points][d];
+  }
+
+  for (HeatSource<3> const *heat_source :
+       {static_cast<HeatSource<3> const *>(&goldak_heat_source),
+        static_cast<HeatSource<3> const *>(&eb_heat_source)})
+  {
+    // add_values adds to the values that are already present
+    std::vector<dealii::VectorizedArray<double>> values(n_q_points, 1.);
+    heat_source->add_values(points, values);
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      auto const vectorized_value = heat_source->value(points[q]);
+      for (unsigned int i = 0; i < n_lanes; ++i)
+      {
+        double const expected_value =
+            heat_source->value(scalar_points[(q + i) % n_q_points]);
+        BOOST_TEST(values[q][i] == 1. + expected_value);
+        BOOST_TEST(vectorized_value[i] == expected_value);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(heat_source_off_3d)
+{
+  unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
+
+  boost::property_tree::ptree database;
+  database.put("depth", 0.1);
+  database.put("absorption_efficiency", 0.1);
+  database.put("diameter", 1.0);
+  database.put("max_power", 10.);
+  database.put("scan_path_file", "scan_path.txt");
+  database.put("scan_path_file_format", "segment");
+  database.put("start_time", 0.);
+  database.put("end_time", 1.);
+  database.put("value", 10.);
+  database.put("min_x", 0.);
+  database.put("max_x", 1.);
+  database.put("min_y", 0.);
+  database.put("max_y", 1.);
+  database.put("min_z", 0.);
+  database.put("max_z", 1.);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+
+  GoldakHeatSource<3> goldak_heat_source(database, units_optional_database);
+  ElectronBeamHeatSource<3> eb_heat_source(database, units_optional_database);
+  CubeHeatSource<3> cube_heat_source(database, units_optional_database);
+
+  // All the heat sources are off after the end of the scan path or of the
+  // cube activity. The point is inside the support of the three sources.
+  dealii::Point<3> const point(8.0e-4, 0.1, 0.1);
+  std::vector<dealii::Point<3, dealii::VectorizedArray<double>>> points(1);
+  for (unsigned int d = 0; d < 3; ++d)
+    points[0][d] = point[d];
+  for (HeatSource<3> *heat_source :
+       {static_cast<HeatSource<3> *>(&goldak_heat_source),
+        static_cast<HeatSource<3> *>(&eb_heat_source),
+        static_cast<HeatSource<3> *>(&cube_heat_source)})
+  {
+    heat_source->update_time(0.001001);
+    BOOST_TEST(heat_source->is_source_on() == true);
+    BOOST_TEST(heat_source->value(point) > 0.);
+
+    heat_source->update_time(100.);
+    BOOST_TEST(heat_source->is_source_on() == false);
+    BOOST_TEST(heat_source->value(point) == 0.);
+    std::vector<dealii::VectorizedArray<double>> values(1, 1.);
+    heat_source->add_values(points, values);
+    auto const vectorized_value = heat_source->value(points[0]);
+    for (unsigned int i = 0; i < n_lanes; ++i)
+    {
+      BOOST_TEST(values[0][i] == 1.);
+      BOOST_TEST(vectorized_value[i] == 0.);
+    }
+  }
+}
+
 } // namespace adamantine
@@ -7,8 +7,14 @@
 
 #include "../application/adamantine.hh"
 
+#include <ElectronBeamHeatSource.hh>
+
+#include <deal.II/base/function.h>
+#include <deal.II/numerics/vector_tools.h>
+
 #include <boost/property_tree/info_parser.hpp>
 
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 
@@ -16,6 +22,85 @@
 
 namespace utf = boost::unit_test;
 
+namespace
+{
+/**
+ * ThermalPhysics on an 8x8 mesh of the unit square with adiabatic boundaries
+ * and a single material whose properties are one. The two top rows of cells
+ * do not have material yet. The heat sources and the time stepping are given
+ * by @p database. The ThermalPhysics references the other members, so the
+ * object cannot be copied.
+ */
+struct ThermalPhysics2D
+{
+  static boost::property_tree::ptree create_geometry_database()
+  {
+    boost::property_tree::ptree geometry_database;
+    geometry_database.put("import_mesh", false);
+    geometry_database.put("length", 1.);
+    geometry_database.put("length_divisions", 8);
+    geometry_database.put("height", 1.);
+    geometry_database.put("height_divisions", 8);
+    return geometry_database;
+  }
+
+  static boost::property_tree::ptree create_boundary_database()
+  {
+    boost::property_tree::ptree boundary_database;
+    boundary_database.put("type", "adiabatic");
+    return boundary_database;
+  }
+
+  static boost::property_tree::ptree create_material_property_database()
+  {
+    boost::property_tree::ptree material_property_database;
+    material_property_database.put("property_format", "polynomial");
+    material_property_database.put("n_materials", 1);
+    for (std::string state : {"solid", "powder", "liquid"})
+    {
+      material_property_database.put("material_0." + state + ".density", 1.);
+      material_property_database.put("material_0." + state + ".specific_heat",
+                                     1.);
+      material_property_database.put(
+          "material_0." + state + ".thermal_conductivity_x", 1.);
+      material_property_database.put(
+          "material_0." + state + ".thermal_conductivity_z", 1.);
+    }
+    return material_property_database;
+  }
+
+  ThermalPhysics2D(MPI_Comm const &communicator,
+                   boost::property_tree::ptree database)
+      : geometry(communicator, create_geometry_database(),
+                 boost::optional<boost::property_tree::ptree const &>()),
+        boundary(create_boundary_database(),
+                 geometry.get_triangulation().get_boundary_ids()),
+        material_properties(communicator, geometry.get_triangulation(),
+                            create_material_property_database())
+  {
+    database.put("geometry.material_height", 0.75);
+    thermal_physics = std::make_unique<adamantine::ThermalPhysics<
+        2, 1, 1, 2, adamantine::SolidLiquidPowder, dealii::MemorySpace::Host,
+        dealii::QGauss<1>>>(communicator, database, geometry, boundary,
+                            material_properties);
+    thermal_physics->setup();
+  }
+
+  ThermalPhysics2D(ThermalPhysics2D const &) = delete;
+
+  ThermalPhysics2D &operator=(ThermalPhysics2D const &) = delete;
+
+  adamantine::Geometry<2> geometry;
+  adamantine::Boundary boundary;
+  adamantine::MaterialProperty<2, 1, 1, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      material_properties;
+  std::unique_ptr<
+      adamantine::ThermalPhysicsInterface<2, dealii::MemorySpace::Host>>
+      thermal_physics;
+};
+} // namespace
+
 BOOST_AUTO_TEST_CASE(integration_2D, *utf::tolerance(0.1))
 {
   MPI_Comm communicator = MPI_COMM_WORLD;
@@ -101,3 +186,299 @@ BOOST_AUTO_TEST_CASE(integration_2D_units, *utf::tolerance(0.1))
     BOOST_TEST(temperature.local_element(i) == gold_value);
   }
 }
+
+// This is the same test as integration_2D but the thermal operator is evaluated
+// in single precision
+BOOST_AUTO_TEST_CASE(integration_2D_single_precision, *utf::tolerance(0.1))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  std::vector<adamantine::Timer> timers;
+  initialize_timers(communicator, timers);
+
+  // Read the input.
+  std::string const filename = "integration_2d.info";
+  adamantine::ASSERT_THROW(std::filesystem::exists(filename) == true,
+                           "The file " + filename + " does not exist.");
+  boost::property_tree::ptree database;
+  boost::property_tree::info_parser::read_info(filename, database);
+  database.put("discretization.thermal.precision", "single");
+
+  auto [temperature, displacement] =
+      run<2, 1, 4, adamantine::SolidLiquidPowder, dealii::MemorySpace::Host>(
+          communicator, database, timers);
+
+  std::ifstream gold_file("integration_2d_gold.txt");
+  for (unsigned int i = 0; i < temperature.locally_owned_size(); ++i)
+  {
+    double gold_value = -1.;
+    gold_file >> gold_value;
+    BOOST_TEST(temperature.local_element(i) == gold_value);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_time_step_events, *utf::tolerance(1e-9))
+{
+  // The first segment of the scan path ends at 1e-6 s and the second one at
+  // 2.501e-3 s.
+  boost::property_tree::ptree beam_database;
+  beam_database.put("depth", 0.1);
+  beam_database.put("absorption_efficiency", 0.1);
+  beam_database.put("diameter", 1.0);
+  beam_database.put("max_power", 10.);
+  beam_database.put("scan_path_file", "scan_path.txt");
+  beam_database.put("scan_path_file_format", "segment");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  std::vector<std::shared_ptr<adamantine::HeatSource<2>>> heat_sources = {
+      std::make_shared<adamantine::ElectronBeamHeatSource<2>>(
+          beam_database, units_optional_database)};
+  std::vector<double> const deposition_times = {3e-3};
+
+  // No event before the end of the step: the suggested time step is used.
+  BOOST_TEST(clamp_time_step_to_next_event(1e-3, 1e-4, heat_sources,
+                                           deposition_times) == 1e-4);
+  // The step is clamped to land on the end of the scan path segments.
+  BOOST_TEST(clamp_time_step_to_next_event(0., 1e-4, heat_sources,
+                                           deposition_times) == 1e-6);
+  BOOST_TEST(clamp_time_step_to_next_event(2.5e-3, 1e-4, heat_sources,
+                                           deposition_times) == 1e-6);
+  // Once on the event, the next event is the deposition time.
+  BOOST_TEST(clamp_time_step_to_next_event(2.501e-3, 1e-3, heat_sources,
+                                           deposition_times) == 4.99e-4);
+  // There is no event left after the deposition.
+  BOOST_TEST(clamp_time_step_to_next_event(3e-3, 1e-3, heat_sources,
+                                           deposition_times) == 1e-3);
+
+  // The step grows and shrinks as suggested by the time stepping scheme.
+  BOOST_TEST(update_adaptive_time_step(1e-4, 1e-4, 1.2e-4) == 1.2e-4);
+  BOOST_TEST(update_adaptive_time_step(1e-4, 1e-4, 8e-5) == 8e-5);
+  // A step shortened by an event that was accepted as is does not reduce the
+  // suggested time step.
+  BOOST_TEST(update_adaptive_time_step(1e-4, 1e-6, 1.2e-6) == 1e-4);
+  // A step shortened by an event that was rejected reduces it.
+  BOOST_TEST(update_adaptive_time_step(1e-4, 1e-6, 8e-7) == 8e-7);
+}
+
+BOOST_AUTO_TEST_CASE(flag_cells_from_error_estimator_2d)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  boost::property_tree::ptree database;
+  database.put("sources.n_beams", 0);
+  database.put("time_stepping.method", "forward_euler");
+  ThermalPhysics2D physics(communicator, database);
+  adamantine::Geometry<2> &geometry = physics.geometry;
+  auto &thermal_physics = physics.thermal_physics;
+
+  // The temperature is bilinear on each side of x = 0.5 and its normal
+  // derivative jumps by 1 + 4y across x = 0.5. The jump increases with y, so
+  // the cells next to x = 0.5 are ranked by row. The temperature also has a
+  // large gradient across the interface with the cells without material at
+  // y = 0.75, which must not be seen as an error.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> solution;
+  thermal_physics->initialize_dof_vector(0., solution);
+  dealii::ScalarFunctionFromFunctionObject<2> temperature(
+      [](dealii::Point<2> const &p)
+      { return 10. * p[1] + (1. + 4. * p[1]) * std::max(p[0] - 0.5, 0.); });
+  dealii::VectorTools::interpolate(thermal_physics->get_dof_handler(),
+                                   temperature, solution);
+
+  // The cells of the first row next to x = 0.5 are on the beam path.
+  auto const is_kink_cell = [](auto const &cell)
+  { return std::abs(cell->center()[0] - 0.5) < 0.1; };
+  std::vector<dealii::parallel::distributed::Triangulation<2>::
+                  active_cell_iterator>
+      cells_to_refine;
+  for (auto const &cell : geometry.get_triangulation().active_cell_iterators())
+  {
+    if (cell->is_locally_owned() && is_kink_cell(cell) &&
+        (cell->center()[1] < 0.125))
+      cells_to_refine.push_back(cell);
+  }
+
+  // There are 46 ranked cells, so 4 of them are refined.
+  flag_cells_from_error_estimator<2, 2>(
+      thermal_physics, solution, cells_to_refine, 2, 0.09, 0.5,
+      std::numeric_limits<dealii::types::global_cell_index>::max());
+
+  unsigned int n_refined_cells = 0;
+  for (auto const &cell : thermal_physics->get_dof_handler()
+                              .active_cell_iterators())
+  {
+    if (!cell->is_locally_owned())
+      continue;
+
+    bool const has_material = cell->active_fe_index() == 0;
+    bool const on_beam_path = is_kink_cell(cell) && (cell->center()[1] < 0.125);
+    if (!has_material || on_beam_path)
+    {
+      // The cells that are not ranked are not flagged.
+      BOOST_TEST(!cell->refine_flag_set());
+      BOOST_TEST(!cell->coarsen_flag_set());
+    }
+    else if (is_kink_cell(cell))
+    {
+      // Only the two rows below the interface are refined. The cells next to
+      // x = 0.5 are never coarsened.
+      BOOST_TEST(cell->refine_flag_set() == (cell->center()[1] > 0.5));
+      BOOST_TEST(!cell->coarsen_flag_set());
+    }
+    else
+    {
+      BOOST_TEST(!cell->refine_flag_set());
+    }
+    if (cell->refine_flag_set())
+      ++n_refined_cells;
+  }
+  BOOST_TEST(dealii::Utilities::MPI::sum(n_refined_cells, communicator) == 4u);
+}
+
+BOOST_AUTO_TEST_CASE(repartition_on_load_imbalance_2d)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  unsigned int const n_procs =
+      dealii::Utilities::MPI::n_mpi_processes(communicator);
+
+  // The heat source covers the bottom left quarter of the domain. The initial
+  // partition ignores the cost of the cells, so the processors owning the
+  // bottom left of the domain have more work.
+  boost::property_tree::ptree database;
+  database.put("sources.n_beams", 1);
+  database.put("sources.beam_0.type", "cube");
+  database.put("sources.beam_0.start_time", -1.);
+  database.put("sources.beam_0.end_time", 1.);
+  database.put("sources.beam_0.value", 1.);
+  database.put("sources.beam_0.min_x", 0.);
+  database.put("sources.beam_0.min_y", 0.);
+  database.put("sources.beam_0.max_x", 0.45);
+  database.put("sources.beam_0.max_y", 0.45);
+  database.put("time_stepping.method", "forward_euler");
+  ThermalPhysics2D physics(communicator, database);
+  dealii::parallel::distributed::Triangulation<2> &triangulation =
+      physics.geometry.get_triangulation();
+  auto &material_properties = physics.material_properties;
+  auto &thermal_physics = physics.thermal_physics;
+  for (auto &beam : thermal_physics->get_heat_sources())
+    beam->update_time(0.);
+  std::unique_ptr<adamantine::MechanicalPhysics<
+      2, 1, 1, adamantine::SolidLiquidPowder, dealii::MemorySpace::Host>>
+      mechanical_physics;
+  dealii::DoFHandler<2> &dof_handler = thermal_physics->get_dof_handler();
+
+  // The temperature, the material state, the deposition angle, and the melted
+  // indicator of a cell are given by its position.
+  dealii::ScalarFunctionFromFunctionObject<2> temperature(
+      [](dealii::Point<2> const &p) { return 1. + p[0] * p[1]; });
+  auto const liquid_ratio = [](auto const &cell)
+  { return 0.5 * cell->center()[0] + 0.25 * cell->center()[1]; };
+  auto const angle = [](auto const &cell)
+  { return cell->center()[0] + 2. * cell->center()[1]; };
+  auto const has_melted = [](auto const &cell)
+  { return cell->center()[0] > 0.5; };
+  unsigned int constexpr liquid =
+      static_cast<unsigned int>(adamantine::SolidLiquidPowder::State::liquid);
+  unsigned int constexpr solid =
+      static_cast<unsigned int>(adamantine::SolidLiquidPowder::State::solid);
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> solution;
+  thermal_physics->initialize_dof_vector(0., solution);
+  dealii::VectorTools::interpolate(dof_handler, temperature, solution);
+
+  auto state = material_properties.get_state();
+  auto state_host = Kokkos::create_mirror_view(state);
+  Kokkos::deep_copy(state_host, 0.);
+  std::vector<double> deposition_cos;
+  std::vector<double> deposition_sin;
+  std::vector<bool> melted;
+  unsigned int cell_id = 0;
+  for (auto const &cell : dof_handler.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    state_host(liquid, cell_id) = liquid_ratio(cell);
+    state_host(solid, cell_id) = 1. - liquid_ratio(cell);
+    if (cell->active_fe_index() == 0)
+    {
+      deposition_cos.push_back(std::cos(angle(cell)));
+      deposition_sin.push_back(std::sin(angle(cell)));
+      melted.push_back(has_melted(cell));
+    }
+    ++cell_id;
+  }
+  Kokkos::deep_copy(state, state_host);
+  thermal_physics->get_state_from_material_properties();
+  thermal_physics->set_material_deposition_orientation(deposition_cos,
+                                                       deposition_sin);
+  thermal_physics->set_has_melted_vector(melted);
+
+  // Return the ratio between the largest and the average cost of the
+  // processors given by the load balancing weights of the cells.
+  auto const compute_cost_imbalance = [&]()
+  {
+    double cost = 0.;
+    for (auto const &cell : triangulation.active_cell_iterators() |
+                                dealii::IteratorFilters::LocallyOwnedCell())
+      cost += triangulation.signals.weight(
+          cell, dealii::CellStatus::cell_will_persist);
+    dealii::Utilities::MPI::MinMaxAvg const cost_stats =
+        dealii::Utilities::MPI::min_max_avg(cost, communicator);
+    return cost_stats.max / cost_stats.avg;
+  };
+  double const cost_imbalance_before = compute_cost_imbalance();
+
+  // Force the load imbalance: only the first processor has spent time
+  // evaluating the thermal physics.
+  double const local_time =
+      dealii::Utilities::MPI::this_mpi_process(communicator) == 0 ? 1. : 0.;
+  double const load_imbalance_threshold = 1.5;
+  double const load_imbalance =
+      compute_load_imbalance(communicator, local_time);
+  if (n_procs > 1)
+    BOOST_TEST(load_imbalance > load_imbalance_threshold);
+  if (load_imbalance > load_imbalance_threshold)
+    repartition_mesh(thermal_physics, mechanical_physics, material_properties,
+                     solution);
+
+  // The cost is spread more evenly between the processors.
+  double const cost_imbalance_after = compute_cost_imbalance();
+  if (n_procs > 1)
+  {
+    BOOST_TEST(cost_imbalance_before > 1.2);
+    BOOST_TEST(cost_imbalance_after < cost_imbalance_before);
+    BOOST_TEST(cost_imbalance_after < 1.15);
+  }
+
+  // The solution is transferred exactly since the mesh has not changed.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> error;
+  thermal_physics->initialize_dof_vector(0., error);
+  dealii::VectorTools::interpolate(dof_handler, temperature, error);
+  error -= solution;
+  BOOST_TEST(error.linfty_norm() < 1e-12);
+
+  // The cell data follow the cells.
+  thermal_physics->set_state_to_material_properties();
+  auto const transferred_state = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, material_properties.get_state());
+  cell_id = 0;
+  unsigned int activated_cell_id = 0;
+  for (auto const &cell : dof_handler.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    if (cell->active_fe_index() == 0)
+    {
+      BOOST_TEST(transferred_state(liquid, cell_id) == liquid_ratio(cell),
+                 boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(transferred_state(solid, cell_id) == 1. - liquid_ratio(cell),
+                 boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(thermal_physics->get_deposition_cos(activated_cell_id) ==
+                     std::cos(angle(cell)),
+                 boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(thermal_physics->get_deposition_sin(activated_cell_id) ==
+                     std::sin(angle(cell)),
+                 boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(thermal_physics->get_has_melted(activated_cell_id) ==
+                 has_melted(cell));
+      ++activated_cell_id;
+    }
+    ++cell_id;
+  }
+}
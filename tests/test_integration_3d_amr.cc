@@ -57,6 +57,50 @@ BOOST_AUTO_TEST_CASE(integration_3D_amr, *utf::tolerance(0.1))
   BOOST_TEST(expected_min == global_min);
 }
 
+BOOST_AUTO_TEST_CASE(integration_3D_amr_deferred_dofs, *utf::tolerance(0.1))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  std::vector<adamantine::Timer> timers;
+  initialize_timers(communicator, timers);
+
+  // Read the input.
+  std::string const filename = "amr_test.info";
+  adamantine::ASSERT_THROW(std::filesystem::exists(filename) == true,
+                           "The file " + filename + " does not exist.");
+  boost::property_tree::ptree database;
+  boost::property_tree::info_parser::read_info(filename, database);
+  database.put("refinement.deferred_dofs", true);
+
+  auto [temperature, displacement] =
+      run<3, -1, 4, adamantine::SolidLiquidPowder, dealii::MemorySpace::Host>(
+          communicator, database, timers);
+
+  double min_val = std::numeric_limits<double>::max();
+  double max_val = std::numeric_limits<double>::min();
+  for (unsigned int i = 0; i < temperature.locally_owned_size(); ++i)
+  {
+    if (temperature.local_element(i) < min_val)
+      min_val = temperature.local_element(i);
+
+    if (temperature.local_element(i) > max_val)
+      max_val = temperature.local_element(i);
+  }
+
+  double global_max =
+      dealii::Utilities::MPI::max(max_val, temperature.get_mpi_communicator());
+  double global_min =
+      dealii::Utilities::MPI::min(min_val, temperature.get_mpi_communicator());
+
+  // Deferring the setup of the DoFs creates the same mesh and interpolates the
+  // solution exactly, so the result is the same as with the default refinement.
+  double expected_max = 329.5;
+  double expected_min = 296.1;
+
+  BOOST_TEST(expected_max == global_max);
+  BOOST_TEST(expected_min == global_min);
+}
+
 BOOST_AUTO_TEST_CASE(integration_3D_amr_refine_coarsen, *utf::tolerance(0.1))
 {
   MPI_Comm communicator = MPI_COMM_WORLD;
@@ -10,6 +10,8 @@
 #include "test_material_property.hh"
 // clang-format on
 
+#include <EnthalpyTable.hh>
+
 BOOST_AUTO_TEST_CASE(material_property_host)
 {
   material_property<dealii::MemorySpace::Host>();
@@ -22,7 +24,186 @@ BOOST_AUTO_TEST_CASE(material_property_table_host)
   material_property_table<dealii::MemorySpace::Host>();
 }
 
+BOOST_AUTO_TEST_CASE(material_property_table_samples_host)
+{
+  material_property_table_samples<dealii::MemorySpace::Host>();
+}
+
 BOOST_AUTO_TEST_CASE(material_property_polynomials_host)
 {
   material_property_polynomials<dealii::MemorySpace::Host>();
 }
+
+BOOST_AUTO_TEST_CASE(material_property_table_vectorized_host)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  boost::property_tree::ptree database;
+  boost::property_tree::read_info("material_property_table.info", database);
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database =
+      database.get_child("geometry");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree material_database =
+      database.get_child("materials");
+  using MaterialPropertyType =
+      adamantine::MaterialProperty<2, -1, 0, adamantine::SolidLiquidPowder,
+                                   dealii::MemorySpace::Host>;
+  MaterialPropertyType mat_prop(communicator, triangulation,
+                                material_database);
+  auto state_property_tables = mat_prop.get_state_property_tables();
+
+  // Compare the vectorized lookup with the scalar lookup below, inside, and
+  // above the tables. The lanes use different materials.
+  unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
+  std::array<dealii::types::material_id, n_lanes> material_id;
+  dealii::VectorizedArray<double> temperature;
+  for (unsigned int n = 0; n < n_lanes; ++n)
+    material_id[n] = n % 2;
+  for (unsigned int state = 0;
+       state < adamantine::SolidLiquidPowder::n_material_states; ++state)
+    for (unsigned int property = 0;
+         property < adamantine::g_n_thermal_state_properties; ++property)
+      for (double t = -5.; t < 40.; t += 0.75)
+      {
+        for (unsigned int n = 0; n < n_lanes; ++n)
+          temperature[n] = t + 2. * n;
+        auto const value = mat_prop.compute_property_from_table(
+            material_id, property, state, temperature);
+        for (unsigned int n = 0; n < n_lanes; ++n)
+        {
+          double const ref = MaterialPropertyType::compute_property_from_table(
+              state_property_tables, material_id[n], property, state,
+              temperature[n]);
+          BOOST_TEST(value[n] == ref, tt::tolerance(1e-12));
+        }
+      }
+}
+
+BOOST_AUTO_TEST_CASE(enthalpy_table_host)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 12);
+  geometry_database.put("length_divisions", 4);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 5);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+
+  // Create the MaterialProperty. The freezing range is only 2 K wide.
+  boost::property_tree::ptree database;
+  database.put("property_format", "polynomial");
+  database.put("n_materials", 1);
+  database.put("material_0.solid.density", 2.);
+  database.put("material_0.solid.specific_heat", 3.);
+  database.put("material_0.liquid.density", 2.);
+  database.put("material_0.liquid.specific_heat", 5.);
+  database.put("material_0.solidus", "100");
+  database.put("material_0.liquidus", "102");
+  database.put("material_0.latent_heat", "1000");
+  adamantine::MaterialProperty<2, 1, 0, adamantine::SolidLiquid,
+                               dealii::MemorySpace::Host>
+      mat_prop(communicator, triangulation, database);
+
+  adamantine::EnthalpyTable<2, 1, 0, adamantine::SolidLiquid,
+                            dealii::MemorySpace::Host>
+      enthalpy_table(mat_prop, 1, 4000.);
+
+  // Solid: rho C_p = 6
+  BOOST_TEST(enthalpy_table.get_enthalpy(0, 50.) == 300.,
+             tt::tolerance(1e-12));
+  BOOST_TEST(enthalpy_table.get_enthalpy(0, 100.) == 600.,
+             tt::tolerance(1e-12));
+  // The whole latent heat, rho L = 2000, is released in the freezing range.
+  BOOST_TEST(enthalpy_table.get_enthalpy(0, 102.) == 2616.,
+             tt::tolerance(1e-12));
+  // Liquid: rho C_p = 10
+  BOOST_TEST(enthalpy_table.get_enthalpy(0, 200.) == 3596.,
+             tt::tolerance(1e-12));
+  // Linear extrapolation above the table
+  BOOST_TEST(enthalpy_table.get_enthalpy(0, 5000.) ==
+                 enthalpy_table.get_enthalpy(0, 4000.) + 10000.,
+             tt::tolerance(1e-12));
+
+  // The temperature is recovered from the enthalpy, including inside the
+  // freezing range.
+  for (double t = 10.; t < 4500.; t += 0.7)
+  {
+    double const enthalpy = enthalpy_table.get_enthalpy(0, t);
+    BOOST_TEST(enthalpy_table.get_temperature(0, enthalpy) == t,
+               tt::tolerance(1e-10));
+  }
+  BOOST_TEST(enthalpy_table.get_temperature(0, 1608.) == 101.,
+             tt::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(material_property_polynomials_vectorized_host)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  boost::property_tree::ptree database;
+  boost::property_tree::read_info("material_property_polynomial.info",
+                                  database);
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database =
+      database.get_child("geometry");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree material_database =
+      database.get_child("materials");
+  adamantine::MaterialProperty<2, -1, 4, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      mat_prop(communicator, triangulation, material_database);
+
+  // Compare the vectorized evaluation with the scalar evaluation for a batch
+  // with a single material and for a batch with different materials.
+  unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
+  unsigned int constexpr n_states =
+      adamantine::SolidLiquidPowder::n_material_states;
+  std::array<dealii::VectorizedArray<double>, n_states> state_ratios;
+  state_ratios[0] = 0.5;
+  state_ratios[1] = 0.3;
+  state_ratios[2] = 0.2;
+  std::array<double, n_states> const scalar_state_ratios = {{0.5, 0.3, 0.2}};
+  dealii::VectorizedArray<double> temperature;
+  for (unsigned int n = 0; n < n_lanes; ++n)
+    temperature[n] = 10. + 3. * n;
+  dealii::AlignedVector<dealii::VectorizedArray<double>> temperature_powers(5);
+  temperature_powers[0] = 1.;
+  for (unsigned int i = 1; i < 5; ++i)
+    temperature_powers[i] = temperature_powers[i - 1] * temperature;
+
+  for (unsigned int mixed = 0; mixed < 2; ++mixed)
+  {
+    std::array<dealii::types::material_id, n_lanes> material_id;
+    for (unsigned int n = 0; n < n_lanes; ++n)
+      material_id[n] = mixed ? n % 2 : 1;
+    auto const value = mat_prop.compute_material_property<
+        false, adamantine::StateProperty::density, double>(
+        material_id, state_ratios, temperature, temperature_powers);
+    for (unsigned int n = 0; n < n_lanes; ++n)
+    {
+      double const ref = mat_prop.compute_material_property<false>(
+          adamantine::StateProperty::density, material_id[n],
+          scalar_state_ratios.data(), temperature[n]);
+      BOOST_TEST(value[n] == ref, tt::tolerance(1e-12));
+    }
+  }
+}
@@ -363,6 +363,82 @@ void material_property_table()
   }
 }
 
+template <typename MemorySpaceType>
+void material_property_table_samples()
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  boost::property_tree::ptree database;
+  boost::property_tree::read_info("material_property_table.info", database);
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database =
+      database.get_child("geometry");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree material_database =
+      database.get_child("materials");
+  using MaterialPropertyType =
+      adamantine::MaterialProperty<2, -1, 0, adamantine::SolidLiquidPowder,
+                                   MemorySpaceType>;
+  MaterialPropertyType mat_prop(communicator, triangulation,
+                                material_database);
+
+  // The samples only locate the temperature in the tables, the interpolation
+  // uses the nodes of the tables. The temperatures below include the nodes of
+  // the tables and temperatures in the sampling intervals that contain a node.
+  unsigned int constexpr n_temperatures = 15;
+  std::array<double, n_temperatures> const temperatures = {
+      {-5., 0., 5., 9.99, 10., 10.01, 14., 15., 17.95, 18., 18.02, 20., 25.,
+       30., 40.}};
+  unsigned int constexpr n_states =
+      adamantine::SolidLiquidPowder::n_material_states;
+  unsigned int const n_values = 2 * adamantine::g_n_thermal_state_properties *
+                                n_states * n_temperatures;
+  Kokkos::View<double *, typename MemorySpaceType::kokkos_space> table_values(
+      "table_values", n_values);
+  Kokkos::View<double *, typename MemorySpaceType::kokkos_space>
+      sample_values("sample_values", n_values);
+  auto state_property_tables = mat_prop.get_state_property_tables();
+  auto state_property_sample_intervals =
+      mat_prop.get_state_property_sample_intervals();
+  auto state_property_sample_grids = mat_prop.get_state_property_sample_grids();
+  using ExecutionSpace = std::conditional_t<
+      std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>,
+      Kokkos::DefaultHostExecutionSpace, Kokkos::DefaultExecutionSpace>;
+  Kokkos::parallel_for(
+      "material_property_table_samples",
+      Kokkos::RangePolicy<ExecutionSpace>(0, n_values), KOKKOS_LAMBDA(int i) {
+        double const temperature = temperatures[i % n_temperatures];
+        unsigned int const material_state = (i / n_temperatures) % n_states;
+        unsigned int const property =
+            (i / (n_temperatures * n_states)) %
+            adamantine::g_n_thermal_state_properties;
+        unsigned int const material_id =
+            i / (n_temperatures * n_states *
+                 adamantine::g_n_thermal_state_properties);
+        table_values(i) = MaterialPropertyType::compute_property_from_table(
+            state_property_tables, material_id, property, material_state,
+            temperature);
+        sample_values(i) = MaterialPropertyType::compute_property_from_samples(
+            state_property_tables, state_property_sample_intervals,
+            state_property_sample_grids, material_id, property, material_state,
+            temperature);
+      });
+
+  auto table_values_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::DefaultHostExecutionSpace{}, table_values);
+  auto sample_values_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::DefaultHostExecutionSpace{}, sample_values);
+  for (unsigned int i = 0; i < n_values; ++i)
+    BOOST_TEST(sample_values_host(i) == table_values_host(i),
+               tt::tolerance(1e-12));
+}
+
 template <typename MemorySpaceType>
 void material_property_polynomials()
 {
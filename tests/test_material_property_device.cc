@@ -22,6 +22,11 @@ BOOST_AUTO_TEST_CASE(material_property_table_device)
   material_property_table<dealii::MemorySpace::Default>();
 }
 
+BOOST_AUTO_TEST_CASE(material_property_table_samples_device)
+{
+  material_property_table_samples<dealii::MemorySpace::Default>();
+}
+
 BOOST_AUTO_TEST_CASE(material_property_polynomials_device)
 {
   material_property_polynomials<dealii::MemorySpace::Default>();
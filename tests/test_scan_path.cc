@@ -103,4 +103,17 @@ BOOST_AUTO_TEST_CASE(scan_path_location, *utf::tolerance(1e-10))
   BOOST_TEST(power == 0.0);
 }
 
+BOOST_AUTO_TEST_CASE(scan_path_next_segment_end_time)
+{
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  ScanPath scan_path("scan_path_event_series.inp", "event_series",
+                     units_optional_database);
+
+  BOOST_TEST(scan_path.get_next_segment_end_time(0.) == 0.1);
+  BOOST_TEST(scan_path.get_next_segment_end_time(0.1) == 1.0);
+  BOOST_TEST(scan_path.get_next_segment_end_time(1.5) == 2.0);
+  BOOST_TEST(scan_path.get_next_segment_end_time(2.0) ==
+             std::numeric_limits<double>::max());
+}
+
 } // namespace adamantine
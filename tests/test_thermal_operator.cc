@@ -950,3 +950,115 @@ BOOST_AUTO_TEST_CASE(spmv_conv, *utf::tolerance(1e-12))
     BOOST_TEST(dst_1 == dst_2, tt::per_element());
   }
 }
+
+BOOST_AUTO_TEST_CASE(coefficient_cache, *utf::tolerance(1e-12))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 12);
+  geometry_database.put("length_divisions", 4);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 5);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+
+  // Create the Boundary
+  boost::property_tree::ptree boundary_database;
+  boundary_database.put("type", "adiabatic");
+  adamantine::Boundary boundary(
+      boundary_database, geometry.get_triangulation().get_boundary_ids());
+
+  // Create the DoFHandler
+  dealii::hp::FECollection<2> fe_collection;
+  fe_collection.push_back(dealii::FE_Q<2>(2));
+  fe_collection.push_back(dealii::FE_Nothing<2>());
+  dealii::DoFHandler<2> dof_handler(geometry.get_triangulation());
+  dof_handler.distribute_dofs(fe_collection);
+  dealii::AffineConstraints<double> affine_constraints;
+  affine_constraints.close();
+  dealii::hp::QCollection<1> q_collection;
+  q_collection.push_back(dealii::QGauss<1>(3));
+  q_collection.push_back(dealii::QGauss<1>(1));
+
+  // Create the MaterialProperty. The thermal conductivity depends on the
+  // temperature.
+  boost::property_tree::ptree mat_prop_database;
+  mat_prop_database.put("property_format", "polynomial");
+  mat_prop_database.put("n_materials", 1);
+  mat_prop_database.put("material_0.solidus", 1000.);
+  mat_prop_database.put("material_0.liquidus", 1100.);
+  mat_prop_database.put("material_0.latent_heat", 100.);
+  for (std::string state : {"solid", "powder", "liquid"})
+  {
+    mat_prop_database.put("material_0." + state + ".density", 1.);
+    mat_prop_database.put("material_0." + state + ".specific_heat", 1.);
+    mat_prop_database.put("material_0." + state + ".thermal_conductivity_x",
+                          "1.,0.01");
+    mat_prop_database.put("material_0." + state + ".thermal_conductivity_z",
+                          "1.,0.01");
+  }
+  adamantine::MaterialProperty<2, 1, 1, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      mat_properties(communicator, geometry.get_triangulation(),
+                     mat_prop_database);
+
+  // Initialize the ThermalOperators with and without the coefficient cache.
+  // The tolerance of the cache is large enough that the coefficients are only
+  // recomputed when the temperature reaches the solidus.
+  std::vector<std::shared_ptr<adamantine::HeatSource<2>>> heat_sources;
+  adamantine::ThermalOperator<2, 1, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      thermal_operator(communicator, boundary, mat_properties, heat_sources);
+  adamantine::ThermalOperator<2, 1, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      cached_thermal_operator(communicator, boundary, mat_properties,
+                              heat_sources, 1e10);
+  std::vector<double> deposition_cos(
+      geometry.get_triangulation().n_locally_owned_active_cells(), 1.);
+  std::vector<double> deposition_sin(
+      geometry.get_triangulation().n_locally_owned_active_cells(), 0.);
+  for (auto op : {&thermal_operator, &cached_thermal_operator})
+  {
+    op->reinit(dof_handler, affine_constraints, q_collection);
+    op->set_material_deposition_orientation(deposition_cos, deposition_sin);
+    op->compute_inverse_mass_matrix(dof_handler, affine_constraints);
+    op->get_state_from_material_properties();
+  }
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_cached;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      dst_shifted;
+  thermal_operator.initialize_dof_vector(src);
+  thermal_operator.initialize_dof_vector(dst);
+  thermal_operator.initialize_dof_vector(dst_cached);
+  thermal_operator.initialize_dof_vector(dst_shifted);
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = 300. + i;
+
+  // The first application fills the cache
+  thermal_operator.vmult(dst, src);
+  cached_thermal_operator.vmult(dst_cached, src);
+  BOOST_TEST(dst_cached == dst, tt::per_element());
+
+  // Shifting the temperature does not change its gradient. Below the solidus,
+  // the cached operator keeps using the coefficients of the first application
+  // while the coefficients of the other operator change.
+  src.add(100.);
+  thermal_operator.vmult(dst_shifted, src);
+  cached_thermal_operator.vmult(dst_cached, src);
+  BOOST_TEST(dst_cached == dst, tt::per_element());
+  dst_shifted -= dst;
+  BOOST_TEST(dst_shifted.l2_norm() > 1e-3);
+
+  // Above the solidus, the coefficients are always recomputed
+  src.add(1000.);
+  thermal_operator.vmult(dst, src);
+  cached_thermal_operator.vmult(dst_cached, src);
+  BOOST_TEST(dst_cached == dst, tt::per_element());
+}
@@ -30,6 +30,130 @@ BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_host)
   thermal_2d_manufactured_solution<dealii::MemorySpace::Host>();
 }
 
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_backward_euler_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>("backward_euler");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_sdirk2_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>("sdirk2");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>("rk_fourth_order", 1e-4,
+                                                     5e-4);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_backward_euler_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>("backward_euler", 1e-3,
+                                                     3e-3);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_sdirk2_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>("sdirk2", 1e-3, 5e-4);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_multirate_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>(
+      "multirate_forward_euler", "identity", true);
+}
+
+BOOST_AUTO_TEST_CASE(
+    thermal_2d_manufactured_solution_low_storage_rk_third_order_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>(
+      "low_storage_rk_third_order");
+}
+
+BOOST_AUTO_TEST_CASE(
+    thermal_2d_manufactured_solution_low_storage_rk_fourth_order_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>(
+      "low_storage_rk_fourth_order");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_bogacki_shampine_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>(
+      "bogacki_shampine");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_dopri_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>("dopri");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_chebyshev_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>("backward_euler",
+                                                              "chebyshev");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_multigrid_host)
+{
+  thermal_2d_manufactured_solution<dealii::MemorySpace::Host>("backward_euler",
+                                                              "multigrid");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_multirate_host)
+{
+  // The mesh is locally refined so that the DoFs are updated with different
+  // time steps.
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>(
+      "multirate_forward_euler", 5e-5, 5e-4, "identity", true);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_low_storage_rk_third_order_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>(
+      "low_storage_rk_third_order", 1e-4, 5e-4);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_low_storage_rk_fourth_order_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>(
+      "low_storage_rk_fourth_order", 1e-4, 5e-4);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_bogacki_shampine_host)
+{
+  // The first time step is much smaller than needed, so the time stepping
+  // scheme has to increase it.
+  double const initial_time_step = 1e-7;
+  auto const time_steps = thermal_2d_cosine_decay<dealii::MemorySpace::Host>(
+      "bogacki_shampine", initial_time_step, 5e-3);
+  BOOST_TEST(time_steps.front() == initial_time_step);
+  BOOST_TEST(*std::max_element(time_steps.begin(), time_steps.end()) >
+             10. * initial_time_step);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_dopri_host)
+{
+  // The first time step is larger than the stability limit of the scheme, so
+  // the time stepping scheme has to decrease it.
+  double const initial_time_step = 1e-2;
+  auto const time_steps = thermal_2d_cosine_decay<dealii::MemorySpace::Host>(
+      "dopri", initial_time_step, 5e-3);
+  BOOST_TEST(time_steps.front() < initial_time_step);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_chebyshev_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>("backward_euler", 1e-3,
+                                                     3e-3, "chebyshev");
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_cosine_decay_multigrid_host)
+{
+  thermal_2d_cosine_decay<dealii::MemorySpace::Host>("backward_euler", 1e-3,
+                                                     3e-3, "multigrid", true);
+}
+
 BOOST_AUTO_TEST_CASE(initial_temperature_host)
 {
   initial_temperature<dealii::MemorySpace::Host>();
@@ -40,6 +164,11 @@ BOOST_AUTO_TEST_CASE(energy_conservation_host)
   energy_conservation<dealii::MemorySpace::Host>();
 }
 
+BOOST_AUTO_TEST_CASE(enthalpy_energy_conservation_host)
+{
+  enthalpy_energy_conservation<dealii::MemorySpace::Host>();
+}
+
 BOOST_AUTO_TEST_CASE(radiation_bcs_host)
 {
   radiation_bcs<dealii::MemorySpace::Host>();
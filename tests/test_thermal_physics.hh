@@ -8,9 +8,15 @@
 #include <ThermalPhysics.hh>
 #include <Timer.hh>
 
+#include <deal.II/base/function.h>
 #include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/numerics/vector_tools.h>
 
+#include <algorithm>
 #include <fstream>
+#include <string>
+#include <vector>
 
 namespace tt = boost::test_tools;
 
@@ -155,7 +161,10 @@ void thermal_2d(boost::property_tree::ptree &database, double time_step)
 }
 
 template <typename MemorySpaceType>
-void thermal_2d_manufactured_solution()
+void thermal_2d_manufactured_solution(
+    std::string const &time_stepping_method = "rk_fourth_order",
+    std::string const &preconditioner = "identity",
+    bool const locally_refined = false)
 {
   MPI_Comm communicator = MPI_COMM_WORLD;
 
@@ -170,6 +179,18 @@ void thermal_2d_manufactured_solution()
   // Build Geometry
   adamantine::Geometry<2> geometry(communicator, geometry_database,
                                    units_optional_database);
+  // Refine twice the cells of the first column to create hanging nodes and
+  // cells of different levels.
+  if (locally_refined)
+  {
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      for (auto cell : geometry.get_triangulation().active_cell_iterators())
+        if (cell->is_locally_owned() && cell->center()[0] < 250.)
+          cell->set_refine_flag();
+      geometry.get_triangulation().execute_coarsening_and_refinement();
+    }
+  }
   // Create the Boundary
   boost::property_tree::ptree boundary_database;
   boundary_database.put("type", "adiabatic");
@@ -216,7 +237,8 @@ void thermal_2d_manufactured_solution()
   database.put("sources.beam_0.scan_path_file_format", "segment");
 
   // Time-stepping database
-  database.put("time_stepping.method", "rk_fourth_order");
+  database.put("time_stepping.method", time_stepping_method);
+  database.put("time_stepping.preconditioner", preconditioner);
   // Build ThermalPhysics
   adamantine::ThermalPhysics<2, 1, 1, 2, adamantine::SolidLiquidPowder,
                              MemorySpaceType, dealii::QGauss<1>>
@@ -227,6 +249,7 @@ void thermal_2d_manufactured_solution()
 
   std::vector<adamantine::Timer> timers(adamantine::Timing::n_timers);
   double time = physics.evolve_one_time_step(0., 0.1, solution, timers);
+  physics.get_affine_constraints().distribute(solution);
 
   double const tolerance = 1e-5;
 
@@ -247,6 +270,136 @@ void thermal_2d_manufactured_solution()
   }
 }
 
+// Diffusion of a cosine with adiabatic boundary conditions. Unlike the
+// manufactured solution above, the temperature varies in space so the
+// result depends on the diffusion operator and on the accuracy of the time
+// stepping. The exact solution is T(x, t) = 1 + exp(-pi^2 t) cos(pi x). With
+// an adaptive scheme, time_step is only used for the first step and the next
+// steps use the time step suggested by the scheme. The function returns the
+// accepted time steps.
+template <typename MemorySpaceType>
+std::vector<double>
+thermal_2d_cosine_decay(std::string const &time_stepping_method,
+                        double const time_step, double const tolerance,
+                        std::string const &preconditioner = "identity",
+                        bool const locally_refined = false)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Geometry database
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 1.);
+  geometry_database.put("length_divisions", 16);
+  geometry_database.put("height", 0.25);
+  geometry_database.put("height_divisions", 1);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  // Build Geometry
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  // Refine twice the cells of the first quarter of the domain, where the
+  // gradient of the temperature changes the most.
+  if (locally_refined)
+  {
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      for (auto cell : geometry.get_triangulation().active_cell_iterators())
+        if (cell->is_locally_owned() && cell->center()[0] < 0.25)
+          cell->set_refine_flag();
+      geometry.get_triangulation().execute_coarsening_and_refinement();
+    }
+  }
+  // Create the Boundary
+  boost::property_tree::ptree boundary_database;
+  boundary_database.put("type", "adiabatic");
+  adamantine::Boundary boundary(
+      boundary_database, geometry.get_triangulation().get_boundary_ids());
+
+  // MaterialProperty database
+  boost::property_tree::ptree material_property_database;
+  material_property_database.put("property_format", "polynomial");
+  material_property_database.put("n_materials", 1);
+  material_property_database.put("material_0.solid.density", 1.);
+  material_property_database.put("material_0.powder.density", 1.);
+  material_property_database.put("material_0.liquid.density", 1.);
+  material_property_database.put("material_0.solid.specific_heat", 1.);
+  material_property_database.put("material_0.powder.specific_heat", 1.);
+  material_property_database.put("material_0.liquid.specific_heat", 1.);
+  material_property_database.put("material_0.solid.thermal_conductivity_x", 1.);
+  material_property_database.put("material_0.solid.thermal_conductivity_z", 1.);
+  material_property_database.put("material_0.powder.thermal_conductivity_x",
+                                 1.);
+  material_property_database.put("material_0.powder.thermal_conductivity_z",
+                                 1.);
+  material_property_database.put("material_0.liquid.thermal_conductivity_x",
+                                 1.);
+  material_property_database.put("material_0.liquid.thermal_conductivity_z",
+                                 1.);
+  // Build MaterialProperty
+  adamantine::MaterialProperty<2, 1, 1, adamantine::SolidLiquidPowder,
+                               MemorySpaceType>
+      material_properties(communicator, geometry.get_triangulation(),
+                          material_property_database);
+
+  boost::property_tree::ptree database;
+  // Source database
+  database.put("sources.n_beams", 0);
+  // Time-stepping database
+  database.put("time_stepping.method", time_stepping_method);
+  database.put("time_stepping.preconditioner", preconditioner);
+  // Build ThermalPhysics
+  adamantine::ThermalPhysics<2, 1, 1, 2, adamantine::SolidLiquidPowder,
+                             MemorySpaceType, dealii::QGauss<1>>
+      physics(communicator, database, geometry, boundary, material_properties);
+  physics.setup();
+
+  double const pi = dealii::numbers::PI;
+  auto exact_solution = [&](dealii::Point<2> const &p, double const t)
+  { return 1. + std::exp(-pi * pi * t) * std::cos(pi * p[0]); };
+
+  // Interpolate the initial condition on the host and move it to the memory
+  // space of the solution.
+  dealii::LA::distributed::Vector<double, MemorySpaceType> solution;
+  physics.initialize_dof_vector(0., solution);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      solution_host(solution.get_partitioner());
+  dealii::ScalarFunctionFromFunctionObject<2> initial_condition(
+      [&](dealii::Point<2> const &p) { return exact_solution(p, 0.); });
+  dealii::VectorTools::interpolate(physics.get_dof_handler(),
+                                   initial_condition, solution_host);
+  physics.get_affine_constraints().distribute(solution_host);
+  solution.import_elements(solution_host, dealii::VectorOperation::insert);
+
+  std::vector<adamantine::Timer> timers(adamantine::Timing::n_timers);
+  double const final_time = 0.05;
+  double time = 0.;
+  double next_time_step = time_step;
+  std::vector<double> accepted_time_steps;
+  while (time < final_time - 1e-12)
+  {
+    double const old_time = time;
+    time = physics.evolve_one_time_step(
+        time, std::min(next_time_step, final_time - time), solution, timers);
+    accepted_time_steps.push_back(time - old_time);
+    if (physics.has_adaptive_time_stepping())
+      next_time_step = physics.get_next_time_step();
+  }
+  BOOST_TEST(time == final_time, tt::tolerance(1e-12));
+
+  solution_host.import_elements(solution, dealii::VectorOperation::insert);
+  physics.get_affine_constraints().distribute(solution_host);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> error(
+      solution.get_partitioner());
+  dealii::ScalarFunctionFromFunctionObject<2> final_condition(
+      [&](dealii::Point<2> const &p) { return exact_solution(p, time); });
+  dealii::VectorTools::interpolate(physics.get_dof_handler(),
+                                   final_condition, error);
+  error -= solution_host;
+  BOOST_TEST(error.linfty_norm() < tolerance);
+
+  return accepted_time_steps;
+}
+
 template <typename MemorySpaceType>
 void initial_temperature()
 {
@@ -392,6 +545,141 @@ void energy_conservation()
   BOOST_TEST(min == max, tt::tolerance(tolerance));
 }
 
+// Melt a part of the domain with a cube heat source and let it solidify once
+// the source is turned off. With the enthalpy formulation, the total enthalpy
+// has to increase by the energy deposited by the source and then stay
+// constant.
+template <typename MemorySpaceType>
+void enthalpy_energy_conservation()
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Geometry database
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 1.);
+  geometry_database.put("length_divisions", 8);
+  geometry_database.put("height", 0.25);
+  geometry_database.put("height_divisions", 2);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  // Build Geometry
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  // Create the Boundary
+  boost::property_tree::ptree boundary_database;
+  boundary_database.put("type", "adiabatic");
+  adamantine::Boundary boundary(
+      boundary_database, geometry.get_triangulation().get_boundary_ids());
+  // MaterialProperty database. The solid has rho C_p = 6 and the liquid has
+  // rho C_p = 10.
+  boost::property_tree::ptree material_property_database;
+  material_property_database.put("property_format", "polynomial");
+  material_property_database.put("n_materials", 1);
+  material_property_database.put("material_0.solid.density", 2.);
+  material_property_database.put("material_0.liquid.density", 2.);
+  material_property_database.put("material_0.solid.specific_heat", 3.);
+  material_property_database.put("material_0.liquid.specific_heat", 5.);
+  material_property_database.put("material_0.solid.thermal_conductivity_x",
+                                 10.);
+  material_property_database.put("material_0.solid.thermal_conductivity_z",
+                                 10.);
+  material_property_database.put("material_0.liquid.thermal_conductivity_x",
+                                 10.);
+  material_property_database.put("material_0.liquid.thermal_conductivity_z",
+                                 10.);
+  material_property_database.put("material_0.solidus", 100.);
+  material_property_database.put("material_0.liquidus", 102.);
+  material_property_database.put("material_0.latent_heat", 10.);
+  // Build MaterialProperty
+  adamantine::MaterialProperty<2, 1, 0, adamantine::SolidLiquid,
+                               MemorySpaceType>
+      material_properties(communicator, geometry.get_triangulation(),
+                          material_property_database);
+  boost::property_tree::ptree database;
+  // Source database. The cube covers the first two columns of cells.
+  double constexpr source_value = 9e4;
+  double constexpr source_area = 0.25 * 0.25;
+  double constexpr source_start_time = -1.;
+  double constexpr source_end_time = 0.0101;
+  database.put("sources.n_beams", 1);
+  database.put("sources.beam_0.type", "cube");
+  database.put("sources.beam_0.start_time", source_start_time);
+  database.put("sources.beam_0.end_time", source_end_time);
+  database.put("sources.beam_0.value", source_value);
+  database.put("sources.beam_0.min_x", 0.);
+  database.put("sources.beam_0.min_y", 0.);
+  database.put("sources.beam_0.max_x", 0.25);
+  database.put("sources.beam_0.max_y", 0.25);
+  // Discretization database
+  database.put("materials.n_materials", 1);
+  database.put("discretization.thermal.formulation", "enthalpy");
+  // Time-stepping database
+  database.put("time_stepping.method", "forward_euler");
+  // Build ThermalPhysics
+  adamantine::ThermalPhysics<2, 1, 0, 2, adamantine::SolidLiquid,
+                             MemorySpaceType, dealii::QGauss<1>>
+      physics(communicator, database, geometry, boundary, material_properties);
+  physics.setup();
+  dealii::LA::distributed::Vector<double, MemorySpaceType> solution;
+  physics.initialize_dof_vector(50., solution);
+
+  // Compute the lumped mass matrix used by the ThermalOperator. Since the
+  // shape functions are zero at all the support points but one, the row sum
+  // of the Gauss-Lobatto mass matrix is its diagonal.
+  dealii::LA::distributed::Vector<double, MemorySpaceType> mass(
+      solution.get_partitioner());
+  dealii::FEValues<2> fe_values(physics.get_dof_handler().get_fe(0),
+                                dealii::QGaussLobatto<2>(3),
+                                dealii::update_values |
+                                    dealii::update_JxW_values);
+  unsigned int const dofs_per_cell = fe_values.dofs_per_cell;
+  std::vector<dealii::types::global_dof_index> dof_indices(dofs_per_cell);
+  for (auto const &cell : physics.get_dof_handler().active_cell_iterators())
+  {
+    if (cell->is_locally_owned())
+    {
+      fe_values.reinit(cell);
+      cell->get_dof_indices(dof_indices);
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int q = 0; q < fe_values.n_quadrature_points; ++q)
+          mass(dof_indices[i]) +=
+              fe_values.shape_value(i, q) * fe_values.JxW(q);
+    }
+  }
+  mass.compress(dealii::VectorOperation::add);
+  // The enthalpy of the solid at 50 K is 6 * 50.
+  double const initial_energy = 300. * mass.l1_norm();
+
+  std::vector<adamantine::Timer> timers(adamantine::Timing::n_timers);
+  double constexpr time_step = 2e-4;
+  double time = 0.;
+  unsigned int n_source_steps = 0;
+  double max_temperature_source_off = 0.;
+  while (time < 0.5)
+  {
+    // Forward Euler evaluates the source at the beginning of the time step.
+    bool const source_on =
+        (time > source_start_time) && (time < source_end_time);
+    if (source_on)
+      ++n_source_steps;
+    time = physics.evolve_one_time_step(time, time_step, solution, timers);
+    // The material has melted when the source is turned off.
+    if (source_on && !((time > source_start_time) && (time < source_end_time)))
+      max_temperature_source_off = solution.linfty_norm();
+  }
+
+  BOOST_TEST(n_source_steps > 0u);
+  BOOST_TEST(max_temperature_source_off > 102.);
+  // The liquid has solidified again.
+  BOOST_TEST(solution.linfty_norm() < 100.);
+  // The energy has only been changed by the heat source.
+  double const deposited_energy =
+      source_value * source_area * n_source_steps * time_step;
+  double const final_energy = mass * physics.get_enthalpy();
+  BOOST_TEST(final_energy == initial_energy + deposited_energy,
+             tt::tolerance(1e-9));
+}
+
 template <typename MemorySpaceType>
 void radiation_bcs()
 {
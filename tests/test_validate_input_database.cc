@@ -139,6 +139,23 @@ BOOST_AUTO_TEST_CASE(expected_failures)
   database.get_child("discretization").erase("thermal.quadrature");
   database.put("discretization.thermal.quadrature", "gauss");
 
+  // Invalid precision
+  database.put("discretization.thermal.precision", "half");
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.put("discretization.thermal.precision", "single");
+  validate_input_database(database);
+  database.get_child("discretization.thermal").erase("precision");
+
+  // Invalid formulation
+  database.put("discretization.thermal.formulation", "entropy");
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.put("discretization.thermal.formulation", "enthalpy");
+  database.put("discretization.thermal.enthalpy_max_temperature", -1.);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("discretization.thermal")
+      .erase("enthalpy_max_temperature");
+  database.get_child("discretization.thermal").erase("formulation");
+
   // Invalid number of dimensions
   database.get_child("geometry").erase("dim");
   database.put("geometry.dim", 1);
@@ -358,6 +375,11 @@ BOOST_AUTO_TEST_CASE(expected_failures)
   BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
   database.erase("memory_space");
 
+  // Negative number of threads
+  database.put("n_threads", -2);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.erase("n_threads");
+
   // Missing thermal physics
   database.get_child("physics").erase("thermal");
   BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
@@ -403,6 +425,24 @@ BOOST_AUTO_TEST_CASE(expected_failures)
   BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
   database.put("refinement.n_heat_refinements", 0);
 
+  // Invalid error estimator fractions
+  database.put("refinement.error_estimator_refine_fraction", -0.1);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.put("refinement.error_estimator_refine_fraction", 0.6);
+  database.put("refinement.error_estimator_coarsen_fraction", 0.5);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("refinement").erase("error_estimator_refine_fraction");
+  database.get_child("refinement").erase("error_estimator_coarsen_fraction");
+
+  // Invalid load balancing parameters
+  database.put("refinement.load_imbalance_threshold", 0.9);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.put("refinement.load_imbalance_threshold", 1.2);
+  database.put("refinement.time_steps_between_load_balancing", 0);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("refinement").erase("load_imbalance_threshold");
+  database.get_child("refinement").erase("time_steps_between_load_balancing");
+
   // Missing 'n_beams'
   database.get_child("sources").erase("n_beams");
   BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
@@ -459,6 +499,41 @@ BOOST_AUTO_TEST_CASE(expected_failures)
   BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
   database.put("time_stepping.method", "forward_euler");
 
+  // Invalid Newton tolerance for an implicit time stepping method
+  database.put("time_stepping.method", "backward_euler");
+  database.put("time_stepping.newton_tolerance", -1.);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("time_stepping").erase("newton_tolerance");
+  database.put("time_stepping.method", "forward_euler");
+
+  // Invalid coarsening tolerance for an adaptive time stepping method
+  database.put("time_stepping.method", "dopri");
+  database.put("time_stepping.error_tolerance", 1e-4);
+  database.put("time_stepping.coarsening_tolerance", 1e-3);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("time_stepping").erase("error_tolerance");
+  database.get_child("time_stepping").erase("coarsening_tolerance");
+  database.put("time_stepping.method", "forward_euler");
+
+  // Invalid preconditioner for an implicit time stepping method
+  database.put("time_stepping.method", "backward_euler");
+  database.put("time_stepping.preconditioner", "jacobi");
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("time_stepping").erase("preconditioner");
+  database.put("time_stepping.method", "forward_euler");
+
+  // Negative coefficient cache tolerance
+  database.put("time_stepping.coefficient_cache_tolerance", -1.);
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.get_child("time_stepping").erase("coefficient_cache_tolerance");
+
+  // Coefficient cache on the device
+  database.put("time_stepping.coefficient_cache_tolerance", 1.);
+  database.put("memory_space", "device");
+  BOOST_CHECK_THROW(validate_input_database(database), std::runtime_error);
+  database.erase("memory_space");
+  database.get_child("time_stepping").erase("coefficient_cache_tolerance");
+
   // Missing experimental inputs
   database.put("experiment.read_in_experimental_data", true);
   database.put("experiment.file", "file.csv");